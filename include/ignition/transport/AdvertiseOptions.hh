@@ -51,6 +51,38 @@ namespace ignition
       ALL
     };
 
+    /// \def FlowControl_t This strongly typed enum defines what a publisher
+    /// does with a new message when the messages that it already handed to
+    /// ZeroMQ exceed its send buffer limit.
+    /// \sa AdvertiseMessageOptions::SetSendBufferLimit
+    enum class FlowControl_t
+    {
+      /// \brief Discard the new message for the remote subscribers (default).
+      /// Suitable for topics where only recent messages matter, e.g. sensor
+      /// data.
+      DROP,
+      /// \brief Block the publication until the remote subscribers have
+      /// received enough messages to make room for the new one, or until
+      /// the flow control timeout expires. Suitable for topics where every
+      /// message must be delivered.
+      /// \sa AdvertiseMessageOptions::SetFlowControlTimeout
+      BLOCK
+    };
+
+    /// \def Priority_t This strongly typed enum defines the priority classes
+    /// of a topic. Topics of different classes are sent through different
+    /// ZeroMQ sockets and connections, so the messages of a high priority
+    /// topic do not wait behind large messages of normal topics.
+    enum class Priority_t
+    {
+      /// \brief Topic sent through the normal lane (default).
+      NORMAL,
+      /// \brief Topic sent through the high priority lane, e.g. for safety
+      /// and control messages. Subscribers process the messages of this lane
+      /// before the ones of the normal lane.
+      HIGH
+    };
+
     /// \class AdvertiseOptions AdvertiseOptions.hh
     /// ignition/transport/AdvertiseOptions.hh
     /// \brief A class for customizing the publication options for a topic or
@@ -193,6 +225,26 @@ namespace ignition
         else
           _out << "\tThrottled? No" << std::endl;
 
+        if (_other.Priority() == Priority_t::HIGH)
+          _out << "\tPriority: High" << std::endl;
+
+        if (_other.Multicast())
+          _out << "\tMulticast? Yes" << std::endl;
+
+        if (_other.SendBufferLimit() > 0)
+        {
+          _out << "\tSend buffer limit: " << _other.SendBufferLimit()
+               << " bytes" << std::endl;
+          _out << "\tFlow control: "
+               << (_other.FlowControl() == FlowControl_t::BLOCK ?
+                   "Block" : "Drop") << std::endl;
+          if (_other.FlowControl() == FlowControl_t::BLOCK)
+          {
+            _out << "\tFlow control timeout: " << _other.FlowControlTimeout()
+                 << " ms" << std::endl;
+          }
+        }
+
         return _out;
       }
 
@@ -213,6 +265,76 @@ namespace ignition
       /// \param[in] _newMsgsPerSec Maximum number of messages per second.
       public: void SetMsgsPerSec(const uint64_t _newMsgsPerSec);
 
+      /// \brief Get the maximum number of bytes that the publisher can have
+      /// pending to be sent to the remote subscribers.
+      /// \return The limit (bytes), or zero if there is no limit.
+      /// \sa SetSendBufferLimit
+      public: uint64_t SendBufferLimit() const;
+
+      /// \brief Set the maximum number of bytes that the publisher can have
+      /// pending to be sent to the remote subscribers. A message is pending
+      /// until every remote subscriber has received it, so a slow or stalled
+      /// subscriber makes the pending messages accumulate. When a new
+      /// message does not fit, the flow control policy decides what to do.
+      /// A message larger than the limit is only sent when no other message
+      /// is pending. The limit does not apply to local subscribers.
+      /// \param[in] _bytes The limit (bytes), or zero for no limit
+      /// (default).
+      /// \sa SetFlowControl
+      public: void SetSendBufferLimit(const uint64_t _bytes);
+
+      /// \brief Get the flow control policy.
+      /// \return The policy.
+      /// \sa SetFlowControl
+      public: FlowControl_t FlowControl() const;
+
+      /// \brief Set what to do with a message that does not fit in the send
+      /// buffer limit. It has no effect if there is no limit.
+      /// \param[in] _policy The policy. The default is FlowControl_t::DROP.
+      /// \sa SetSendBufferLimit
+      public: void SetFlowControl(const FlowControl_t _policy);
+
+      /// \brief Get the maximum time that a publication waits for room with
+      /// the FlowControl_t::BLOCK policy.
+      /// \return The timeout (milliseconds).
+      /// \sa SetFlowControlTimeout
+      public: unsigned int FlowControlTimeout() const;
+
+      /// \brief Set the maximum time that a publication waits for room with
+      /// the FlowControl_t::BLOCK policy. When it expires, the message is not
+      /// sent to the remote subscribers, it is counted as dropped and the
+      /// publication fails. It has no effect with the FlowControl_t::DROP
+      /// policy.
+      /// \param[in] _timeout The timeout (milliseconds). The default is 1000.
+      /// \sa SetFlowControl
+      public: void SetFlowControlTimeout(const unsigned int _timeout);
+
+      /// \brief Get the priority class of the topic.
+      /// \return The priority class.
+      /// \sa SetPriority
+      public: Priority_t Priority() const;
+
+      /// \brief Set the priority class of the topic. It is sent to the
+      /// subscribers with the advertisement of the topic.
+      /// \param[in] _priority The priority class. The default is
+      /// Priority_t::NORMAL.
+      public: void SetPriority(const Priority_t _priority);
+
+      /// \brief Whether the topic is sent to the remote subscribers through
+      /// UDP multicast.
+      /// \return True if the topic uses multicast.
+      /// \sa SetMulticast
+      public: bool Multicast() const;
+
+      /// \brief Send the topic to the remote subscribers through UDP
+      /// multicast (ZeroMQ epgm transport), so every message is sent once
+      /// regardless of the number of subscribers. The delivery is best
+      /// effort: a subscriber that falls behind loses messages. Subscribers on
+      /// the same host, subscribers that do not support multicast and
+      /// publishers that use authentication keep using TCP.
+      /// \param[in] _multicast True to use multicast. The default is false.
+      public: void SetMulticast(const bool _multicast);
+
       /// \brief Serialize the options. The caller has ownership of the
       /// buffer and is responsible for its [de]allocation.
       /// \param[out] _buffer Destination buffer in which the options
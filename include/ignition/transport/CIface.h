@@ -18,6 +18,8 @@
 #ifndef INCLUDE_IGNITION_TRANSPORT_CIFACE_H_
 #define INCLUDE_IGNITION_TRANSPORT_CIFACE_H_
 
+#include <stddef.h>
+
 #include "ignition/transport/Export.hh"
 
 #ifdef __cplusplus
@@ -32,6 +34,10 @@ extern "C" {
   /// \brief A transport node.
   typedef struct IgnTransportNode IgnTransportNode;
 
+  /// \brief A publisher of a topic. It is owned by the node that advertised
+  /// it, and it remains valid until that node is destroyed.
+  typedef struct IgnTransportPublisher IgnTransportPublisher;
+
   /// \brief Create a transport node.
   /// \param[in] _partition Optional name of the partition to use.
   /// Use nullptr to use the default value, which is specified via the
@@ -58,6 +64,8 @@ extern "C" {
 
 
   /// \brief Publishes a message on a topic.
+  /// \warning _data is read up to its first null byte, which truncates most
+  /// serialized messages. Use ignTransportPublishN instead.
   /// \param[in] _node Pointer to a node.
   /// \param[in] _topic Topic on which to publish the message.
   /// \param[in] _data Byte array of serialized data to publish.
@@ -69,6 +77,76 @@ extern "C" {
                       const void *_data,
                       const char *_msgType);
 
+  /// \brief Publishes a message on a topic.
+  /// \param[in] _node Pointer to a node.
+  /// \param[in] _topic Topic on which to publish the message. The topic is
+  /// advertised if needed.
+  /// \param[in] _data Byte array of serialized data to publish.
+  /// \param[in] _size Number of bytes in _data.
+  /// \param[in] _msgType Name of the message type.
+  /// \return 0 on success.
+  int IGNITION_TRANSPORT_VISIBLE
+  ignTransportPublishN(IgnTransportNode *_node,
+                       const char *_topic,
+                       const void *_data,
+                       size_t _size,
+                       const char *_msgType);
+
+  /// \brief Advertise a topic and get a handle to publish on it, which
+  /// avoids looking up the topic on every publication.
+  /// \param[in] _node Pointer to a node.
+  /// \param[in] _topic Topic on which to publish the messages.
+  /// \param[in] _msgType Name of the message type.
+  /// \return The publisher, or NULL on error. Calling this function again
+  /// with the same topic returns the same publisher.
+  IgnTransportPublisher IGNITION_TRANSPORT_VISIBLE *
+  ignTransportAdvertisePublisher(IgnTransportNode *_node,
+                                 const char *_topic,
+                                 const char *_msgType);
+
+  /// \brief Publishes a message with a publisher.
+  /// \param[in] _pub Publisher returned by ignTransportAdvertisePublisher.
+  /// \param[in] _data Byte array of serialized data to publish. It is copied
+  /// if there are subscribers in other processes.
+  /// \param[in] _size Number of bytes in _data.
+  /// \return 0 on success.
+  int IGNITION_TRANSPORT_VISIBLE
+  ignTransportPublisherPublish(IgnTransportPublisher *_pub,
+                               const void *_data,
+                               size_t _size);
+
+  /// \brief Borrow a buffer from a publisher, to serialize a message into it
+  /// and publish it without copies. The buffer must be handed back to the
+  /// publisher with either ignTransportPublisherPublishLoan or
+  /// ignTransportPublisherReturnLoan. Buffers are recycled once the
+  /// messages written in them have been sent.
+  /// \param[in] _pub Publisher returned by ignTransportAdvertisePublisher.
+  /// \param[in] _size Number of bytes needed.
+  /// \return A buffer of at least _size bytes, or NULL on error.
+  void IGNITION_TRANSPORT_VISIBLE *
+  ignTransportPublisherLoan(IgnTransportPublisher *_pub, size_t _size);
+
+  /// \brief Publish a buffer borrowed with ignTransportPublisherLoan, without
+  /// copying it. The buffer goes back to the publisher, even on failure, and
+  /// must not be used afterwards.
+  /// \param[in] _pub Publisher that lent the buffer.
+  /// \param[in] _buffer The borrowed buffer.
+  /// \param[in] _size Number of bytes of the buffer to publish.
+  /// \return 0 on success.
+  int IGNITION_TRANSPORT_VISIBLE
+  ignTransportPublisherPublishLoan(IgnTransportPublisher *_pub,
+                                   void *_buffer,
+                                   size_t _size);
+
+  /// \brief Give back a buffer borrowed with ignTransportPublisherLoan
+  /// without publishing it.
+  /// \param[in] _pub Publisher that lent the buffer.
+  /// \param[in] _buffer The borrowed buffer.
+  /// \return 0 on success, or 1 if _buffer was not lent by _pub.
+  int IGNITION_TRANSPORT_VISIBLE
+  ignTransportPublisherReturnLoan(IgnTransportPublisher *_pub,
+                                  void *_buffer);
+
   /// \brief Subscribe to a topic, and register a callback.
   /// \param[in] _node Pointer to a node.
   /// \param[in] _topic Name of the topic.
@@ -721,6 +721,8 @@ namespace ignition
       /// \brief Receive discovery messages.
       private: void RecvMessages()
       {
+        configureThread("discovery");
+
         bool timeToExit = false;
         while (!timeToExit)
         {
@@ -18,12 +18,16 @@
 #ifndef IGN_TRANSPORT_HANDLERSTORAGE_HH_
 #define IGN_TRANSPORT_HANDLERSTORAGE_HH_
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "ignition/transport/config.hh"
+#include "ignition/transport/NameTable.hh"
 #include "ignition/transport/TransportTypes.hh"
 
 namespace ignition
@@ -36,18 +40,32 @@ namespace ignition
     /// \class HandlerStorage HandlerStorage.hh
     /// ignition/transport/HandlerStorage.hh
     /// \brief Class to store and manage service call handlers.
+    ///
+    /// The handlers of a topic are stored in a flat vector, in the order they
+    /// were added. The vector is never modified once stored: adding or
+    /// removing a handler replaces it with a modified copy. The publishers
+    /// and the receivers take a snapshot of the vector with TopicHandlers(),
+    /// which does not allocate, and iterate it without holding any lock.
     template<typename T> class HandlerStorage
     {
-      /// \brief Stores all the service call data for each topic. The key of
-      /// _data is the topic name. The value is another map, where the key is
-      /// the node UUID and the value is a smart pointer to the handler.
-      /// \TODO(Carlos) review this names and fix them
-      using UUIDHandler_M = std::map<std::string, std::shared_ptr<T>>;
-      using UUIDHandler_Collection_M = std::map<std::string, UUIDHandler_M>;
+      /// \brief A handler of a topic.
+      public: struct Entry
+      {
+        /// \brief UUID of the node that added the handler.
+        std::string nUuid;
+
+        /// \brief UUID of the handler.
+        std::string hUuid;
+
+        /// \brief The handler.
+        std::shared_ptr<T> handler;
+      };
+
+      /// \brief Handlers of a topic.
+      public: using Entries = std::vector<Entry>;
 
-      /// \brief key is a topic name and value is UUIDHandler_M
-      using TopicServiceCalls_M =
-        std::map<std::string, UUIDHandler_Collection_M>;
+      /// \brief Snapshot of the handlers of a topic, which is never modified.
+      public: using EntriesPtr = std::shared_ptr<const Entries>;
 
       /// \brief Constructor.
       public: HandlerStorage() = default;
@@ -55,9 +73,37 @@ namespace ignition
       /// \brief Destructor.
       public: virtual ~HandlerStorage() = default;
 
+      /// \brief Get an empty snapshot, shared by all the storages.
+      /// \return The snapshot.
+      public: static const EntriesPtr &EmptyEntries()
+      {
+        static const EntriesPtr empty = std::make_shared<const Entries>();
+        return empty;
+      }
+
+      /// \brief Get a snapshot of the handlers of a topic. The snapshot is
+      /// not affected by the handlers added or removed later.
+      /// \param[in] _topic Topic name.
+      /// \param[out] _handlers The handlers, in the order they were added.
+      /// \return true if the topic contains at least one handler.
+      public: bool TopicHandlers(const std::string &_topic,
+                                 EntriesPtr &_handlers) const
+      {
+        auto it = this->data.find(_topic);
+        if (it == this->data.end())
+        {
+          _handlers = EmptyEntries();
+          return false;
+        }
+
+        _handlers = it->second;
+        return true;
+      }
+
       /// \brief Get the data handlers for a topic. A request
       /// handler stores the callback and types associated to a service call
-      /// request.
+      /// request. TopicHandlers() is cheaper, because it does not copy the
+      /// handlers.
       /// \param[in] _topic Topic name.
       /// \param[out] _handlers Request handlers. The key of _handlers is the
       /// topic name. The value is another map, where the key is the node
@@ -67,13 +113,33 @@ namespace ignition
         std::map<std::string,
           std::map<std::string, std::shared_ptr<T> >> &_handlers) const
       {
-        if (this->data.find(_topic) == this->data.end())
+        auto it = this->data.find(_topic);
+        if (it == this->data.end())
           return false;
 
-        _handlers = this->data.at(_topic);
+        _handlers.clear();
+        for (const Entry &entry : *it->second)
+          _handlers[entry.nUuid].emplace(entry.hUuid, entry.handler);
         return true;
       }
 
+      /// \brief Get the handlers of all the topics.
+      /// \param[out] _handlers All the handlers. The key of _handlers is the
+      /// topic name. The value is another map, where the key is the node
+      /// UUID and the value is a map of handlers indexed by handler UUID.
+      public: void AllHandlers(std::map<std::string,
+        std::map<std::string,
+          std::map<std::string, std::shared_ptr<T>>>> &_handlers) const
+      {
+        _handlers.clear();
+        for (const auto &topic : this->data)
+        {
+          auto &nodes = _handlers[topic.first];
+          for (const Entry &entry : *topic.second)
+            nodes[entry.nUuid].emplace(entry.hUuid, entry.handler);
+        }
+      }
+
       /// \brief Get the first handler for a topic that matches a specific pair
       /// of request/response types.
       /// \param[in] _topic Topic name.
@@ -86,20 +152,17 @@ namespace ignition
                                 const std::string &_repTypeName,
                                 std::shared_ptr<T> &_handler) const
       {
-        if (this->data.find(_topic) == this->data.end())
+        auto it = this->data.find(_topic);
+        if (it == this->data.end())
           return false;
 
-        const auto &m = this->data.at(_topic);
-        for (const auto &node : m)
+        for (const Entry &entry : *it->second)
         {
-          for (const auto &handler : node.second)
+          if (_reqTypeName == entry.handler->ReqTypeName() &&
+              _repTypeName == entry.handler->RepTypeName())
           {
-            if (_reqTypeName == handler.second->ReqTypeName() &&
-                _repTypeName == handler.second->RepTypeName())
-            {
-              _handler = handler.second;
-              return true;
-            }
+            _handler = entry.handler;
+            return true;
           }
         }
         return false;
@@ -115,20 +178,17 @@ namespace ignition
                                 const std::string &_msgTypeName,
                                 std::shared_ptr<T> &_handler) const
       {
-        if (this->data.find(_topic) == this->data.end())
+        auto it = this->data.find(_topic);
+        if (it == this->data.end())
           return false;
 
-        const auto &m = this->data.at(_topic);
-        for (const auto &node : m)
+        const NameId typeId = NameTable::Find(_msgTypeName);
+        for (const Entry &entry : *it->second)
         {
-          for (const auto &handler : node.second)
+          if (entry.handler->AcceptsType(typeId, _msgTypeName))
           {
-            if (_msgTypeName == handler.second->TypeName() ||
-                handler.second->TypeName() == kGenericMessageType)
-            {
-              _handler = handler.second;
-              return true;
-            }
+            _handler = entry.handler;
+            return true;
           }
         }
         return false;
@@ -145,18 +205,19 @@ namespace ignition
                            const std::string &_hUuid,
                            std::shared_ptr<T> &_handler) const
       {
-        if (this->data.find(_topic) == this->data.end())
-          return false;
-
-        auto const &m = this->data.at(_topic);
-        if (m.find(_nUuid) == m.end())
-          return false;
-
-        if (m.at(_nUuid).find(_hUuid) == m.at(_nUuid).end())
+        auto it = this->data.find(_topic);
+        if (it == this->data.end())
           return false;
 
-        _handler = m.at(_nUuid).at(_hUuid);
-        return true;
+        for (const Entry &entry : *it->second)
+        {
+          if (entry.hUuid == _hUuid && entry.nUuid == _nUuid)
+          {
+            _handler = entry.handler;
+            return true;
+          }
+        }
+        return false;
       }
 
       /// \brief Add a request handler to a topic. A request handler stores
@@ -168,17 +229,28 @@ namespace ignition
                               const std::string &_nUuid,
                               const std::shared_ptr<T> &_handler)
       {
-        // Create the topic entry.
-        if (this->data.find(_topic) == this->data.end())
-          this->data[_topic] = UUIDHandler_Collection_M();
+        Entry newEntry{_nUuid, _handler->HandlerUuid(), _handler};
+
+        auto it = this->data.find(_topic);
+        if (it == this->data.end())
+        {
+          this->data.emplace(_topic,
+            std::make_shared<const Entries>(1, std::move(newEntry)));
+          return;
+        }
 
-        // Create the Node UUID entry.
-        if (this->data[_topic].find(_nUuid) == this->data[_topic].end())
-          this->data[_topic][_nUuid] = UUIDHandler_M();
+        // A handler is only added once.
+        for (const Entry &entry : *it->second)
+        {
+          if (entry.hUuid == newEntry.hUuid && entry.nUuid == _nUuid)
+            return;
+        }
 
-        // Add/Replace the Req handler.
-        this->data[_topic][_nUuid].insert(
-          std::make_pair(_handler->HandlerUuid(), _handler));
+        auto entries = std::make_shared<Entries>();
+        entries->reserve(it->second->size() + 1);
+        *entries = *it->second;
+        entries->push_back(std::move(newEntry));
+        it->second = std::move(entries);
       }
 
       /// \brief Return true if we have stored at least one request for the
@@ -187,10 +259,7 @@ namespace ignition
       /// \return true if we have stored at least one request for the topic.
       public: bool HasHandlersForTopic(const std::string &_topic) const
       {
-        if (this->data.find(_topic) == this->data.end())
-          return false;
-
-        return !this->data.at(_topic).empty();
+        return this->data.find(_topic) != this->data.end();
       }
 
       /// \brief Check if a node has at least one handler.
@@ -200,11 +269,12 @@ namespace ignition
       public: bool HasHandlersForNode(const std::string &_topic,
                                       const std::string &_nUuid) const
       {
-        if (this->data.find(_topic) == this->data.end())
+        auto it = this->data.find(_topic);
+        if (it == this->data.end())
           return false;
 
-        return this->data.at(_topic).find(_nUuid) !=
-               this->data.at(_topic).end();
+        return std::any_of(it->second->begin(), it->second->end(),
+          [&_nUuid](const Entry &_entry) {return _entry.nUuid == _nUuid;});
       }
 
       /// \brief Remove a request handler. The node's uuid is used as a key to
@@ -217,20 +287,10 @@ namespace ignition
                                  const std::string &_nUuid,
                                  const std::string &_reqUuid)
       {
-        size_t counter = 0;
-        if (this->data.find(_topic) != this->data.end())
-        {
-          if (this->data[_topic].find(_nUuid) != this->data[_topic].end())
+        return this->RemoveIf(_topic, [&](const Entry &_entry)
           {
-            counter = this->data[_topic][_nUuid].erase(_reqUuid);
-            if (this->data[_topic][_nUuid].empty())
-              this->data[_topic].erase(_nUuid);
-            if (this->data[_topic].empty())
-              this->data.erase(_topic);
-          }
-        }
-
-        return counter > 0;
+            return _entry.hUuid == _reqUuid && _entry.nUuid == _nUuid;
+          });
       }
 
       /// \brief Remove all the handlers from a given node.
@@ -240,21 +300,44 @@ namespace ignition
       public: bool RemoveHandlersForNode(const std::string &_topic,
                                          const std::string &_nUuid)
       {
-        size_t counter = 0;
-        if (this->data.find(_topic) != this->data.end())
+        return this->RemoveIf(_topic, [&_nUuid](const Entry &_entry)
+          {
+            return _entry.nUuid == _nUuid;
+          });
+      }
+
+      /// \brief Remove the handlers of a topic that satisfy a predicate.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _pred The predicate.
+      /// \return True when at least one handler was removed.
+      private: template<typename Pred>
+      bool RemoveIf(const std::string &_topic, Pred _pred)
+      {
+        auto it = this->data.find(_topic);
+        if (it == this->data.end() ||
+            std::none_of(it->second->begin(), it->second->end(), _pred))
+        {
+          return false;
+        }
+
+        auto entries = std::make_shared<Entries>();
+        entries->reserve(it->second->size());
+        for (const Entry &entry : *it->second)
         {
-          counter = this->data[_topic].erase(_nUuid);
-          if (this->data[_topic].empty())
-            this->data.erase(_topic);
+          if (!_pred(entry))
+            entries->push_back(entry);
         }
 
-        return counter > 0;
+        if (entries->empty())
+          this->data.erase(it);
+        else
+          it->second = std::move(entries);
+        return true;
       }
 
-      /// \brief Stores all the service call data for each topic. The key of
-      /// _data is the topic name. The value is another map, where the key is
-      /// the node UUID and the value is a smart pointer to the handler.
-      private: TopicServiceCalls_M data;
+      /// \brief Stores the handlers of each topic. The key of data is the
+      /// topic name. A topic is removed when its last handler is removed.
+      private: std::unordered_map<std::string, EntriesPtr> data;
     };
     }
   }
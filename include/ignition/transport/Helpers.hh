@@ -53,6 +53,14 @@ namespace ignition
         const std::string &_orig,
         char _delim);
 
+    /// \brief Configure the calling thread, which is one of the internal
+    /// threads of the library. The thread is named ign-<role>, to identify it
+    /// in profilers and debuggers. Its CPU affinity and scheduling policy are
+    /// read from the IGN_TRANSPORT_<ROLE>_CPUS and IGN_TRANSPORT_<ROLE>_SCHED
+    /// environment variables, if set.
+    /// \param[in] _role Role of the thread, e.g. "reception".
+    void IGNITION_TRANSPORT_VISIBLE configureThread(const std::string &_role);
+
     // Use safer functions on Windows
     #ifdef _MSC_VER
       #define ign_strcat strcat_s
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGN_TRANSPORT_MESSAGEFILTER_HH_
+#define IGN_TRANSPORT_MESSAGEFILTER_HH_
+
+#include <memory>
+#include <string>
+
+#include "ignition/transport/config.hh"
+#include "ignition/transport/Export.hh"
+#include "ignition/transport/TransportTypes.hh"
+
+namespace ignition
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_TRANSPORT_VERSION_NAMESPACE {
+    //
+    class MessageFilterPrivate;
+
+    /// \class MessageFilter MessageFilter.hh
+    /// ignition/transport/MessageFilter.hh
+    /// \brief A condition on the content of a message, evaluated with
+    /// protobuf reflection.
+    ///
+    /// The expression is a list of comparisons joined with && and ||, where
+    /// && has precedence over ||. Parentheses are not supported. Each
+    /// comparison has a field path on the left, one of the operators ==, !=,
+    /// <, <=, > or >= and a literal on the right. E.g.:
+    ///
+    ///     name == "robot_1" && position.z >= 0.5 || id == 3
+    ///
+    /// The field path is a list of field names separated by dots. A repeated
+    /// field matches if any of its elements matches. The elements of a
+    /// repeated message with a "key" field can be selected by key, e.g. the
+    /// frame id of an ignition::msgs::Header is
+    /// header.data[frame_id].value.
+    ///
+    /// The literal can be a number, a quoted string, true, false or the name
+    /// of an enum value. A comparison that refers to a field that does not
+    /// exist does not match.
+    ///
+    /// The expression is parsed once, when the filter is created. Copies of
+    /// a filter share the parsed expression.
+    class IGNITION_TRANSPORT_VISIBLE MessageFilter
+    {
+      /// \brief Constructor. Creates an empty filter, which matches every
+      /// message.
+      public: MessageFilter();
+
+      /// \brief Constructor.
+      /// \param[in] _expression The filter expression. An empty expression
+      /// matches every message.
+      public: explicit MessageFilter(const std::string &_expression);
+
+      /// \brief Copy constructor.
+      /// \param[in] _other Filter to copy.
+      public: MessageFilter(const MessageFilter &_other);
+
+      /// \brief Assignment operator.
+      /// \param[in] _other Filter to copy.
+      /// \return Reference to this filter.
+      public: MessageFilter &operator=(const MessageFilter &_other);
+
+      /// \brief Destructor.
+      public: ~MessageFilter();
+
+      /// \brief Get the expression of the filter.
+      /// \return The expression.
+      public: const std::string &Expression() const;
+
+      /// \brief Whether the filter is empty, in which case it matches every
+      /// message.
+      /// \return True if the filter has no expression.
+      public: bool Empty() const;
+
+      /// \brief Whether the expression could be parsed.
+      /// \return True if the expression is valid or empty.
+      public: bool Valid() const;
+
+      /// \brief Evaluate the filter.
+      /// \param[in] _msg The message.
+      /// \return True if the filter is empty or the message satisfies the
+      /// expression. False if the expression is not valid.
+      public: bool Matches(const ProtoMsg &_msg) const;
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::shared_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+      /// \internal
+      /// \brief Pointer to private data. It is never modified after the
+      /// expression is parsed, so it is shared by the copies.
+      private: std::shared_ptr<const MessageFilterPrivate> dataPtr;
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+    };
+    }
+  }
+}
+#endif
@@ -18,11 +18,14 @@
 #ifndef IGN_TRANSPORT_MESSAGEINFO_HH_
 #define IGN_TRANSPORT_MESSAGEINFO_HH_
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 
 #include "ignition/transport/config.hh"
 #include "ignition/transport/Export.hh"
+#include "ignition/transport/NameTable.hh"
 
 namespace ignition
 {
@@ -66,6 +69,11 @@ namespace ignition
       /// \param[in] _type the type name to set.
       public: void SetType(const std::string &_type);
 
+      /// \brief Get the identifier of the message type in the NameTable.
+      /// \return The identifier, or kNoNameId if the type could not be
+      /// interned, in which case the type has to be compared by name.
+      public: NameId TypeId() const;
+
       /// \brief Get the name of the partition.
       /// \return The partition name.
       public: const std::string &Partition() const;
@@ -81,6 +89,12 @@ namespace ignition
       /// \sa TopicUtils::FullyQualifiedName
       public: bool SetTopicAndPartition(const std::string &_fullyQualifiedName);
 
+      /// \brief Set the topic, the partition and the type of another message.
+      /// They are shared instead of copied, so this is cheaper than setting
+      /// them by name for every message of a topic.
+      /// \param[in] _other The message to take them from.
+      public: void SetTopicAndType(const MessageInfo &_other);
+
       /// \brief Whether the message is coming from a node within this process.
       /// \return True when intra-process, false otherwise.
       public: bool IntraProcess() const;
@@ -89,6 +103,75 @@ namespace ignition
       /// \param[in] _value The intra-process value.
       public: void SetIntraProcess(bool _value);
 
+      /// \brief Get the time at which the message was published, read from
+      /// the steady clock of the publisher. The clock is monotonic and
+      /// shared by all the processes of a host, so the latency of a message
+      /// can be computed as steady_clock::now() - PublicationTime() when the
+      /// publisher runs on the same host.
+      /// \return The publication time, or the clock epoch if the publisher
+      /// did not send it.
+      public: std::chrono::steady_clock::time_point PublicationTime() const;
+
+      /// \brief Set the time at which the message was published.
+      /// \param[in] _time The publication time.
+      public: void SetPublicationTime(
+                  const std::chrono::steady_clock::time_point &_time);
+
+      /// \brief Get the sequence number of the message. Every publisher
+      /// numbers its messages consecutively starting at 1, so a gap between
+      /// two messages of the same publisher means that messages were lost.
+      /// Messages discarded by the publication throttling are not numbered.
+      /// \return The sequence number, or 0 if the publisher did not send it.
+      public: uint64_t SequenceNumber() const;
+
+      /// \brief Set the sequence number of the message.
+      /// \param[in] _seq The sequence number.
+      public: void SetSequenceNumber(const uint64_t _seq);
+
+      /// \brief Get the unique identifier of the publisher that sent the
+      /// message. Sequence numbers should be compared per publisher.
+      /// \return The publisher UUID, or an empty string if the publisher did
+      /// not send it.
+      public: const std::string &PublisherUuid() const;
+
+      /// \brief Set the unique identifier of the publisher.
+      /// \param[in] _uuid The publisher UUID.
+      public: void SetPublisherUuid(const std::string &_uuid);
+
+      /// \brief Get the minimum period between two messages sent by the
+      /// publisher to this process. It is not zero when every remote
+      /// subscriber of the topic is throttled (see
+      /// SubscribeOptions::SetMsgsPerSec), because the publisher then only
+      /// sends the messages that they will use. The sequence numbers skipped
+      /// by the publisher are not lost messages in that case.
+      /// \return The period, or zero if the publisher sends every message.
+      public: std::chrono::nanoseconds DownsamplingPeriod() const;
+
+      /// \brief Set the minimum period between two messages sent by the
+      /// publisher.
+      /// \param[in] _period The period.
+      public: void SetDownsamplingPeriod(
+                  const std::chrono::nanoseconds &_period);
+
+      /// \brief Get the time at which this process received the message,
+      /// read from the steady clock. Intra-process messages are received when
+      /// they are delivered to the subscribers.
+      /// \return The reception time, or the clock epoch if it is unknown.
+      public: std::chrono::steady_clock::time_point ReceptionTime() const;
+
+      /// \brief Set the time at which this process received the message.
+      /// \param[in] _time The reception time.
+      public: void SetReceptionTime(
+                  const std::chrono::steady_clock::time_point &_time);
+
+      /// \brief Get the size of the serialized message.
+      /// \return The size (bytes).
+      public: uint64_t Size() const;
+
+      /// \brief Set the size of the serialized message.
+      /// \param[in] _size The size (bytes).
+      public: void SetSize(const uint64_t _size);
+
 #ifdef _WIN32
 // Disable warning C4251 which is triggered by
 // std::unique_ptr
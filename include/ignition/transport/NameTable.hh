@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGN_TRANSPORT_NAMETABLE_HH_
+#define IGN_TRANSPORT_NAMETABLE_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ignition/transport/config.hh"
+#include "ignition/transport/Export.hh"
+
+namespace ignition
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_TRANSPORT_VERSION_NAMESPACE {
+    //
+    /// \brief Identifier of a name interned in the NameTable.
+    using NameId = uint32_t;
+
+    /// \brief Identifier returned when a name could not be interned.
+    const NameId kNoNameId = UINT32_MAX;
+
+    /// \brief Identifier of kGenericMessageType, which is always interned.
+    const NameId kGenericMessageTypeId = 0;
+
+    /// \class NameTable NameTable.hh ignition/transport/NameTable.hh
+    /// \brief Process-wide table of interned names, e.g. message types.
+    /// Every name gets a small integer identifier, so the names can be
+    /// compared without comparing strings. The identifiers are never reused
+    /// and the names are never released. Some names come from the network,
+    /// so the table is bounded: once kMaxNames names are interned, the new
+    /// names get kNoNameId and have to be compared as strings.
+    class IGNITION_TRANSPORT_VISIBLE NameTable
+    {
+      /// \brief Maximum number of names interned.
+      public: static const std::size_t kMaxNames = 4096;
+
+      /// \brief Get the identifier of a name, interning the name if needed.
+      /// \param[in] _name The name.
+      /// \return The identifier, or kNoNameId if the table is full.
+      public: static NameId Intern(const std::string &_name);
+
+      /// \brief Get the identifier of a name, without interning it.
+      /// \param[in] _name The name.
+      /// \return The identifier, or kNoNameId if the name is not interned.
+      public: static NameId Find(const std::string &_name);
+
+      /// \brief Get an interned name. The reference remains valid until the
+      /// end of the process.
+      /// \param[in] _id Identifier of the name.
+      /// \return The name, or an empty string if _id is not valid.
+      public: static const std::string &Name(const NameId _id);
+
+      /// \brief Get the number of names interned.
+      /// \return The number of names.
+      public: static std::size_t Size();
+    };
+    }
+  }
+}
+#endif
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -145,6 +146,86 @@ namespace ignition
           const std::string &_msgData,
           const std::string &_msgType);
 
+        /// \brief Publish a raw pre-serialized message without copying it.
+        ///
+        /// \warning This function is only intended for advanced users. See
+        /// PublishRaw(const std::string&, const std::string&).
+        ///
+        /// The buffer is handed to ZeroMQ as is for remote subscribers, and
+        /// local raw subscribers receive the same pointer. Local subscribers
+        /// that expect a protobuf message parse it directly from the buffer.
+        ///
+        /// \param[in] _msgData Pointer to a serialized google::protobuf
+        /// message. It must not be modified until _owner is released.
+        /// \param[in] _msgSize Size of the serialized message (bytes).
+        /// \param[in] _msgType A std::string that contains the message type
+        /// name.
+        /// \param[in] _owner Shared ownership of the buffer. A copy of it is
+        /// kept until ZeroMQ has sent the data to every remote subscriber,
+        /// which may happen on another thread after this function returns. To
+        /// use a custom deallocator, give it as the deleter of a
+        /// std::shared_ptr. If _owner is null, the data is copied for remote
+        /// subscribers, as the std::string overload does.
+        /// \return true when success.
+        public: bool PublishRaw(
+          const char *_msgData,
+          const std::size_t _msgSize,
+          const std::string &_msgType,
+          const std::shared_ptr<const void> &_owner);
+
+        /// \brief Publish a batch of messages. The batch is serialized in a
+        /// single buffer and sent to every remote subscriber in the data
+        /// frame of a single ZeroMQ message, which amortizes the per message
+        /// overhead when many small messages are published at once. If a
+        /// remote subscriber does not accept batches, e.g. because it uses
+        /// an older version of this library, the messages are sent to the
+        /// remote subscribers one at a time instead. Local subscribers
+        /// registered with Node::SubscribeBatch() receive the whole batch in
+        /// a single callback, other subscribers receive one callback per
+        /// message.
+        ///
+        /// The messages of a batch get consecutive sequence numbers. If the
+        /// publication is throttled, the whole batch counts as a single
+        /// publication.
+        /// \param[in] _msgs The messages. All of them must have the
+        /// advertised type.
+        /// \return true when success.
+        public: bool PublishBatch(const std::vector<const ProtoMsg *> &_msgs);
+
+        /// \brief Publish a batch of messages.
+        /// \param[in] _msgs The messages.
+        /// \return true when success.
+        /// \sa PublishBatch(const std::vector<const ProtoMsg *> &)
+        public: template<typename MessageT>
+        bool PublishBatch(const std::vector<MessageT> &_msgs)
+        {
+          std::vector<const ProtoMsg *> msgs;
+          msgs.reserve(_msgs.size());
+          for (const auto &msg : _msgs)
+            msgs.push_back(&msg);
+          return this->PublishBatch(msgs);
+        }
+
+        /// \brief Publish a batch of raw pre-serialized messages.
+        ///
+        /// \warning This function is only intended for advanced users. See
+        /// PublishRaw(const std::string&, const std::string&).
+        ///
+        /// \param[in] _msgData Serialized google::protobuf messages.
+        /// \param[in] _msgType A std::string that contains the message type
+        /// name.
+        /// \return true when success.
+        /// \sa PublishBatch(const std::vector<const ProtoMsg *> &)
+        public: bool PublishRawBatch(
+          const std::vector<std::string> &_msgData,
+          const std::string &_msgType);
+
+        /// \brief Get the number of messages that were not sent to the
+        /// remote subscribers because they did not fit in the send buffer.
+        /// \return The number of messages dropped by the flow control.
+        /// \sa AdvertiseMessageOptions::SetSendBufferLimit
+        public: uint64_t FlowControlDrops() const;
+
         /// \brief Check if message publication is throttled. If so, verify
         /// whether the next message should be published or not.
         ///
@@ -164,6 +245,38 @@ namespace ignition
         /// \return True if subscribers have connected to this publisher.
         public: bool HasConnections() const;
 
+        /// \brief Block until a number of nodes, in this process or in
+        /// remote ones, have subscribed to this publisher. The wait is woken
+        /// up as soon as a subscriber connects, so this should be used
+        /// instead of sleeping before publishing. E.g.:
+        ///
+        ///   if (pub.WaitForSubscribers(1, 1000))
+        ///     pub.Publish(msg);
+        ///
+        /// A remote subscriber is counted when its connection is announced,
+        /// which can happen shortly before its subscription reaches the
+        /// publisher socket. Messages published in between are not
+        /// delivered to it, so publishing a single message to a remote
+        /// subscriber may need a short delay after this returns.
+        ///
+        /// \param[in] _count Number of subscribed nodes to wait for.
+        /// \param[in] _timeout Maximum time to wait (milliseconds).
+        /// \return True if at least _count nodes are subscribed, or false if
+        /// the timeout expired or the publisher is not valid.
+        public: bool WaitForSubscribers(const unsigned int _count,
+                                        const unsigned int _timeout) const;
+
+        /// \brief Asynchronous version of WaitForSubscribers(). The wait
+        /// runs on another thread.
+        /// \param[in] _count Number of subscribed nodes to wait for.
+        /// \param[in] _timeout Maximum time to wait (milliseconds).
+        /// \return A future with the value that WaitForSubscribers() would
+        /// return. As with std::async, the destructor of the future blocks
+        /// until the wait is over.
+        public: std::future<bool> WaitForSubscribersAsync(
+                    const unsigned int _count,
+                    const unsigned int _timeout) const;
+
         /// \internal
         /// \brief Smart pointer to private data.
         /// This is std::shared_ptr because we want to trigger the destructor
@@ -318,6 +431,27 @@ namespace ignition
           ClassT *_obj,
           const SubscribeOptions &_opts = SubscribeOptions());
 
+      /// \brief Subscribe to a topic registering a callback that receives
+      /// the messages in batches. The messages published with
+      /// Publisher::PublishBatch() are received in a single callback, other
+      /// messages are received as batches of one message. The filter and the
+      /// throttling of the subscription options are applied to every message
+      /// of a batch, and the callback is not called if none of them remains.
+      /// \param[in] _topic Topic to be subscribed.
+      /// \param[in] _callback Callback with the following parameters:
+      ///   \param[in] _msgs The messages of the batch. They are only valid
+      ///   during the callback.
+      ///   \param[in] _info Message information. The sequence number is the
+      ///   one of the first message, the next messages of the batch have
+      ///   consecutive sequence numbers unless some of them were discarded.
+      /// \param[in] _opts Subscription options.
+      /// \return true when successfully subscribed or false otherwise.
+      public: template<typename MessageT>
+      bool SubscribeBatch(
+          const std::string &_topic,
+          const MsgBatchCallback<MessageT> &_callback,
+          const SubscribeOptions &_opts = SubscribeOptions());
+
       /// \brief Get the list of topics subscribed by this node. Note that
       /// we might be interested in one topic but we still don't know the
       /// address of a publisher.
@@ -717,6 +851,14 @@ namespace ignition
       /// \return True on success.
       private: bool SubscribeHelper(const std::string &_fullyQualifiedTopic);
 
+      /// \brief Register the handler of a typed subscription. Shared by
+      /// Subscribe() and SubscribeBatch().
+      /// \param[in] _topic Topic to be subscribed.
+      /// \param[in] _handler The subscription handler, with its callback.
+      /// \return true when successfully subscribed or false otherwise.
+      private: bool SubscribeHandler(const std::string &_topic,
+                   const std::shared_ptr<ISubscriptionHandler> &_handler);
+
 #ifdef _WIN32
 // Disable warning C4251 which is triggered by
 // std::unique_ptr
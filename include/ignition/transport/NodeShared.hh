@@ -26,6 +26,7 @@
 #pragma warning(pop)
 #endif
 
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -44,6 +45,11 @@
 #include "ignition/transport/TransportTypes.hh"
 #include "ignition/transport/Uuid.hh"
 
+namespace zmq
+{
+  class socket_t;
+}
+
 namespace ignition
 {
   namespace transport
@@ -88,30 +94,65 @@ namespace ignition
                            DeallocFunc *_ffn,
                            const std::string &_msgType);
 
+      /// \brief Publish data.
+      /// \param[in] _topic Topic to be published.
+      /// \param[in, out] _data Serialized data. It is handed to ZMQ without
+      /// copying, and must stay valid until _ffn is called.
+      /// \param[in] _dataSize Data size (bytes).
+      /// \param[in, out] _ffn Function executed by ZeroMQ, possibly from
+      /// another thread, when the data has been published. It receives
+      /// _data and _hint.
+      /// \param[in] _hint Argument passed to _ffn, e.g. the owner of _data.
+      /// \param[in] _msgType Message type in string format.
+      /// \param[in] _sender If not null, the sender frame of the message,
+      /// with the address of the socket selected by _priority followed by
+      /// the header of the message. Publishers keep a frame and only update
+      /// its header for every message. If null, only the address is sent.
+      /// \param[in] _priority Priority class of the topic, which selects the
+      /// socket used to send the data.
+      /// \param[in] _multicast Whether the data is also sent to the
+      /// multicast group (see AdvertiseMessageOptions::SetMulticast()).
+      /// \return true when success or false otherwise.
+      public: bool Publish(const std::string &_topic,
+                           char *_data,
+                           const size_t _dataSize,
+                           DeallocFunc *_ffn,
+                           void *_hint,
+                           const std::string &_msgType,
+                           const std::string *_sender = nullptr,
+                           const Priority_t _priority = Priority_t::NORMAL,
+                           const bool _multicast = false);
+
       /// \brief Method in charge of receiving the topic updates.
       public: void RecvMsgUpdate();
 
+      /// \brief Receive a topic update from one of the subscriber sockets.
+      /// \param[in] _socket The socket.
+      private: void RecvMsgUpdate(zmq::socket_t &_socket);
+
       /// \brief HandlerInfo contains information about callback handlers which
       /// is useful for local publishers and message receivers. You should only
       /// retrieve a HandlerInfo by calling
       /// CheckHandlerInfo(const std::string &_topic) const
       public: struct HandlerInfo
       {
-        /// \brief This is a map of the standard local callback handlers. The
-        /// key is the topic name, and the value is another map whose key is
-        /// the node UUID and whose value is a smart pointer to the handler.
-        public: std::map<std::string, ISubscriptionHandler_M> localHandlers;
-
-        /// \brief This is a map of the raw local callback handlers. The key is
-        /// the topic name, and the value is another map whose key is the node
-        /// UUID and whose value is a smart pointer to the handler.
-        public: std::map<std::string, RawSubscriptionHandler_M> rawHandlers;
+        /// \brief Snapshot of the standard local callback handlers of the
+        /// topic. It is never null.
+        public: HandlerStorage<ISubscriptionHandler>::EntriesPtr
+          localHandlers =
+            HandlerStorage<ISubscriptionHandler>::EmptyEntries();
+
+        /// \brief Snapshot of the raw local callback handlers of the topic.
+        /// It is never null.
+        public: HandlerStorage<RawSubscriptionHandler>::EntriesPtr
+          rawHandlers =
+            HandlerStorage<RawSubscriptionHandler>::EmptyEntries();
 
         /// \brief True iff there are any standard local subscribers.
-        public: bool haveLocal;
+        public: bool haveLocal = false;
 
         /// \brief True iff there are any raw local subscribers
-        public: bool haveRaw;
+        public: bool haveRaw = false;
 
         // Friendship. This allows HandlerInfo to be created by
         // CheckHandlerInfo()
@@ -184,6 +225,35 @@ namespace ignition
         const std::string &_msgData,
         const HandlerInfo &_handlerInfo);
 
+      /// \brief Call the SubscriptionHandler callbacks (local and raw) for this
+      /// NodeShared. Raw callbacks receive _msgData itself, without copies.
+      /// \param[in] _info Message information.
+      /// \param[in] _msgData The raw serialized data for the message
+      /// \param[in] _msgSize The size of the serialized data (bytes)
+      /// \param[in] _handlerInfo Information for the handlers of this node,
+      /// as generated by CheckHandlerInfo(const std::string&) const
+      public: void TriggerCallbacks(
+        const MessageInfo &_info,
+        const char *_msgData,
+        const std::size_t _msgSize,
+        const HandlerInfo &_handlerInfo);
+
+      /// \brief Call the SubscriptionHandler callbacks (local and raw) for a
+      /// batch of messages. Every message is deserialized once, and the local
+      /// handlers receive the whole batch (see
+      /// ISubscriptionHandler::RunLocalBatchCallback()).
+      /// \param[in] _info Information of the first message of the batch.
+      /// \param[in] _batchData The serialized batch, where every message is
+      /// preceded by its index in the batch and its size.
+      /// \param[in] _batchSize The size of the batch (bytes).
+      /// \param[in] _handlerInfo Information for the handlers of this node,
+      /// as generated by CheckHandlerInfo(const std::string&) const
+      public: void TriggerBatchCallbacks(
+        const MessageInfo &_info,
+        const char *_batchData,
+        const std::size_t _batchSize,
+        const HandlerInfo &_handlerInfo);
+
       /// \brief Method in charge of receiving the control updates (when a new
       /// remote subscriber notifies its presence for example).
       public: void RecvControlUpdate();
@@ -256,6 +326,18 @@ namespace ignition
       /// return false if any operation on a ZMQ socket triggered an exception.
       private: bool InitializeSockets();
 
+      /// \brief Advertise the statistics topic and start the thread that
+      /// runs RunStatisticsTask(), if IGN_TRANSPORT_STATS is set to 1. It is
+      /// called by every Node, so it runs in the thread of the first Node
+      /// created and never in one of the threads owned by NodeShared. Only
+      /// the first call has an effect.
+      private: void StartStatistics();
+
+      /// \brief Publish the statistics of the publishers and subscribers of
+      /// this process periodically, until the NodeShared is destroyed. This
+      /// runs in its own thread when IGN_TRANSPORT_STATS is set to 1.
+      private: void RunStatisticsTask();
+
       //////////////////////////////////////////////////
       /////// Declare here other member variables //////
       //////////////////////////////////////////////////
@@ -334,6 +416,31 @@ namespace ignition
             const std::string &_fullyQualifiedTopic,
             const std::string &_msgTypeName) const;
 
+        /// \brief Get the rate at which a node wants to receive the messages
+        /// of a topic, according to the throttling of its subscribers.
+        /// \param[in] _fullyQualifiedTopic Fully-qualified topic name.
+        /// \param[in] _msgTypeName Name of the message type.
+        /// \param[in] _nUuid UUID of the node.
+        /// \return The highest rate of the subscribers of the node (messages
+        /// per second), or 0 if any of them is not throttled.
+        public: uint64_t NodeMsgsPerSec(
+            const std::string &_fullyQualifiedTopic,
+            const std::string &_msgTypeName,
+            const std::string &_nUuid) const;
+
+        /// \brief Get the filter that the messages of a topic must match to
+        /// be of interest to a node, according to the filters of its
+        /// subscribers.
+        /// \param[in] _fullyQualifiedTopic Fully-qualified topic name.
+        /// \param[in] _msgTypeName Name of the message type.
+        /// \param[in] _nUuid UUID of the node.
+        /// \return The filters of the subscribers of the node joined with
+        /// "||", or an empty string if any of them is not filtered.
+        public: std::string NodeFilter(
+            const std::string &_fullyQualifiedTopic,
+            const std::string &_msgTypeName,
+            const std::string &_nUuid) const;
+
         /// \brief Remove the handlers for the given topic name that belong to
         /// a specific node.
         /// \param[in] _fullyQualifiedTopic The fully-qualified name of the
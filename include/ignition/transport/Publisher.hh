@@ -267,6 +267,31 @@ namespace ignition
       /// \sa Ctrl.
       public: void SetCtrl(const std::string &_ctrl);
 
+      /// \brief Get the ZeroMQ IPC address of the publisher. Subscribers
+      /// running on the same host connect to this address instead of the
+      /// TCP address returned by Addr().
+      /// \return ZeroMQ IPC address of the publisher or an empty string if
+      /// the publisher is not reachable through IPC.
+      /// \sa SetIpcAddr.
+      public: std::string IpcAddr() const;
+
+      /// \brief Set the ZeroMQ IPC address of the publisher.
+      /// \param[in] _ipcAddr New IPC address.
+      /// \sa IpcAddr.
+      public: void SetIpcAddr(const std::string &_ipcAddr);
+
+      /// \brief Get the multicast group and port where the publisher sends
+      /// the messages of the topic, e.g. 239.255.0.8:10400.
+      /// \return The group and port, or an empty string if the topic is not
+      /// sent through multicast.
+      /// \sa AdvertiseMessageOptions::SetMulticast
+      public: std::string MulticastAddr() const;
+
+      /// \brief Set the multicast group and port of the publisher.
+      /// \param[in] _multicastAddr New group and port.
+      /// \sa MulticastAddr.
+      public: void SetMulticastAddr(const std::string &_multicastAddr);
+
       /// \brief Get the message type advertised by this publisher.
       /// \return Message type.
       public: std::string MsgTypeName() const;
@@ -305,8 +330,12 @@ namespace ignition
              << "\tAddress: "          << _msg.Addr()         << std::endl
              << "\tProcess UUID: "     << _msg.PUuid()        << std::endl
              << "\tNode UUID: "        << _msg.NUuid()        << std::endl
-             << "\tControl address: "  << _msg.Ctrl()         << std::endl
-             << "\tMessage type: "     << _msg.MsgTypeName()  << std::endl
+             << "\tControl address: "  << _msg.Ctrl()         << std::endl;
+        if (!_msg.IpcAddr().empty())
+          _out << "\tIPC address: "    << _msg.IpcAddr()      << std::endl;
+        if (!_msg.MulticastAddr().empty())
+          _out << "\tMulticast address: " << _msg.MulticastAddr() << std::endl;
+        _out << "\tMessage type: "     << _msg.MsgTypeName()  << std::endl
              << _msg.Options();
         return _out;
       }
@@ -339,6 +368,12 @@ namespace ignition
       /// \brief ZeroMQ control address of the publisher.
       private: std::string ctrl;
 
+      /// \brief ZeroMQ IPC address of the publisher.
+      private: std::string ipcAddr;
+
+      /// \brief Multicast group and port of the publisher.
+      private: std::string multicastAddr;
+
       /// \brief Message type advertised by this publisher.
       private: std::string msgTypeName;
 #ifdef _WIN32
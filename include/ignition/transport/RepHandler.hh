@@ -188,13 +188,15 @@ namespace ignition
       // Documentation inherited.
       public: virtual std::string ReqTypeName() const
       {
-        return Req().GetTypeName();
+        static const std::string kTypeName = Req().GetTypeName();
+        return kTypeName;
       }
 
       // Documentation inherited.
       public: virtual std::string RepTypeName() const
       {
-        return Rep().GetTypeName();
+        static const std::string kTypeName = Rep().GetTypeName();
+        return kTypeName;
       }
 
       /// \brief Create a specific protobuf message given its serialized data.
@@ -20,6 +20,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 
 #include "ignition/transport/config.hh"
 #include "ignition/transport/Export.hh"
@@ -66,6 +67,42 @@ namespace ignition
       /// \return The maximum number of messages per second.
       public: uint64_t MsgsPerSec() const;
 
+      /// \brief Set a filter on the content of the messages. Only the
+      /// messages that match the filter are passed to the callback. The
+      /// filter is also sent to the publishers, which do not send a message
+      /// to another process if none of its subscribers want it. See
+      /// MessageFilter for the syntax of the expression. Raw subscriptions
+      /// ignore the filter.
+      /// \param[in] _filter The filter expression. An empty expression
+      /// (default) disables the filtering.
+      /// \sa Filter
+      public: void SetFilter(const std::string &_filter);
+
+      /// \brief Get the filter on the content of the messages.
+      /// \return The filter expression, or an empty string if the messages
+      /// are not filtered.
+      /// \sa SetFilter
+      public: const std::string &Filter() const;
+
+      /// \brief Set whether the messages received from other processes are
+      /// allocated on the heap. By default, they are deserialized into an
+      /// arena of the reception thread, which is reset when the callbacks
+      /// return: a message with many nested fields then costs a few
+      /// allocations instead of one per field. Set this option when the
+      /// callback relies on messages that are not owned by an arena, e.g.
+      /// because it moves their fields to other messages. In both cases, the
+      /// message is only valid until the callback returns.
+      /// \param[in] _heap True to allocate the messages on the heap.
+      /// \sa HeapMessages
+      public: void SetHeapMessages(const bool _heap);
+
+      /// \brief Whether the messages received from other processes are
+      /// allocated on the heap.
+      /// \return True if the messages are allocated on the heap, false if
+      /// they are allocated in an arena (default).
+      /// \sa SetHeapMessages
+      public: bool HeapMessages() const;
+
 #ifdef _WIN32
 // Disable warning C4251 which is triggered by
 // std::unique_ptr
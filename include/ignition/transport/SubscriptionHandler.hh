@@ -21,6 +21,7 @@
 #ifdef _MSC_VER
 #pragma warning(push, 0)
 #endif
+#include <google/protobuf/arena.h>
 #include <google/protobuf/message.h>
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -33,16 +34,21 @@
 #endif
 
 #include <chrono>
+#include <cstddef>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <ignition/msgs/Factory.hh>
 
 #include "ignition/transport/config.hh"
 #include "ignition/transport/Export.hh"
+#include "ignition/transport/MessageFilter.hh"
 #include "ignition/transport/MessageInfo.hh"
+#include "ignition/transport/NameTable.hh"
 #include "ignition/transport/SubscribeOptions.hh"
 #include "ignition/transport/TransportTypes.hh"
 #include "ignition/transport/Uuid.hh"
@@ -54,6 +60,9 @@ namespace ignition
     // Inline bracket to help doxygen filtering.
     inline namespace IGNITION_TRANSPORT_VERSION_NAMESPACE {
     //
+    // Forward declarations.
+    class EndpointCounters;
+
     /// \brief SubscriptionHandlerBase contains functions and data which are
     /// common to all SubscriptionHandler types.
     class IGNITION_TRANSPORT_VISIBLE SubscriptionHandlerBase
@@ -73,6 +82,21 @@ namespace ignition
       /// \return String representation of the message type.
       public: virtual std::string TypeName() = 0;
 
+      /// \brief Get the identifier of TypeName() in the NameTable.
+      /// \return The identifier, or kNoNameId if the type could not be
+      /// interned.
+      public: NameId TypeId() const;
+
+      /// \brief Check whether this handler receives the messages of a type.
+      /// The types are compared by identifier, and only by name if one of
+      /// them could not be interned.
+      /// \param[in] _typeId Identifier of the type in the NameTable.
+      /// \param[in] _typeName Name of the type.
+      /// \return True if the handler receives the messages of the type, or
+      /// receives any type.
+      public: bool AcceptsType(const NameId _typeId,
+                               const std::string &_typeName);
+
       /// \brief Get the node UUID.
       /// \return The string representation of the node UUID.
       public: std::string NodeUuid() const;
@@ -81,18 +105,101 @@ namespace ignition
       /// \return A string representation of the handler UUID.
       public: std::string HandlerUuid() const;
 
+      /// \internal
+      /// \brief Get the statistics counters of this handler.
+      /// \return The counters, or nullptr if the statistics are disabled
+      /// (see the IGN_TRANSPORT_STATS environment variable).
+      public: EndpointCounters *Counters() const;
+
+      /// \brief Get the subscribe options of this handler.
+      /// \return The subscribe options.
+      public: const SubscribeOptions &Options() const;
+
+      /// \brief Get the filter on the content of the messages, created from
+      /// SubscribeOptions::Filter().
+      /// \return The filter.
+      public: const MessageFilter &Filter() const;
+
       /// \brief Check if message subscription is throttled. If so, verify
       /// whether the callback should be executed or not.
+      /// \param[in] _info Information of the message. If the publisher has
+      /// already downsampled the messages, the throttling tolerates half of
+      /// its period of jitter, so that the messages downsampled for this
+      /// handler are not dropped again.
       /// \return true if the callback should be executed or false otherwise.
-      protected: bool UpdateThrottling();
+      protected: bool UpdateThrottling(const MessageInfo &_info);
+
+      /// \brief Drop a message if the subscription throttling would discard
+      /// it, without updating the throttling. It lets the dispatch skip the
+      /// deserialization of the messages that the handler would not
+      /// receive. It never drops the messages if the handler has a filter,
+      /// because the throttling only applies to the messages that match it.
+      /// \param[in] _info Information of the message.
+      /// \param[in] _count Number of messages, e.g. the size of a batch
+      /// received at once. They are all counted as dropped.
+      /// \return True if the message was dropped.
+      public: bool DropIfThrottled(const MessageInfo &_info,
+                                   const uint64_t _count = 1);
+
+      /// \brief Run the user callback and, if the statistics are enabled,
+      /// count the messages passed to it and the time that it took. The
+      /// messages skipped by the filter or the throttling are not passed to
+      /// this function, so they are not counted as received.
+      /// \param[in] _bytes Size of the serialized messages.
+      /// \param[in] _count Number of messages passed to the callback.
+      /// \param[in] _cb Function that runs the user callback.
+      protected: template <typename Callback>
+                 void RunCallback(const std::size_t _bytes,
+                                  const uint64_t _count,
+                                  Callback &&_cb)
+      {
+        if (!this->counters)
+        {
+          _cb();
+          return;
+        }
+
+        const Timestamp start = std::chrono::steady_clock::now();
+        _cb();
+        this->CountCallback(_bytes, _count,
+          std::chrono::steady_clock::now() - start);
+      }
+
+      /// \brief Get the size of a serialized message.
+      /// \param[in] _msg The message.
+      /// \return The size (bytes).
+      protected: static std::size_t SerializedSize(const ProtoMsg &_msg);
+
+      /// \brief Check whether the throttling lets a message through.
+      /// \param[in] _now Current time.
+      /// \param[in] _info Information of the message.
+      /// \return True if the message should be delivered.
+      private: bool ThrottlingAllows(const Timestamp &_now,
+                                     const MessageInfo &_info) const;
+
+      /// \brief Count the messages passed to the user callback and the time
+      /// that it took. Only called when the statistics are enabled.
+      /// \param[in] _bytes Size of the serialized messages.
+      /// \param[in] _count Number of messages.
+      /// \param[in] _elapsed Duration of the callback.
+      private: void CountCallback(const std::size_t _bytes,
+                                  const uint64_t _count,
+                                  const std::chrono::nanoseconds &_elapsed);
 
       /// \brief Subscribe options.
       protected: SubscribeOptions opts;
 
+      /// \brief Filter on the content of the messages.
+      protected: MessageFilter filter;
+
       /// \brief If throttling is enabled, the minimum period for receiving a
       /// message in nanoseconds.
       protected: double periodNs;
 
+      /// \brief Identifier of the message type, set by the constructor of
+      /// the derived classes.
+      protected: NameId typeId = kNoNameId;
+
 #ifdef _WIN32
 // Disable warning C4251 which is triggered by
 // std::*
@@ -107,6 +214,10 @@ namespace ignition
 
       /// \brief Node UUID.
       private: std::string nUuid;
+
+      /// \brief Statistics counters, only created when the statistics are
+      /// enabled.
+      private: std::shared_ptr<EndpointCounters> counters;
 #ifdef _WIN32
 #pragma warning(pop)
 #endif
@@ -141,6 +252,17 @@ namespace ignition
         const ProtoMsg &_msg,
         const MessageInfo &_info) = 0;
 
+      /// \brief Executes the local callback registered for this handler with
+      /// a batch of messages. By default, RunLocalCallback() is called for
+      /// every message.
+      /// \param[in] _msgs Messages of the batch and their sequence numbers.
+      /// \param[in] _info Message information shared by the batch. Its
+      /// sequence number is ignored.
+      /// \return True when success, false otherwise.
+      public: virtual bool RunLocalBatchCallback(
+        const std::vector<std::pair<const ProtoMsg *, uint64_t>> &_msgs,
+        const MessageInfo &_info);
+
       /// \brief Create a specific protobuf message given its serialized data.
       /// \param[in] _data The serialized data.
       /// \param[in] _type The data type.
@@ -148,6 +270,39 @@ namespace ignition
       public: virtual const std::shared_ptr<ProtoMsg> CreateMsg(
         const std::string &_data,
         const std::string &_type) const = 0;
+
+      /// \brief Create a specific protobuf message given its serialized data,
+      /// without requiring the data to be stored in a std::string.
+      /// \param[in] _data Pointer to the serialized data.
+      /// \param[in] _size Size of the serialized data (bytes).
+      /// \param[in] _type The data type.
+      /// \return Pointer to the specific protobuf message.
+      public: virtual const std::shared_ptr<ProtoMsg> CreateMsg(
+        const char *_data,
+        const std::size_t _size,
+        const std::string &_type) const
+      {
+        return this->CreateMsg(std::string(_data, _size), _type);
+      }
+
+      /// \brief Create a specific protobuf message given its serialized data,
+      /// allocating it in an arena.
+      /// \param[in] _data Pointer to the serialized data.
+      /// \param[in] _size Size of the serialized data (bytes).
+      /// \param[in] _type The data type.
+      /// \param[in] _arena The arena, which owns the message and must
+      /// outlive the pointer returned. If nullptr, the message is allocated
+      /// on the heap. By default, the arena is ignored.
+      /// \return Pointer to the specific protobuf message.
+      public: virtual const std::shared_ptr<ProtoMsg> CreateMsg(
+        const char *_data,
+        const std::size_t _size,
+        const std::string &_type,
+        google::protobuf::Arena *_arena) const
+      {
+        (void)_arena;
+        return this->CreateMsg(_data, _size, _type);
+      }
     };
 
     /// \class SubscriptionHandler SubscriptionHandler.hh
@@ -162,20 +317,50 @@ namespace ignition
         const SubscribeOptions &_opts = SubscribeOptions())
         : ISubscriptionHandler(_nUuid, _opts)
       {
+        this->typeId = NameTable::Intern(this->TypeName());
       }
 
       // Documentation inherited.
       public: const std::shared_ptr<ProtoMsg> CreateMsg(
         const std::string &_data,
-        const std::string &/*_type*/) const
+        const std::string &_type) const
+      {
+        return this->CreateMsg(_data.data(), _data.size(), _type);
+      }
+
+      // Documentation inherited.
+      public: const std::shared_ptr<ProtoMsg> CreateMsg(
+        const char *_data,
+        const std::size_t _size,
+        const std::string &_type) const
+      {
+        return this->CreateMsg(_data, _size, _type, nullptr);
+      }
+
+      // Documentation inherited.
+      public: const std::shared_ptr<ProtoMsg> CreateMsg(
+        const char *_data,
+        const std::size_t _size,
+        const std::string &/*_type*/,
+        google::protobuf::Arena *_arena) const
       {
         // Instantiate a specific protobuf message
-        auto msgPtr = std::make_shared<T>();
+        std::shared_ptr<T> msgPtr;
+        if (_arena)
+        {
+          // The arena owns the message.
+          msgPtr.reset(google::protobuf::Arena::CreateMessage<T>(_arena),
+            [](T *) {});
+        }
+        else
+        {
+          msgPtr = std::make_shared<T>();
+        }
 
         // Create the message using some serialized data
-        if (!msgPtr->ParseFromString(_data))
+        if (!msgPtr->ParseFromArray(_data, static_cast<int>(_size)))
         {
-          std::cerr << "SubscriptionHandler::CreateMsg() error: ParseFromString"
+          std::cerr << "SubscriptionHandler::CreateMsg() error: ParseFromArray"
                     << " failed" << std::endl;
         }
 
@@ -185,7 +370,9 @@ namespace ignition
       // Documentation inherited.
       public: std::string TypeName()
       {
-        return T().GetTypeName();
+        // Only build a message the first time.
+        static const std::string kTypeName = T().GetTypeName();
+        return kTypeName;
       }
 
       /// \brief Set the callback for this handler.
@@ -195,10 +382,25 @@ namespace ignition
         this->cb = _cb;
       }
 
+      /// \brief Set a callback that receives the messages in batches. A
+      /// message that was not published in a batch is received as a batch
+      /// of one message.
+      /// \param[in] _cb The callback.
+      public: void SetBatchCallback(const MsgBatchCallback<T> &_cb)
+      {
+        this->batchCb = _cb;
+      }
+
       // Documentation inherited.
       public: bool RunLocalCallback(const ProtoMsg &_msg,
                                     const MessageInfo &_info)
       {
+        if (!this->cb && this->batchCb)
+        {
+          return this->RunLocalBatchCallback(
+            {std::make_pair(&_msg, _info.SequenceNumber())}, _info);
+        }
+
         // No callback stored.
         if (!this->cb)
         {
@@ -207,8 +409,12 @@ namespace ignition
           return false;
         }
 
+        // Skip the messages that do not match the filter.
+        if (!this->filter.Matches(_msg))
+          return true;
+
         // Check the subscription throttling option.
-        if (!this->UpdateThrottling())
+        if (!this->UpdateThrottling(_info))
           return true;
 
 #if GOOGLE_PROTOBUF_VERSION >= 3000000
@@ -217,12 +423,68 @@ namespace ignition
         auto msgPtr = google::protobuf::internal::down_cast<const T*>(&_msg);
 #endif
 
-        this->cb(*msgPtr, _info);
+        this->RunCallback(_info.Size(), 1u, [&]()
+        {
+          this->cb(*msgPtr, _info);
+        });
+        return true;
+      }
+
+      // Documentation inherited.
+      public: bool RunLocalBatchCallback(
+        const std::vector<std::pair<const ProtoMsg *, uint64_t>> &_msgs,
+        const MessageInfo &_info)
+      {
+        if (!this->batchCb)
+          return ISubscriptionHandler::RunLocalBatchCallback(_msgs, _info);
+
+        std::vector<const T *> msgs;
+        msgs.reserve(_msgs.size());
+        uint64_t firstSequence = 0;
+        for (const auto &msg : _msgs)
+        {
+          if (!this->filter.Matches(*msg.first) ||
+              !this->UpdateThrottling(_info))
+          {
+            continue;
+          }
+
+          if (msgs.empty())
+            firstSequence = msg.second;
+
+#if GOOGLE_PROTOBUF_VERSION >= 3000000
+          msgs.push_back(google::protobuf::down_cast<const T*>(msg.first));
+#else
+          msgs.push_back(
+            google::protobuf::internal::down_cast<const T*>(msg.first));
+#endif
+        }
+
+        if (msgs.empty())
+          return true;
+
+        // The size of the messages is only computed for the statistics.
+        std::size_t bytes = 0;
+        if (this->Counters())
+        {
+          for (const T *msg : msgs)
+            bytes += SerializedSize(*msg);
+        }
+
+        MessageInfo info(_info);
+        info.SetSequenceNumber(firstSequence);
+        this->RunCallback(bytes, msgs.size(), [&]()
+        {
+          this->batchCb(msgs, info);
+        });
         return true;
       }
 
       /// \brief Callback to the function registered for this handler.
       private: MsgCallback<T> cb;
+
+      /// \brief Callback that receives batches of messages.
+      private: MsgBatchCallback<T> batchCb;
     };
 
     /// \brief Specialized template when the user prefers a callbacks that
@@ -235,6 +497,7 @@ namespace ignition
         const SubscribeOptions &_opts = SubscribeOptions())
         : ISubscriptionHandler(_nUuid, _opts)
       {
+        this->typeId = kGenericMessageTypeId;
       }
 
       // Documentation inherited.
@@ -242,32 +505,50 @@ namespace ignition
         const std::string &_data,
         const std::string &_type) const
       {
-        std::shared_ptr<google::protobuf::Message> msgPtr;
+        return this->CreateMsg(_data.data(), _data.size(), _type);
+      }
 
-        const google::protobuf::Descriptor *desc =
-          google::protobuf::DescriptorPool::generated_pool()
-            ->FindMessageTypeByName(_type);
+      // Documentation inherited.
+      public: const std::shared_ptr<ProtoMsg> CreateMsg(
+        const char *_data,
+        const std::size_t _size,
+        const std::string &_type) const
+      {
+        return this->CreateMsg(_data, _size, _type, nullptr);
+      }
 
-        // First, check if we have the descriptor from the generated proto
-        // classes.
-        if (desc)
-        {
-          msgPtr.reset(google::protobuf::MessageFactory::generated_factory()
-            ->GetPrototype(desc)->New());
-        }
-        else
+      // Documentation inherited.
+      public: const std::shared_ptr<ProtoMsg> CreateMsg(
+        const char *_data,
+        const std::size_t _size,
+        const std::string &_type,
+        google::protobuf::Arena *_arena) const
+      {
+        std::shared_ptr<google::protobuf::Message> msgPtr;
         {
-          // Fallback on Ignition Msgs if the message type is not found.
-          msgPtr = ignition::msgs::Factory::New(_type);
+          // Looking up the type is expensive, so the handler keeps a
+          // message of the last type it created and clones it.
+          std::lock_guard<std::mutex> lk(this->prototypeMutex);
+          if (!this->prototype || this->prototypeType != _type)
+          {
+            this->prototype = this->Prototype(_type);
+            this->prototypeType = _type;
+          }
+
+          if (!this->prototype)
+            return nullptr;
+
+          // The arena owns the messages allocated in it.
+          if (_arena)
+            msgPtr.reset(this->prototype->New(_arena), [](ProtoMsg *) {});
+          else
+            msgPtr.reset(this->prototype->New());
         }
 
-        if (!msgPtr)
-          return nullptr;
-
         // Create the message using some serialized data
-        if (!msgPtr->ParseFromString(_data))
+        if (!msgPtr->ParseFromArray(_data, static_cast<int>(_size)))
         {
-          std::cerr << "CreateMsg() error: ParseFromString failed" << std::endl;
+          std::cerr << "CreateMsg() error: ParseFromArray failed" << std::endl;
           return nullptr;
         }
 
@@ -299,16 +580,56 @@ namespace ignition
           return false;
         }
 
+        // Skip the messages that do not match the filter.
+        if (!this->filter.Matches(_msg))
+          return true;
+
         // Check the subscription throttling option.
-        if (!this->UpdateThrottling())
+        if (!this->UpdateThrottling(_info))
           return true;
 
-        this->cb(_msg, _info);
+        this->RunCallback(_info.Size(), 1u, [&]()
+        {
+          this->cb(_msg, _info);
+        });
         return true;
       }
 
+      /// \brief Get a message of a type, which can create the other
+      /// messages of this type with New().
+      /// \param[in] _type The type.
+      /// \return The message, or nullptr if the type is unknown.
+      private: static std::shared_ptr<const ProtoMsg> Prototype(
+        const std::string &_type)
+      {
+        const google::protobuf::Descriptor *desc =
+          google::protobuf::DescriptorPool::generated_pool()
+            ->FindMessageTypeByName(_type);
+
+        // First, check if we have the descriptor from the generated proto
+        // classes. Their prototypes are owned by the factory.
+        if (desc)
+        {
+          return std::shared_ptr<const ProtoMsg>(
+            google::protobuf::MessageFactory::generated_factory()
+              ->GetPrototype(desc), [](const ProtoMsg *) {});
+        }
+
+        // Fallback on Ignition Msgs if the message type is not found.
+        return ignition::msgs::Factory::New(_type);
+      }
+
       /// \brief Callback to the function registered for this handler.
       private: MsgCallback<ProtoMsg> cb;
+
+      /// \brief Protects prototype and prototypeType.
+      private: mutable std::mutex prototypeMutex;
+
+      /// \brief Message of the last type created by CreateMsg().
+      private: mutable std::shared_ptr<const ProtoMsg> prototype;
+
+      /// \brief Type of prototype.
+      private: mutable std::string prototypeType;
     };
 
     //////////////////////////////////////////////////
@@ -140,6 +140,18 @@ namespace ignition
     using MsgCallback =
       std::function<void(const T &_msg, const MessageInfo &_info)>;
 
+    /// \def MsgBatchCallback
+    /// \brief User callback used for receiving batches of messages, see
+    /// Node::Publisher::PublishBatch():
+    ///   \param[in] _msgs Protobuf messages of the batch. The pointers are
+    ///   only valid during the callback.
+    ///   \param[in] _info Information of the first message of the batch.
+    ///   The sequence numbers of the following messages are greater.
+    template <typename T>
+    using MsgBatchCallback =
+      std::function<void(const std::vector<const T *> &_msgs,
+                         const MessageInfo &_info)>;
+
     /// \def RawCallback
     /// \brief User callback used for receiving raw message data:
     /// \param[in] _msgData string of a serialized protobuf message
@@ -112,18 +112,6 @@ namespace ignition
                            const MessageInfo &_info)> &_cb,
         const SubscribeOptions &_opts)
     {
-      // Topic remapping.
-      std::string topic = _topic;
-      this->Options().TopicRemap(_topic, topic);
-
-      std::string fullyQualifiedTopic;
-      if (!TopicUtils::FullyQualifiedName(this->Options().Partition(),
-        this->Options().NameSpace(), topic, fullyQualifiedTopic))
-      {
-        std::cerr << "Topic [" << topic << "] is not valid." << std::endl;
-        return false;
-      }
-
       // Create a new subscription handler.
       std::shared_ptr<SubscriptionHandler<MessageT>> subscrHandlerPtr(
           new SubscriptionHandler<MessageT>(this->NodeUuid(), _opts));
@@ -131,16 +119,7 @@ namespace ignition
       // Insert the callback into the handler.
       subscrHandlerPtr->SetCallback(_cb);
 
-      std::lock_guard<std::recursive_mutex> lk(this->Shared()->mutex);
-
-      // Store the subscription handler. Each subscription handler is
-      // associated with a topic. When the receiving thread gets new data,
-      // it will recover the subscription handler associated to the topic and
-      // will invoke the callback.
-      this->Shared()->localSubscribers.normal.AddHandler(
-        fullyQualifiedTopic, this->NodeUuid(), subscrHandlerPtr);
-
-      return this->SubscribeHelper(fullyQualifiedTopic);
+      return this->SubscribeHandler(_topic, subscrHandlerPtr);
     }
 
     //////////////////////////////////////////////////
@@ -163,6 +142,23 @@ namespace ignition
       return this->Subscribe<MessageT>(_topic, f, _opts);
     }
 
+    //////////////////////////////////////////////////
+    template<typename MessageT>
+    bool Node::SubscribeBatch(
+        const std::string &_topic,
+        const MsgBatchCallback<MessageT> &_cb,
+        const SubscribeOptions &_opts)
+    {
+      // Create a new subscription handler.
+      std::shared_ptr<SubscriptionHandler<MessageT>> subscrHandlerPtr(
+          new SubscriptionHandler<MessageT>(this->NodeUuid(), _opts));
+
+      // Insert the callback into the handler.
+      subscrHandlerPtr->SetBatchCallback(_cb);
+
+      return this->SubscribeHandler(_topic, subscrHandlerPtr);
+    }
+
     //////////////////////////////////////////////////
     template<typename RequestT, typename ReplyT>
     bool Node::Advertise(
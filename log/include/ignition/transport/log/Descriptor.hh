@@ -77,6 +77,15 @@ namespace ignition
           const std::string &_topicName,
           const std::string &_msgType) const;
 
+        /// \brief Check whether the log indexes its messages by topic and time
+        /// received. Queries that only request some of the topics use this
+        /// index to jump directly to the requested time range of each topic,
+        /// instead of scanning the messages of every topic. Logs recorded
+        /// with older versions of the library may not have it, see
+        /// Log::AddTopicTimeIndex().
+        /// \return True if the log has a (topic, time received) index.
+        public: bool HasTopicTimeIndex() const;
+
         // The Log class is a friend so that it can construct a Descriptor
         friend class Log;
 
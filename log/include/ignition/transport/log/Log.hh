@@ -19,9 +19,12 @@
 #define IGNITION_TRANSPORT_LOG_LOG_HH_
 
 #include <chrono>
+#include <cstddef>
+#include <functional>
 #include <ios>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <ignition/transport/config.hh>
 #include <ignition/transport/log/Batch.hh>
@@ -41,6 +44,14 @@ namespace ignition
       /// \brief Name of Environment variable containing path to schema
       const std::string SchemaLocationEnvVar = "IGN_TRANSPORT_LOG_SQL_PATH";
 
+      /// \brief Function that receives the messages of a parallel query.
+      /// \param[in] _shard Index of the shard that the message belongs to.
+      /// Shards are numbered in time order, starting at 0.
+      /// \param[in] _msg The message. It is only valid during the call.
+      /// \sa Log::QueryMessagesParallel()
+      using ShardCallback =
+          std::function<void(std::size_t _shard, const Message &_msg)>;
+
       /// \brief Interface to a log file
       class IGNITION_TRANSPORT_LOG_VISIBLE Log
       {
@@ -63,7 +74,8 @@ namespace ignition
         /// \return empty string if the log has not been opened
         public: std::string Version() const;
 
-        /// \brief Open a log file
+        /// \brief Open a log file. An existing log is never modified when it
+        /// is opened, see AddTopicTimeIndex().
         /// \param[in] _file path to log file
         /// \param[in] _mode flag indicating read only or read/write
         ///   Can use (in or out)
@@ -84,6 +96,17 @@ namespace ignition
         /// loaded. If no log file is loaded, this returns a nullptr.
         public: const log::Descriptor *Descriptor() const;
 
+        /// \brief Add the (topic, time received) index to a log recorded
+        /// before the index was part of the schema, so that seeking to a
+        /// time in some topics does not scan all of their messages. Building
+        /// the index can take a while on large logs. If the log was opened
+        /// read only, the index is added through another connection, which
+        /// requires the file to be writable.
+        /// \return True if the log has the index, false if it could not be
+        /// added.
+        /// \sa Descriptor::HasTopicTimeIndex()
+        public: bool AddTopicTimeIndex();
+
         /// \brief Insert a message into the log file
         /// \param[in] _time Time the message was received (ns since Unix epoch)
         /// \param[in] _topic Name of the topic the message was on
@@ -104,6 +127,46 @@ namespace ignition
         public: Batch QueryMessages(
             const QueryOptions &_options = AllTopics());
 
+        /// \brief Split a query into shards. The time range of the log (or
+        /// the time range of _options, if it is narrower) is divided into
+        /// _numShards consecutive intervals of equal duration, and each shard
+        /// only contains the messages of its interval.
+        ///
+        /// Every shard reads the log through its own read-only connection, so
+        /// the batches can be iterated concurrently from different threads.
+        /// Iterating the batches one after the other produces the same
+        /// messages, in the same order, as QueryMessages(). Logs that live
+        /// in an in-memory database cannot be opened again, so their shards
+        /// share the connection of this log and must be iterated from one
+        /// thread at a time.
+        /// \param[in] _options A QueryOptions type to indicate what kind of
+        /// messages you would like to query.
+        /// \param[in] _numShards Number of shards. Values lower than 1 are
+        /// treated as 1.
+        /// \return One Batch per shard, in time order, or an empty vector if
+        /// the log is not valid or could not be opened again.
+        public: std::vector<Batch> QueryMessagesSharded(
+            const QueryOptions &_options,
+            std::size_t _numShards);
+
+        /// \brief Query messages with one thread per shard (see
+        /// QueryMessagesSharded()) and pass every message to a callback.
+        /// Within a shard the messages are delivered in time order, but the
+        /// shards are read concurrently, so _callback must be thread-safe.
+        /// The shards of an in-memory log are read one after the other, in
+        /// the calling thread. This function blocks until all the shards have
+        /// been read.
+        /// \param[in] _options A QueryOptions type to indicate what kind of
+        /// messages you would like to query.
+        /// \param[in] _numShards Number of shards, and therefore threads.
+        /// \param[in] _callback Function called for every message.
+        /// \return True if the query ran, false if the shards could not be
+        /// created.
+        public: bool QueryMessagesParallel(
+            const QueryOptions &_options,
+            std::size_t _numShards,
+            const ShardCallback &_callback);
+
         /// \brief Get start time of the log, or in other words the
         /// time of the first message found in the log
         /// \return start time of the log, or zero if the log is not
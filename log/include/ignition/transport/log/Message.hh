@@ -20,6 +20,7 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include <ignition/transport/config.hh>
 #include <ignition/transport/log/Export.hh>
@@ -35,6 +36,7 @@ namespace ignition
       //
       /// \brief Forward Declarations
       class MessagePrivate;
+      class MsgIterPrivate;
 
       /// \brief Represents a message in a bag file.
       class IGNITION_TRANSPORT_LOG_VISIBLE Message
@@ -88,6 +90,25 @@ namespace ignition
         /// \return The time the message was received
         public: const std::chrono::nanoseconds &TimeReceived() const;
 
+        /// \brief Get the message data without copying it.
+        /// \return A view of the raw data for this message. When this message
+        /// comes from a MsgIter, the view is only valid until the iterator is
+        /// advanced or destroyed. Use Data() to keep a copy.
+        public: std::string_view DataView() const;
+
+        /// \brief Get the message type without copying it.
+        /// \return A view of the message type name, with the same lifetime
+        /// as DataView().
+        public: std::string_view TypeView() const;
+
+        /// \brief Get the topic name without copying it.
+        /// \return A view of the topic, with the same lifetime as
+        /// DataView().
+        public: std::string_view TopicView() const;
+
+        // Friendship, so that an iterator can reuse its message for each row
+        friend class MsgIterPrivate;
+
 #ifdef _WIN32
 // Disable warning C4251 which is triggered by
 // std::*
@@ -96,6 +96,24 @@ namespace ignition
         /// \return true if this has a valid log to play back, otherwise false.
         public: bool Valid() const;
 
+        /// \brief Publish the playback time as an ignition::msgs::Clock
+        /// message on the given topic, so that a NetworkClock (using the SIM
+        /// time base) can follow the time of the log. The time is published
+        /// after each message and after each seek or step. This only affects
+        /// the playbacks started after calling this function.
+        /// \param[in] _topic Name of the clock topic. An empty string
+        /// disables the publication of the playback time, which is the
+        /// default.
+        /// \return True if the topic was accepted, false if it is not a
+        /// valid topic name.
+        public: bool SetClockTopic(const std::string &_topic);
+
+        /// \brief Get the topic where the playback time is published.
+        /// \return Name of the clock topic, or an empty string if the
+        /// playback time is not published.
+        /// \sa SetClockTopic()
+        public: const std::string &ClockTopic() const;
+
         /// \brief Add a topic to be played back (exact match only)
         /// \param[in] _topic The exact topic name
         /// \note This method attempts to advertise the topic immediately.
@@ -182,6 +200,21 @@ namespace ignition
         /// \brief Check pause status
         public: bool IsPaused() const;
 
+        /// \brief Set the speed of the playback relative to real time. For
+        /// example, 2.0 plays the log twice as fast as it was recorded and
+        /// 0.5 plays it at half speed. The rate can be changed at any time
+        /// and only applies from that moment on. It has no effect if the
+        /// playback was started without waiting between messages.
+        /// \param[in] _rate Playback rate, between 0.1 and 100.
+        /// \return True if the rate was changed, false if _rate is out of
+        /// range.
+        public: bool SetRate(double _rate);
+
+        /// \brief Get the speed of the playback relative to real time.
+        /// \return The playback rate. The default value is 1.0.
+        /// \sa SetRate()
+        public: double Rate() const;
+
         /// \brief Block until playback runs out of messages to publish
         public: void WaitUntilFinished();
 
@@ -201,6 +234,40 @@ namespace ignition
         /// \return end time of the log, in nanoseconds
         public: std::chrono::nanoseconds EndTime() const;
 
+        /// \brief Get the number of messages published so far by this
+        /// playback.
+        /// \return Number of messages published.
+        public: uint64_t PublishedMessages() const;
+
+        /// \brief Get the number of payload bytes published so far by this
+        /// playback.
+        /// \return Number of bytes published.
+        public: uint64_t PublishedBytes() const;
+
+        /// \brief Get the average publication rate of this playback, measured
+        /// in wall clock time since the playback started. Time spent while
+        /// paused is included.
+        /// \return Messages published per second.
+        public: double PublishRate() const;
+
+        /// \brief Get the mean absolute difference between the wall clock
+        /// time at which each message was scheduled to be published and the
+        /// time at which it was actually published. Only messages that were
+        /// paced (see the _msgWaiting parameter of Playback::Start) are taken
+        /// into account.
+        /// \return Mean publication jitter.
+        public: std::chrono::nanoseconds MeanJitter() const;
+
+        /// \brief Get the largest absolute publication jitter observed.
+        /// \sa MeanJitter()
+        /// \return Maximum publication jitter.
+        public: std::chrono::nanoseconds MaxJitter() const;
+
+        /// \brief Get the number of messages that have been read from the log
+        /// ahead of time and are waiting to be published.
+        /// \return Number of prefetched messages.
+        public: std::size_t PrefetchedMessages() const;
+
         /// \brief Destructor
         public: ~PlaybackHandle();
 
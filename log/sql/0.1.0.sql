@@ -69,3 +69,9 @@ CREATE TABLE messages (
 
 /* Lots of queries are done by time received, so add an index to speed it up */
 CREATE INDEX idx_time_recv ON messages (time_recv);
+
+/* Queries restricted to some topics (e.g. a playback seeking to a given time)
+   jump directly to the requested time of each topic with this index. Logs
+   created before this index existed are still valid 0.1.0 logs:
+   Log::AddTopicTimeIndex() adds the index to them. */
+CREATE INDEX idx_topic_time_recv ON messages (topic_id, time_recv);
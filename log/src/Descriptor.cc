@@ -67,6 +67,12 @@ int64_t Descriptor::TopicId(const std::string &_topicName,
   return typeIter->second;
 }
 
+//////////////////////////////////////////////////
+bool Descriptor::HasTopicTimeIndex() const
+{
+  return this->dataPtr->hasTopicTimeIndex;
+}
+
 //////////////////////////////////////////////////
 Descriptor::~Descriptor()
 {
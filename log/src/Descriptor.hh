@@ -78,6 +78,9 @@ namespace ignition
         /// \param[in] _topics The map of topics that the log contains.
         public: void Reset(const TopicKeyMap &_topics);
 
+        /// \internal \sa Descriptor::HasTopicTimeIndex()
+        public: bool hasTopicTimeIndex = false;
+
 #ifdef _WIN32
 // Disable warning C4251 which is triggered by
 // std::unique_ptr
@@ -17,6 +17,7 @@
 
 #include <sqlite3.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
@@ -24,7 +25,9 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "ignition/transport/log/Descriptor.hh"
 #include "ignition/transport/log/Log.hh"
@@ -48,6 +51,10 @@ class ignition::transport::log::Log::Implementation
   /// \return one of the SQLite error codes
   public: int EndTransactionIfEnoughTimeHasPassed();
 
+  /// \brief End the current transaction, if there is one
+  /// \return one of the SQLite error codes
+  public: int EndTransaction();
+
   /// \brief Begin transaction if one isn't already open
   /// \return one of the SQLite error codes
   public: int BeginTransactionIfNotInOne();
@@ -69,6 +76,17 @@ class ignition::transport::log::Log::Implementation
   /// \return true if the transaction has lasted long enough
   public: bool TimeForNewTransaction() const;
 
+  /// \brief Check whether the log lives in an in-memory database, which
+  /// can not be opened again through its name. This covers ":memory:", ""
+  /// and the "file:...?mode=memory" URIs.
+  /// \return True if the database has no file.
+  public: bool InMemory() const;
+
+  /// \brief Add the (topic, time) index to the log, through another
+  /// connection if the log was opened read only.
+  /// \return True if the log has the index.
+  public: bool AddTopicTimeIndex();
+
   /// \brief SQLite3 database pointer wrapper
   public: std::shared_ptr<raii_sqlite3::Database> db;
 
@@ -159,14 +177,84 @@ const log::Descriptor *Log::Implementation::Descriptor() const
       }
     } while (returnCode == SQLITE_ROW);
 
+    // Check whether the messages are indexed by topic and time received
+    const char *indexSql =
+      "SELECT 1 FROM sqlite_master WHERE type = 'index'"
+      " AND name = 'idx_topic_time_recv';";
+
+    raii_sqlite3::Statement indexStatement(*(this->db), indexSql);
+    if (!indexStatement)
+    {
+      LERR("Failed to compile statement to find the topic index\n");
+      return nullptr;
+    }
+
+    const bool hasTopicTimeIndex =
+        sqlite3_step(indexStatement.Handle()) == SQLITE_ROW;
+    if (!hasTopicTimeIndex)
+    {
+      LDBG("Log has no (topic, time) index, seeking per topic will be slow\n");
+    }
+
     // Save the result into the descriptor
     this->needNewDescriptor = false;
     descriptor.dataPtr->Reset(topicsInLog);
+    descriptor.dataPtr->hasTopicTimeIndex = hasTopicTimeIndex;
   }
 
   return &this->descriptor;
 }
 
+//////////////////////////////////////////////////
+bool Log::Implementation::AddTopicTimeIndex()
+{
+  {
+    raii_sqlite3::Statement statement(*(this->db),
+        "SELECT 1 FROM sqlite_master WHERE type = 'index'"
+        " AND name = 'idx_topic_time_recv';");
+    if (!statement)
+      return false;
+    if (sqlite3_step(statement.Handle()) == SQLITE_ROW)
+      return true;
+  }
+
+  // A log opened read only gets the index through its own connection. An
+  // in-memory database can not be opened again.
+  std::unique_ptr<raii_sqlite3::Database> rwDb;
+  sqlite3 *handle = this->db->Handle();
+  if (sqlite3_db_readonly(handle, "main") == 1)
+  {
+    if (this->InMemory())
+      return false;
+
+    rwDb.reset(new raii_sqlite3::Database(this->filename,
+        SQLITE_OPEN_URI | SQLITE_OPEN_READWRITE));
+    if (!*rwDb)
+      return false;
+    handle = rwDb->Handle();
+  }
+
+  const char *sql = "CREATE INDEX IF NOT EXISTS idx_topic_time_recv"
+    " ON messages (topic_id, time_recv);";
+  LDBG("Adding the (topic, time) index to [" << this->filename << "]\n");
+  if (sqlite3_exec(handle, sql, NULL, 0, NULL) != SQLITE_OK)
+  {
+    LERR("Failed to add the (topic, time) index: "
+         << sqlite3_errmsg(handle) << "\n");
+    return false;
+  }
+
+  this->needNewDescriptor = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Log::Implementation::InMemory() const
+{
+  const char *filename = sqlite3_db_filename(this->db->Handle(), "main");
+  return !filename || filename[0] == '\0';
+}
+
 //////////////////////////////////////////////////
 int Log::Implementation::EndTransactionIfEnoughTimeHasPassed()
 {
@@ -175,6 +263,15 @@ int Log::Implementation::EndTransactionIfEnoughTimeHasPassed()
     return SQLITE_OK;
   }
 
+  return this->EndTransaction();
+}
+
+//////////////////////////////////////////////////
+int Log::Implementation::EndTransaction()
+{
+  if (!this->inTransaction)
+    return SQLITE_OK;
+
   // End the transaction
   int returnCode = sqlite3_exec(
       this->db->Handle(), "END;", NULL, 0, nullptr);
@@ -378,9 +475,10 @@ Log::Log(Log &&_other)  // NOLINT
 //////////////////////////////////////////////////
 Log::~Log()
 {
+  // Commit whatever is pending, closing the database would roll it back
   if (this->dataPtr && this->dataPtr->inTransaction)
   {
-    this->dataPtr->EndTransactionIfEnoughTimeHasPassed();
+    this->dataPtr->EndTransaction();
   }
 }
 
@@ -489,6 +587,15 @@ const log::Descriptor *Log::Descriptor() const
   return this->dataPtr->Descriptor();
 }
 
+//////////////////////////////////////////////////
+bool Log::AddTopicTimeIndex()
+{
+  if (!this->Valid())
+    return false;
+
+  return this->dataPtr->AddTopicTimeIndex();
+}
+
 //////////////////////////////////////////////////
 bool Log::InsertMessage(
     const std::chrono::nanoseconds &_time,
@@ -548,6 +655,145 @@ Batch Log::QueryMessages(const QueryOptions &_options)
   return Batch(std::move(batchPriv));
 }
 
+//////////////////////////////////////////////////
+std::vector<Batch> Log::QueryMessagesSharded(
+    const QueryOptions &_options,
+    std::size_t _numShards)
+{
+  const log::Descriptor *desc = this->Descriptor();
+  if (!desc)
+    return {};
+
+  // Other connections can only see the messages that have been committed
+  if (SQLITE_OK != this->dataPtr->EndTransaction())
+    return {};
+
+  _numShards = std::max<std::size_t>(_numShards, 1u);
+
+  // Find the interval to split, narrowed by the time range of the options.
+  int64_t start = this->StartTime().count();
+  int64_t end = this->EndTime().count();
+  const TimeRangeOption *timeOption =
+      dynamic_cast<const TimeRangeOption *>(&_options);
+  if (timeOption)
+  {
+    const QualifiedTime &beginning = timeOption->TimeRange().Beginning();
+    const QualifiedTime &ending = timeOption->TimeRange().Ending();
+    if (!beginning.IsIndeterminate())
+      start = std::max<int64_t>(start, beginning.GetTime()->count());
+    if (!ending.IsIndeterminate())
+      end = std::min<int64_t>(end, ending.GetTime()->count());
+  }
+
+  // Shard i covers [bounds[i], bounds[i + 1]), except that the first and the
+  // last shards are left open, so that no message can fall outside of them.
+  const uint64_t span = end >= start ?
+      static_cast<uint64_t>(end - start) + 1u : 0u;
+  std::vector<int64_t> bounds;
+  bounds.reserve(_numShards + 1);
+  for (std::size_t i = 0; i <= _numShards; ++i)
+  {
+    bounds.push_back(start + static_cast<int64_t>(
+        (span / _numShards) * i + (span % _numShards) * i / _numShards));
+  }
+
+  const std::vector<SqlStatement> statements =
+      _options.GenerateStatements(*desc);
+
+  const bool inMemory = this->dataPtr->InMemory();
+
+  std::vector<Batch> batches;
+  batches.reserve(_numShards);
+  for (std::size_t i = 0; i < _numShards; ++i)
+  {
+    std::shared_ptr<raii_sqlite3::Database> db = this->dataPtr->db;
+    if (!inMemory)
+    {
+      db = std::make_shared<raii_sqlite3::Database>(
+          this->dataPtr->filename, SQLITE_OPEN_URI | SQLITE_OPEN_READONLY);
+      if (!*db)
+      {
+        LERR("Failed to open shard [" << i << "] of log ["
+             << this->dataPtr->filename << "]\n");
+        return {};
+      }
+    }
+
+    // Restrict every statement to the interval of this shard. SQLite pushes
+    // the condition down into the subquery, so it still uses the indexes.
+    std::vector<SqlStatement> shardStatements;
+    shardStatements.reserve(statements.size());
+    for (const SqlStatement &statement : statements)
+    {
+      std::string inner = statement.statement;
+      const std::size_t last = inner.find_last_not_of(" ;");
+      inner.erase(last == std::string::npos ? 0 : last + 1);
+
+      SqlStatement sql;
+      sql.statement = "SELECT * FROM (" + inner + ") WHERE 1";
+      sql.parameters = statement.parameters;
+      if (i > 0)
+      {
+        sql.statement += " AND time_recv >= ?";
+        sql.parameters.emplace_back(bounds[i]);
+      }
+      if (i + 1 < _numShards)
+      {
+        sql.statement += " AND time_recv < ?";
+        sql.parameters.emplace_back(bounds[i + 1]);
+      }
+      sql.statement += " ORDER BY time_recv;";
+      shardStatements.push_back(std::move(sql));
+    }
+
+    std::unique_ptr<BatchPrivate> batchPriv(
+        new BatchPrivate(db, std::move(shardStatements)));
+    batches.push_back(Batch(std::move(batchPriv)));
+  }
+
+  return batches;
+}
+
+//////////////////////////////////////////////////
+bool Log::QueryMessagesParallel(
+    const QueryOptions &_options,
+    std::size_t _numShards,
+    const ShardCallback &_callback)
+{
+  std::vector<Batch> batches =
+      this->QueryMessagesSharded(_options, _numShards);
+  if (batches.empty())
+    return false;
+
+  // The shards of an in-memory log share its connection, which must not be
+  // used from several threads at once, so they are read one after the other.
+  if (this->dataPtr->InMemory())
+  {
+    for (std::size_t i = 0; i < batches.size(); ++i)
+    {
+      for (const Message &msg : batches[i])
+        _callback(i, msg);
+    }
+    return true;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(batches.size());
+  for (std::size_t i = 0; i < batches.size(); ++i)
+  {
+    workers.emplace_back([&_callback, &batches, i]()
+    {
+      for (const Message &msg : batches[i])
+        _callback(i, msg);
+    });
+  }
+
+  for (std::thread &worker : workers)
+    worker.join();
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 std::chrono::nanoseconds Log::StartTime() const
 {
@@ -65,6 +65,19 @@ TEST(LogCommandAPI, PlaybackFailedToOpen)
     playbackTopics("!@#$%^&*(:;[{]})?/.'|", ".*", 0, "", false));
 }
 
+//////////////////////////////////////////////////
+TEST(LogCommandAPI, ExportBadRegex)
+{
+  EXPECT_EQ(BAD_REGEX, exportTopics(":memory:", "*", ".", 1));
+}
+
+//////////////////////////////////////////////////
+TEST(LogCommandAPI, ExportFailedToOpen)
+{
+  EXPECT_EQ(FAILED_TO_OPEN,
+    exportTopics("!@#$%^&*(:;[{]})?/.'|", ".*", ".", 1));
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -16,9 +16,21 @@
 */
 
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#if __unix__ && __GNUC__ < 8
+  #include <experimental/filesystem>
+#else
+  #include <filesystem>
+#endif
+#include <fstream>
 #include <ios>
+#include <iterator>
+#include <regex>
+#include <set>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "ignition/transport/log/Log.hh"
 #include "ignition/transport/test_config.h"
@@ -29,6 +41,76 @@ using namespace ignition;
 using namespace ignition::transport;
 using namespace std::chrono_literals;
 
+#if __unix__ && __GNUC__ < 8
+  namespace fs = std::experimental::filesystem;
+#else
+  namespace fs = std::filesystem;
+#endif
+
+namespace
+{
+  /// \brief Sets an environment variable and restores its previous value
+  /// when destroyed, even if the test returns early.
+  class ScopedEnv
+  {
+    /// \brief Constructor.
+    /// \param[in] _name Name of the environment variable.
+    /// \param[in] _value Value to set while this object is alive.
+    public: ScopedEnv(const std::string &_name, const std::string &_value)
+      : name(_name)
+    {
+      const char *old = std::getenv(_name.c_str());
+      if (old)
+      {
+        this->hadValue = true;
+        this->oldValue = old;
+      }
+      setenv(this->name.c_str(), _value.c_str(), 1);
+    }
+
+    /// \brief Destructor. Restores the previous value.
+    public: ~ScopedEnv()
+    {
+      if (this->hadValue)
+        setenv(this->name.c_str(), this->oldValue.c_str(), 1);
+      else
+        unsetenv(this->name.c_str());
+    }
+
+    /// \brief Name of the environment variable.
+    private: std::string name;
+
+    /// \brief Previous value of the environment variable.
+    private: std::string oldValue;
+
+    /// \brief Whether the variable was set before.
+    private: bool hadValue = false;
+  };
+
+  /// \brief Creates a unique temporary directory and removes it, with all
+  /// of its contents, when destroyed.
+  class ScopedTempDir
+  {
+    /// \brief Constructor.
+    public: ScopedTempDir()
+      : path(fs::temp_directory_path() /
+             ("ign_transport_log_" + testing::getRandomNumber()))
+    {
+      fs::create_directories(this->path);
+    }
+
+    /// \brief Destructor.
+    public: ~ScopedTempDir()
+    {
+      std::error_code ec;
+      fs::remove_all(this->path, ec);
+    }
+
+    /// \brief Path of the directory.
+    public: const fs::path path;
+  };
+}
+
 //////////////////////////////////////////////////
 TEST(Log, OpenMemoryDatabase)
 {
@@ -137,9 +219,17 @@ TEST(Log, InsertMessageGetMessages)
   auto iter = batch.begin();
   ASSERT_NE(batch.end(), iter);
   EXPECT_EQ(data1, iter->Data());
+  EXPECT_EQ(data1, iter->DataView());
+  EXPECT_EQ("/some/topic/name", iter->TopicView());
+  EXPECT_EQ("some.message.type", iter->TypeView());
+
+  // The iterator reuses the same message for every row
+  const log::Message *first = &(*iter);
   ++iter;
   ASSERT_NE(batch.end(), iter);
+  EXPECT_EQ(first, &(*iter));
   EXPECT_EQ(data2, iter->Data());
+  EXPECT_EQ(data2, iter->DataView());
   ++iter;
   EXPECT_EQ(log::MsgIter(), iter);
 }
@@ -203,6 +293,151 @@ TEST(Log, Insert2Get1MessageByTopic)
   }
 }
 
+//////////////////////////////////////////////////
+TEST(Log, QueryMultipleTopicsInTimeOrder)
+{
+  log::Log logFile;
+  ASSERT_TRUE(logFile.Open(":memory:", std::ios_base::out));
+
+  const log::Descriptor *desc = logFile.Descriptor();
+  ASSERT_NE(nullptr, desc);
+  EXPECT_TRUE(desc->HasTopicTimeIndex());
+
+  // Interleave three topics, with the timestamps as data
+  const std::vector<std::string> topics =
+      {"/topic/a", "/topic/b", "/topic/c"};
+  for (int i = 1; i <= 30; ++i)
+  {
+    const std::string data = std::to_string(i);
+    EXPECT_TRUE(logFile.InsertMessage(
+        std::chrono::seconds(i),
+        topics[i % topics.size()],
+        "some.message.type",
+        reinterpret_cast<const void *>(data.c_str()),
+        data.size()));
+  }
+
+  // Two topics, as a playback restricted to some topics would seek them
+  auto batch = logFile.QueryMessages(log::TopicList(
+      std::set<std::string>{"/topic/a", "/topic/c"},
+      log::QualifiedTimeRange(10s, 20s)));
+
+  std::vector<int> received;
+  std::chrono::nanoseconds lastTime(0);
+  for (const log::Message &msg : batch)
+  {
+    EXPECT_NE("/topic/b", msg.Topic());
+    EXPECT_LE(lastTime, msg.TimeReceived());
+    lastTime = msg.TimeReceived();
+    received.push_back(std::stoi(msg.Data()));
+  }
+
+  const std::vector<int> expected = {11, 12, 14, 15, 17, 18, 20};
+  EXPECT_EQ(expected, received);
+
+  // All of the topics matched by a pattern
+  auto patternBatch = logFile.QueryMessages(log::TopicPattern(
+      std::regex(".*"), log::QualifiedTimeRange(25s, 30s)));
+
+  received.clear();
+  for (const log::Message &msg : patternBatch)
+    received.push_back(std::stoi(msg.Data()));
+
+  const std::vector<int> expectedAll = {25, 26, 27, 28, 29, 30};
+  EXPECT_EQ(expectedAll, received);
+}
+
+//////////////////////////////////////////////////
+TEST(Log, AddTopicTimeIndexToOldLog)
+{
+  const char *envPath = std::getenv(log::SchemaLocationEnvVar.c_str());
+  ASSERT_NE(nullptr, envPath);
+  const std::string oldEnv = envPath;
+
+  // A schema without the (topic, time) index, as it was before the index
+  // was added.
+  std::ifstream fin(testing::portablePathUnion(oldEnv, "0.1.0.sql"));
+  ASSERT_TRUE(fin.good());
+  std::string schema((std::istreambuf_iterator<char>(fin)),
+      std::istreambuf_iterator<char>());
+  const std::string index = "CREATE INDEX idx_topic_time_recv";
+  const auto pos = schema.find(index);
+  ASSERT_NE(std::string::npos, pos);
+  schema.erase(pos, schema.find(';', pos) + 1 - pos);
+
+  // The files are created in a temporary directory that is removed when the
+  // test ends, even if an assertion fails.
+  ScopedTempDir tmpDir;
+  const std::string schemaDir = tmpDir.path.string();
+  const std::string schemaFile =
+      testing::portablePathUnion(schemaDir, "0.1.0.sql");
+  {
+    std::ofstream fout(schemaFile);
+    fout << schema;
+  }
+
+  const std::string path =
+      testing::portablePathUnion(schemaDir, "old_schema.tlog");
+
+  {
+    ScopedEnv env(log::SchemaLocationEnvVar, schemaDir);
+    log::Log logFile;
+    ASSERT_TRUE(logFile.Open(path, std::ios_base::out));
+    const std::string data = "data";
+    EXPECT_TRUE(logFile.InsertMessage(1s, "/topic", "some.message.type",
+        reinterpret_cast<const void *>(data.c_str()), data.size()));
+  }
+  std::remove(schemaFile.c_str());
+
+  // Opening the log read only does not modify it, and the queries still
+  // work without the index.
+  for (int i = 0; i < 2; ++i)
+  {
+    log::Log logFile;
+    ASSERT_TRUE(logFile.Open(path));
+    const log::Descriptor *desc = logFile.Descriptor();
+    ASSERT_NE(nullptr, desc);
+    EXPECT_FALSE(desc->HasTopicTimeIndex());
+
+    int count = 0;
+    for (const log::Message &msg : logFile.QueryMessages(
+          log::TopicList("/topic")))
+    {
+      EXPECT_EQ("data", msg.Data());
+      ++count;
+    }
+    EXPECT_EQ(1, count);
+  }
+
+  // The index is only added on request, even to a log opened read only.
+  {
+    log::Log logFile;
+    EXPECT_FALSE(logFile.AddTopicTimeIndex());
+    ASSERT_TRUE(logFile.Open(path));
+    EXPECT_TRUE(logFile.AddTopicTimeIndex());
+    const log::Descriptor *desc = logFile.Descriptor();
+    ASSERT_NE(nullptr, desc);
+    EXPECT_TRUE(desc->HasTopicTimeIndex());
+
+    int count = 0;
+    for (const log::Message &msg : logFile.QueryMessages(
+          log::TopicList("/topic")))
+    {
+      EXPECT_EQ("data", msg.Data());
+      ++count;
+    }
+    EXPECT_EQ(1, count);
+  }
+
+  {
+    log::Log logFile;
+    ASSERT_TRUE(logFile.Open(path));
+    const log::Descriptor *desc = logFile.Descriptor();
+    ASSERT_NE(nullptr, desc);
+    EXPECT_TRUE(desc->HasTopicTimeIndex());
+  }
+}
+
 //////////////////////////////////////////////////
 TEST(Log, CheckLogTimes)
 {
@@ -240,6 +475,39 @@ TEST(Log, CheckVersion)
   EXPECT_EQ("0.1.0", logFile.Version());
 }
 
+//////////////////////////////////////////////////
+TEST(Log, DestructorCommitsPendingMessages)
+{
+  const std::string path =
+      "destructor_commit_" + testing::getRandomNumber() + ".tlog";
+
+  // The log is destroyed well before its transaction would be committed
+  // because of its age.
+  {
+    log::Log logFile;
+    ASSERT_TRUE(logFile.Open(path, std::ios_base::out));
+    const std::string data = "data";
+    EXPECT_TRUE(logFile.InsertMessage(1s, "/topic", "some.message.type",
+        reinterpret_cast<const void *>(data.c_str()), data.size()));
+    EXPECT_TRUE(logFile.InsertMessage(2s, "/topic", "some.message.type",
+        reinterpret_cast<const void *>(data.c_str()), data.size()));
+  }
+
+  {
+    log::Log logFile;
+    ASSERT_TRUE(logFile.Open(path));
+    int count = 0;
+    for (const log::Message &msg : logFile.QueryMessages())
+    {
+      EXPECT_EQ("data", msg.Data());
+      ++count;
+    }
+    EXPECT_EQ(2, count);
+  }
+
+  std::remove(path.c_str());
+}
+
 //////////////////////////////////////////////////
 TEST(Log, NullDescriptorUnopenedLog)
 {
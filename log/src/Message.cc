@@ -17,36 +17,13 @@
 
 #include <chrono>
 #include <string>
+#include <string_view>
 
 #include "ignition/transport/log/Message.hh"
+#include "MessagePrivate.hh"
 
 using namespace ignition::transport;
 using namespace ignition::transport::log;
-using namespace std::chrono_literals;
-
-class ignition::transport::log::MessagePrivate
-{
-  /// \brief Time received
-  public: std::chrono::nanoseconds timeReceived = 0ns;
-
-  /// \brief pointer to data bytes
-  public: const void *data = nullptr;
-
-  /// \brief Length of data
-  public: std::size_t dataLen = 0;
-
-  /// \brief pointer to topic string
-  public: const char *topic = nullptr;
-
-  /// \brief Length of topic
-  public: std::size_t topicLen = 0;
-
-  /// \brief pointer to message type string
-  public: const char *type = nullptr;
-
-  /// \brief Length of message type
-  public: std::size_t typeLen = 0;
-};
 
 //////////////////////////////////////////////////
 Message::Message()
@@ -61,13 +38,8 @@ Message::Message(const std::chrono::nanoseconds &_timeRecv,
             const char *_topic, std::size_t _topicLen)
   : dataPtr(new MessagePrivate)
 {
-  this->dataPtr->timeReceived = _timeRecv;
-  this->dataPtr->data = _data;
-  this->dataPtr->dataLen = _dataLen;
-  this->dataPtr->type = _type;
-  this->dataPtr->typeLen = _typeLen;
-  this->dataPtr->topic = _topic;
-  this->dataPtr->topicLen = _topicLen;
+  this->dataPtr->Set(_timeRecv, _data, _dataLen, _type, _typeLen,
+      _topic, _topicLen);
 }
 
 //////////////////////////////////////////////////
@@ -99,3 +71,22 @@ const std::chrono::nanoseconds &Message::TimeReceived() const
 {
   return this->dataPtr->timeReceived;
 }
+
+//////////////////////////////////////////////////
+std::string_view Message::DataView() const
+{
+  return std::string_view(reinterpret_cast<const char *>(this->dataPtr->data),
+      this->dataPtr->dataLen);
+}
+
+//////////////////////////////////////////////////
+std::string_view Message::TypeView() const
+{
+  return std::string_view(this->dataPtr->type, this->dataPtr->typeLen);
+}
+
+//////////////////////////////////////////////////
+std::string_view Message::TopicView() const
+{
+  return std::string_view(this->dataPtr->topic, this->dataPtr->topicLen);
+}
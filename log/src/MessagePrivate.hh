@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_TRANSPORT_LOG_MESSAGEPRIVATE_HH_
+#define IGNITION_TRANSPORT_LOG_MESSAGEPRIVATE_HH_
+
+#include <chrono>
+#include <cstddef>
+
+#include "ignition/transport/log/Message.hh"
+
+namespace ignition
+{
+namespace transport
+{
+namespace log
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_TRANSPORT_VERSION_NAMESPACE
+{
+  /// \brief Private implementation of Message. The pointers are borrowed from
+  /// whoever created the message, typically the row of a SQLite statement.
+  class MessagePrivate
+  {
+    /// \brief Point the message at a new set of borrowed fields
+    /// \param[in] _timeRecv time the message was received
+    /// \param[in] _data the serialized message
+    /// \param[in] _dataLen number of bytes in _data
+    /// \param[in] _type the name of the message type
+    /// \param[in] _typeLen the length of _type
+    /// \param[in] _topic the name of the topic the message was published to
+    /// \param[in] _topicLen the length of _topic
+    public: void Set(
+        const std::chrono::nanoseconds &_timeRecv,
+        const void *_data, std::size_t _dataLen,
+        const char *_type, std::size_t _typeLen,
+        const char *_topic, std::size_t _topicLen)
+    {
+      this->timeReceived = _timeRecv;
+      this->data = _data;
+      this->dataLen = _dataLen;
+      this->type = _type;
+      this->typeLen = _typeLen;
+      this->topic = _topic;
+      this->topicLen = _topicLen;
+    }
+
+    /// \brief Time received
+    public: std::chrono::nanoseconds timeReceived{0};
+
+    /// \brief pointer to data bytes
+    public: const void *data = nullptr;
+
+    /// \brief Length of data
+    public: std::size_t dataLen = 0;
+
+    /// \brief pointer to topic string
+    public: const char *topic = nullptr;
+
+    /// \brief Length of topic
+    public: std::size_t topicLen = 0;
+
+    /// \brief pointer to message type string
+    public: const char *type = nullptr;
+
+    /// \brief Length of message type
+    public: std::size_t typeLen = 0;
+  };
+}
+}
+}
+}
+#endif
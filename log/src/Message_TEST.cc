@@ -32,6 +32,9 @@ TEST(Message, DefaultConstructor)
   EXPECT_EQ(std::string(""), msg.Topic());
   EXPECT_EQ(std::string(""), msg.Type());
   EXPECT_EQ(0ns, msg.TimeReceived());
+  EXPECT_TRUE(msg.DataView().empty());
+  EXPECT_TRUE(msg.TopicView().empty());
+  EXPECT_TRUE(msg.TypeView().empty());
 }
 
 //////////////////////////////////////////////////
@@ -51,6 +54,14 @@ TEST(Message, DataConstructor)
   EXPECT_EQ(msgType, msg.Type());
   EXPECT_EQ(topic, msg.Topic());
   EXPECT_EQ(goldenTime, msg.TimeReceived());
+
+  // The views borrow the memory given to the constructor
+  EXPECT_EQ(data, msg.DataView());
+  EXPECT_EQ(data.c_str(), msg.DataView().data());
+  EXPECT_EQ(msgType, msg.TypeView());
+  EXPECT_EQ(msgType.c_str(), msg.TypeView().data());
+  EXPECT_EQ(topic, msg.TopicView());
+  EXPECT_EQ(topic.c_str(), msg.TopicView().data());
 }
 
 //////////////////////////////////////////////////
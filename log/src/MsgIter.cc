@@ -22,6 +22,7 @@
 
 #include "Console.hh"
 #include "ignition/transport/log/MsgIter.hh"
+#include "MessagePrivate.hh"
 #include "MsgIterPrivate.hh"
 #include "raii-sqlite3.hh"
 
@@ -141,11 +142,17 @@ void MsgIterPrivate::StepStatement()
       const void *data = sqlite3_column_blob(this->statement->Handle(), 4);
       std::size_t numData = sqlite3_column_bytes(this->statement->Handle(), 4);
 
-      this->message.reset(new Message(
+      // Reuse the same message for every row, so that stepping through a
+      // batch does not allocate. Its pointers borrow the column memory of
+      // the current row, which sqlite keeps valid until the next step.
+      if (!this->message)
+        this->message.reset(new Message);
+
+      this->message->dataPtr->Set(
             timeRecv,
             data, numData,
             reinterpret_cast<const char*>(type), numType,
-            reinterpret_cast<const char*>(topic), numTopic));
+            reinterpret_cast<const char*>(topic), numTopic);
     }
     else
     {
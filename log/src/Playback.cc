@@ -20,14 +20,20 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdlib>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <ignition/msgs/clock.pb.h>
 
 #include <ignition/transport/Node.hh>
+#include <ignition/transport/TopicUtils.hh>
 #include <ignition/transport/log/Log.hh>
 #include <ignition/transport/log/Playback.hh>
 #include "Console.hh"
@@ -43,6 +49,40 @@ using namespace ignition::transport::log;
 // See: https://www.sqlite.org/threadsafe.html
 static const bool kSqlite3Threadsafe = (sqlite3_threadsafe() != 0);
 
+/// \brief Maximum number of messages that the playback reads ahead of the
+/// message currently being published.
+static const std::size_t kPrefetchCapacity = 256;
+
+/// \brief Maximum number of payload bytes that the playback reads ahead of
+/// the message currently being published. At least one message is always
+/// prefetched, regardless of its size.
+static const std::size_t kPrefetchMaxBytes = 64u * 1024u * 1024u;
+
+/// \brief Slowest playback rate accepted by PlaybackHandle::SetRate()
+static const double kMinPlaybackRate = 0.1;
+
+/// \brief Fastest playback rate accepted by PlaybackHandle::SetRate()
+static const double kMaxPlaybackRate = 100.0;
+
+//////////////////////////////////////////////////
+/// \brief A message that has been read from the log ahead of time and is
+/// waiting to be published. Instances are recycled so that the buffers of
+/// the strings can be reused across messages.
+struct PrefetchedMessage
+{
+  /// \brief Time at which the message was received when it was recorded
+  public: std::chrono::nanoseconds timeReceived{0};
+
+  /// \brief Serialized message
+  public: std::string data;
+
+  /// \brief Message type name
+  public: std::string type;
+
+  /// \brief Publisher that will be used to publish the message
+  public: ignition::transport::Node::Publisher *publisher = nullptr;
+};
+
 //////////////////////////////////////////////////
 /// \brief Private implementation of Playback
 class ignition::transport::log::Playback::Implementation
@@ -97,6 +137,10 @@ class ignition::transport::log::Playback::Implementation
 
   /// \brief The node options.
   public: NodeOptions nodeOptions;
+
+  /// \brief Topic where the playback time is published. Empty if the time
+  /// should not be published.
+  public: std::string clockTopic;
 };
 
 //////////////////////////////////////////////////
@@ -111,12 +155,15 @@ class PlaybackHandle::Implementation
   /// \param[in] _msgWaiting True to wait between publication of
   /// messages based on the message timestamps. False to playback
   /// messages as fast as possible. Default value is true.
+  /// \param[in] _clockTopic Topic where the playback time will be published,
+  /// or an empty string to not publish it.
   public: Implementation(
       const std::shared_ptr<Log> &_logFile,
       const std::unordered_set<std::string> &_topics,
       const std::chrono::nanoseconds &_waitAfterAdvertising,
       const NodeOptions &_nodeOptions,
-      bool _msgWaiting);
+      bool _msgWaiting,
+      const std::string &_clockTopic);
 
   /// \brief Look through the types of data that _topic can publish and create
   /// a publisher for each type.
@@ -133,6 +180,49 @@ class PlaybackHandle::Implementation
   /// \brief Begin playing messages in another thread
   public: void StartPlayback();
 
+  /// \brief Body of the thread that reads messages from the log ahead of
+  /// time and stores them in the prefetch ring.
+  public: void ReadAhead();
+
+  /// \brief Take the next message out of the prefetch ring, blocking until
+  /// one is available.
+  /// \param[out] _msg The message. Its previous buffers are given back to
+  /// the ring so that they can be reused.
+  /// \param[out] _generation The seek generation the message belongs to.
+  /// \return True if a message was taken, false if playback was stopped or
+  /// there are no more messages to play.
+  public: bool NextMessage(PrefetchedMessage &_msg, uint64_t &_generation);
+
+  /// \brief Convert a duration in the playback frame into the duration
+  /// that it takes in the realtime frame, according to the playback rate.
+  /// \param[in] _duration Duration in the playback frame
+  /// \return Duration in the realtime frame
+  public: std::chrono::nanoseconds ToRealtime(
+      const std::chrono::nanoseconds &_duration) const;
+
+  /// \brief Convert a duration in the realtime frame into the duration
+  /// that it covers in the playback frame, according to the playback rate.
+  /// \param[in] _duration Duration in the realtime frame
+  /// \return Duration in the playback frame
+  public: std::chrono::nanoseconds ToPlaybackTime(
+      const std::chrono::nanoseconds &_duration) const;
+
+  /// \brief Change the playback rate
+  /// \param[in] _rate The new rate
+  /// \return True if the rate was changed, false if it is out of range
+  public: bool SetRate(double _rate);
+
+  /// \brief Publish the current playback time on the clock topic, if any
+  public: void PublishClock();
+
+  /// \brief Update the publication statistics after a message has been
+  /// published.
+  /// \param[in] _size Size of the payload that was published.
+  /// \param[in] _jitter Difference between the actual and the scheduled
+  /// publication time, or nullptr if the message was not paced.
+  public: void UpdateStats(std::size_t _size,
+                           const std::chrono::nanoseconds *_jitter);
+
   /// \brief Stop the playback
   public: void Stop();
 
@@ -148,8 +238,8 @@ class PlaybackHandle::Implementation
   /// \brief Puts the calling thread to sleep until a given time is achieved.
   /// \param[in] _targetTime Time at which the wait must finish. Measured in
   /// POSIX time (time since epoch) in nanoseconds
-  /// \return True if the wait ends successfully or false if a pause or
-  /// stop event interrupt it
+  /// \return True if the wait ends successfully or false if a pause, seek,
+  /// rate change or stop event interrupt it
   public: bool WaitUntil(const std::chrono::nanoseconds &_targetTime);
 
   /// \brief Pauses the playback
@@ -202,6 +292,12 @@ class PlaybackHandle::Implementation
   // \brief End time in the playback frame
   public: std::chrono::nanoseconds playbackEndTime;
 
+  /// \brief Protects playbackTime, boundaryTime, nextMessageTime and
+  /// lastEventTime, which are written by the playback thread and by the
+  /// callers of Pause(), Step(), Seek() and SetRate(). When pauseMutex is
+  /// also needed, it is locked first.
+  public: mutable std::mutex timeMutex;
+
   // \brief Current time in the playback frame
   public: std::chrono::nanoseconds playbackTime;
 
@@ -224,6 +320,63 @@ class PlaybackHandle::Implementation
   /// \brief thread running playback
   public: std::thread playbackThread;
 
+  /// \brief thread reading messages from the log ahead of the playback
+  public: std::thread prefetchThread;
+
+  /// \brief Ring of messages that have been read ahead of time
+  public: std::vector<PrefetchedMessage> prefetchRing;
+
+  /// \brief Index of the oldest message in prefetchRing
+  public: std::size_t prefetchHead = 0;
+
+  /// \brief Number of messages stored in prefetchRing
+  public: std::size_t prefetchCount = 0;
+
+  /// \brief Number of payload bytes stored in prefetchRing
+  public: std::size_t prefetchBytes = 0;
+
+  /// \brief True when the prefetch thread has read every message of the
+  /// current generation
+  public: bool prefetchDone = false;
+
+  /// \brief Incremented each time the playback seeks, so that messages read
+  /// before the seek can be discarded.
+  public: std::atomic<uint64_t> prefetchGeneration{0};
+
+  /// \brief Mutex protecting the prefetch ring
+  public: std::mutex prefetchMutex;
+
+  /// \brief Condition variable used to signal changes of the prefetch ring
+  public: std::condition_variable prefetchConditionVariable;
+
+  /// \brief Number of messages published
+  public: std::atomic<uint64_t> publishedMessages{0};
+
+  /// \brief Number of payload bytes published
+  public: std::atomic<uint64_t> publishedBytes{0};
+
+  /// \brief Number of paced messages used to compute the jitter
+  public: std::atomic<uint64_t> jitterSamples{0};
+
+  /// \brief Sum of the absolute jitter of all paced messages
+  public: std::atomic<int64_t> jitterTotal{0};
+
+  /// \brief Largest absolute jitter observed
+  public: std::atomic<int64_t> jitterMax{0};
+
+  /// \brief Wall clock time at which the playback started
+  public: std::chrono::steady_clock::time_point wallStartTime;
+
+  /// \brief Wall clock time at which the playback finished
+  public: std::chrono::steady_clock::time_point wallEndTime;
+
+  /// \brief Speed of the playback relative to real time
+  public: std::atomic<double> rate{1.0};
+
+  /// \brief Publisher of the playback time. Only valid if a clock topic was
+  /// requested.
+  public: ignition::transport::Node::Publisher clockPublisher;
+
   /// \brief log file to play from
   public: std::shared_ptr<Log> logFile;
 
@@ -233,13 +386,15 @@ class PlaybackHandle::Implementation
   /// \brief mutex for thread safety with log file
   public: std::mutex logFileMutex;
 
-  // \brief Set of messages to be played-back
+  // \brief Set of messages to be played-back. Only read by the prefetch
+  // thread, or by Seek while holding batchMutex.
   public: Batch batch;
 
   // \brief Mutex to operate the batch variable in a thread-safe way
   public: std::mutex batchMutex;
 
-  // \brief Iterator to loop over the messages found in batch
+  // \brief Iterator to the next message of batch that the prefetch thread
+  // will read
   public: Batch::iterator messageIter;
 
   // \brief The wall clock time of the first message in batch
@@ -313,7 +468,8 @@ PlaybackHandlePtr Playback::Start(
         new PlaybackHandle(
           std::make_unique<PlaybackHandle::Implementation>(
             this->dataPtr->logFile, topics, _waitAfterAdvertising,
-            this->dataPtr->nodeOptions, _msgWaiting)));
+            this->dataPtr->nodeOptions, _msgWaiting,
+            this->dataPtr->clockTopic)));
 
   // We only need to store this if sqlite3 was not compiled in threadsafe mode.
   if (!kSqlite3Threadsafe)
@@ -328,6 +484,25 @@ bool Playback::Valid() const
   return this->dataPtr->logFile->Valid();
 }
 
+//////////////////////////////////////////////////
+bool Playback::SetClockTopic(const std::string &_topic)
+{
+  if (!_topic.empty() && !TopicUtils::IsValidTopic(_topic))
+  {
+    LERR("Invalid clock topic [" << _topic << "]\n");
+    return false;
+  }
+
+  this->dataPtr->clockTopic = _topic;
+  return true;
+}
+
+//////////////////////////////////////////////////
+const std::string &Playback::ClockTopic() const
+{
+  return this->dataPtr->clockTopic;
+}
+
 //////////////////////////////////////////////////
 bool Playback::AddTopic(const std::string &_topic)
 {
@@ -426,7 +601,8 @@ PlaybackHandle::Implementation::Implementation(
     const std::unordered_set<std::string> &_topics,
     const std::chrono::nanoseconds &_waitAfterAdvertising,
     const NodeOptions &_nodeOptions,
-    bool _msgWaiting)
+    bool _msgWaiting,
+    const std::string &_clockTopic)
   : stop(true),
     finished(false),
     paused(false),
@@ -444,6 +620,14 @@ PlaybackHandle::Implementation::Implementation(
     this->AddTopic(topic);
   }
 
+  if (!_clockTopic.empty())
+  {
+    this->clockPublisher = this->node->Advertise<ignition::msgs::Clock>(
+        _clockTopic);
+    if (!this->clockPublisher)
+      LERR("Failed to advertise clock topic [" << _clockTopic << "]\n");
+  }
+
   std::this_thread::sleep_for(_waitAfterAdvertising);
 
   if (this->batch.begin() == this->batch.end())
@@ -513,22 +697,36 @@ void PlaybackHandle::Implementation::StartPlayback()
 {
   this->stop = false;
 
-  // Set time boundary to infinite, which will get overwritten on a step request
-  this->boundaryTime = std::chrono::nanoseconds::max();
-
-  // Set time in the playback frame equal to the first message in batch
-  // so that it gets played back right after playback starts
   this->playbackStartTime = this->logFile->StartTime();
-  this->playbackTime = this->playbackStartTime;
   this->playbackEndTime = this->logFile->EndTime();
+  this->prefetchRing.resize(kPrefetchCapacity);
+  this->wallStartTime = std::chrono::steady_clock::now();
 
-  this->nextMessageTime = this->messageIter->TimeReceived();
+  {
+    std::lock_guard<std::mutex> lk(this->timeMutex);
 
-  this->lastEventTime = std::chrono::steady_clock::now().time_since_epoch();
+    // Set time boundary to infinite, which will get overwritten on a step
+    // request
+    this->boundaryTime = std::chrono::nanoseconds::max();
+
+    // Set time in the playback frame equal to the first message in batch
+    // so that it gets played back right after playback starts
+    this->playbackTime = this->playbackStartTime;
+    this->nextMessageTime = this->messageIter->TimeReceived();
+    this->lastEventTime = this->wallStartTime.time_since_epoch();
+  }
+
+  // The reading of the log happens in its own thread, so the latency of the
+  // database does not affect the timing of the publications.
+  this->prefetchThread = std::thread([this] () { this->ReadAhead(); });
 
   this->playbackThread = std::thread([this] () mutable
     {
-      while (!this->stop && (this->messageIter != this->batch.end())) {
+      PrefetchedMessage current;
+      uint64_t currentGeneration = 0;
+      bool haveCurrent = false;
+
+      while (!this->stop) {
         // Lock if paused
         if (this->paused)
         {
@@ -536,52 +734,82 @@ void PlaybackHandle::Implementation::StartPlayback()
           // If paused, the thread will be blocked here
           this->pauseConditionVariable.wait(lk,
             [this]{return !this->paused.load();});
+          std::lock_guard<std::mutex> timeLk(this->timeMutex);
           this->lastEventTime =
               std::chrono::steady_clock::now().time_since_epoch();
           // Abort current iteration after coming back from pause
           continue;
         }
+
+        // Discard the message that we were holding if a seek happened.
+        if (haveCurrent && currentGeneration != this->prefetchGeneration)
+          haveCurrent = false;
+
+        if (!haveCurrent)
+        {
+          if (!this->NextMessage(current, currentGeneration))
+            break;
+          haveCurrent = true;
+          std::lock_guard<std::mutex> timeLk(this->timeMutex);
+          this->nextMessageTime = current.timeReceived;
+          continue;
+        }
+
+        // Target time in the realtime frame, computed from a consistent
+        // snapshot of the times.
+        bool stepping;
+        std::chrono::nanoseconds timeToWaitUntil;
+        {
+          std::lock_guard<std::mutex> timeLk(this->timeMutex);
+          stepping = this->nextMessageTime > this->boundaryTime;
+          // The timeDelta becomes the time remaining until next message, or
+          // the step size passed to the step function.
+          const std::chrono::nanoseconds timeDelta(this->ToRealtime(
+              (stepping ? this->boundaryTime : this->nextMessageTime) -
+              this->playbackTime));
+          timeToWaitUntil = this->lastEventTime + timeDelta;
+        }
+
         // If not executing a requested step (regular non-paused playback flow)
-        if (this->nextMessageTime <= this->boundaryTime)
+        if (!stepping)
         {
-          // The timeDelta becomes the time remaining until next message
-          const std::chrono::nanoseconds timeDelta(
-              this->nextMessageTime - this->playbackTime);
-          const std::chrono::nanoseconds timeToWaitUntil(
-              this->lastEventTime + timeDelta);
           // Wait until target time is reached or playback is stopped/paused
           // In the latter case, break the iteration step
           if (this->msgWaiting && !this->WaitUntil(timeToWaitUntil))
           {
             continue;
           }
+
+          if (currentGeneration != this->prefetchGeneration)
+            continue;
+
           // Publish the message
-          {
-          std::unique_lock<std::mutex> lk(this->batchMutex);
           LDBG("publishing\n");
-          this->publishers[
-            this->messageIter->Topic()][
-              this->messageIter->Type()].PublishRaw(
-                this->messageIter->Data(), this->messageIter->Type());
-          // Advance iterator to next message
-          ++this->messageIter;
-          this->playbackTime = this->nextMessageTime;
-          this->lastEventTime =
+          current.publisher->PublishRaw(current.data, current.type);
+          haveCurrent = false;
+
+          const std::chrono::nanoseconds now =
               std::chrono::steady_clock::now().time_since_epoch();
-          this->nextMessageTime = messageIter->TimeReceived();
+          const std::chrono::nanoseconds jitter = now - timeToWaitUntil;
+          this->UpdateStats(current.data.size(),
+              this->msgWaiting ? &jitter : nullptr);
+
+          {
+            std::lock_guard<std::mutex> timeLk(this->timeMutex);
+            // A seek may have moved the time while publishing.
+            if (currentGeneration == this->prefetchGeneration)
+            {
+              this->playbackTime = this->nextMessageTime;
+              this->lastEventTime = now;
+            }
           }
+          this->PublishClock();
         }
         // If a custom step has been requested, always from a paused state,
         // playback gets resumed until the step requested is completed,
         // then goes back to paused.
         else
         {
-          // The timeDelta is equal to the step size passed to the step function
-          const std::chrono::nanoseconds timeDelta(
-              this->boundaryTime - this->playbackTime);
-          // Target time in the realtime frame
-          const std::chrono::nanoseconds timeToWaitUntil(
-              this->lastEventTime + timeDelta);
           // Wait until target time is reached or playback is stopped/paused
           // In the latter case, break the iteration step
           if (!this->WaitUntil(timeToWaitUntil))
@@ -589,26 +817,252 @@ void PlaybackHandle::Implementation::StartPlayback()
             continue;
           }
           this->Pause();
+          this->PublishClock();
         }
       }
-      this->finished = true;
+
+      this->wallEndTime = std::chrono::steady_clock::now();
+      {
+        std::unique_lock<std::mutex> lk(this->prefetchMutex);
+        this->finished = true;
+      }
+      this->prefetchConditionVariable.notify_all();
       this->waitConditionVariable.notify_all();
   });
 }
 
+//////////////////////////////////////////////////
+void PlaybackHandle::Implementation::ReadAhead()
+{
+  PrefetchedMessage staged;
+  std::string topic;
+
+  while (!this->stop && !this->finished)
+  {
+    uint64_t generation;
+    bool exhausted = false;
+
+    // Decode the next message without holding prefetchMutex, so that the
+    // playback thread never waits on the database.
+    {
+      std::unique_lock<std::mutex> lk(this->batchMutex);
+      generation = this->prefetchGeneration;
+
+      if (this->messageIter == this->batch.end())
+      {
+        exhausted = true;
+      }
+      else
+      {
+        // Copy into the buffers of the staged message, which keep their
+        // capacity from one message to the next.
+        const Message &msg = *this->messageIter;
+        staged.timeReceived = msg.TimeReceived();
+        staged.data.assign(msg.DataView());
+        staged.type.assign(msg.TypeView());
+        staged.publisher = nullptr;
+
+        topic.assign(msg.TopicView());
+        auto topicIter = this->publishers.find(topic);
+        if (topicIter != this->publishers.end())
+        {
+          auto typeIter = topicIter->second.find(staged.type);
+          if (typeIter != topicIter->second.end())
+            staged.publisher = &typeIter->second;
+        }
+
+        ++this->messageIter;
+      }
+    }
+
+    std::unique_lock<std::mutex> lk(this->prefetchMutex);
+
+    if (exhausted)
+    {
+      if (generation == this->prefetchGeneration)
+      {
+        this->prefetchDone = true;
+        this->prefetchConditionVariable.notify_all();
+      }
+
+      // Sleep until a seek gives us something new to read.
+      this->prefetchConditionVariable.wait(lk, [this, generation]
+        {
+          return this->stop || this->finished ||
+                 generation != this->prefetchGeneration;
+        });
+      continue;
+    }
+
+    if (!staged.publisher)
+    {
+      LWRN("No publisher available for a message of type ["
+           << staged.type << "]\n");
+      continue;
+    }
+
+    // Block while the ring is full. A single message is always accepted, no
+    // matter how large it is.
+    this->prefetchConditionVariable.wait(lk, [this, generation]
+      {
+        return this->stop || this->finished ||
+               generation != this->prefetchGeneration ||
+               this->prefetchCount == 0 ||
+               (this->prefetchCount < this->prefetchRing.size() &&
+                this->prefetchBytes < kPrefetchMaxBytes);
+      });
+
+    if (this->stop || this->finished ||
+        generation != this->prefetchGeneration)
+    {
+      continue;
+    }
+
+    const std::size_t tail = (this->prefetchHead + this->prefetchCount) %
+        this->prefetchRing.size();
+    std::swap(this->prefetchRing[tail], staged);
+    ++this->prefetchCount;
+    this->prefetchBytes += this->prefetchRing[tail].data.size();
+    this->prefetchConditionVariable.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+bool PlaybackHandle::Implementation::NextMessage(
+    PrefetchedMessage &_msg, uint64_t &_generation)
+{
+  std::unique_lock<std::mutex> lk(this->prefetchMutex);
+  this->prefetchConditionVariable.wait(lk, [this]
+    {
+      return this->stop || this->prefetchCount > 0 || this->prefetchDone;
+    });
+
+  if (this->stop || this->prefetchCount == 0)
+    return false;
+
+  std::swap(_msg, this->prefetchRing[this->prefetchHead]);
+  this->prefetchHead = (this->prefetchHead + 1) % this->prefetchRing.size();
+  --this->prefetchCount;
+  this->prefetchBytes -= _msg.data.size();
+  _generation = this->prefetchGeneration;
+
+  this->prefetchConditionVariable.notify_all();
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds PlaybackHandle::Implementation::ToRealtime(
+    const std::chrono::nanoseconds &_duration) const
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double, std::nano>(_duration) / this->rate.load());
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds PlaybackHandle::Implementation::ToPlaybackTime(
+    const std::chrono::nanoseconds &_duration) const
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double, std::nano>(_duration) * this->rate.load());
+}
+
+//////////////////////////////////////////////////
+bool PlaybackHandle::Implementation::SetRate(double _rate)
+{
+  if (_rate < kMinPlaybackRate || _rate > kMaxPlaybackRate)
+  {
+    LERR("Playback rate [" << _rate << "] is out of range ["
+         << kMinPlaybackRate << ", " << kMaxPlaybackRate << "]\n");
+    return false;
+  }
+
+  {
+    std::unique_lock<std::mutex> lk(this->pauseMutex);
+    std::lock_guard<std::mutex> timeLk(this->timeMutex);
+    if (!this->paused)
+    {
+      // Account for the time that has been played at the old rate, so the
+      // new rate only applies from now on.
+      std::chrono::nanoseconds now(
+          std::chrono::steady_clock::now().time_since_epoch());
+      this->playbackTime = this->playbackTime +
+          this->ToPlaybackTime(now - this->lastEventTime);
+      this->lastEventTime = now;
+    }
+    this->rate = _rate;
+  }
+
+  // Interrupt a pending wait, so it gets recomputed with the new rate.
+  this->stopConditionVariable.notify_all();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void PlaybackHandle::Implementation::PublishClock()
+{
+  if (!this->clockPublisher)
+    return;
+
+  const auto toMsg = [](const std::chrono::nanoseconds &_time,
+                        ignition::msgs::Time *_msg)
+  {
+    const std::chrono::seconds secs =
+        std::chrono::duration_cast<std::chrono::seconds>(_time);
+    _msg->set_sec(secs.count());
+    _msg->set_nsec(static_cast<int32_t>((_time - secs).count()));
+  };
+
+  std::chrono::nanoseconds time;
+  {
+    std::lock_guard<std::mutex> lk(this->timeMutex);
+    time = this->playbackTime;
+  }
+
+  ignition::msgs::Clock msg;
+  toMsg(time, msg.mutable_sim());
+  toMsg(std::chrono::system_clock::now().time_since_epoch(),
+      msg.mutable_system());
+  this->clockPublisher.Publish(msg);
+}
+
+//////////////////////////////////////////////////
+void PlaybackHandle::Implementation::UpdateStats(
+    std::size_t _size, const std::chrono::nanoseconds *_jitter)
+{
+  ++this->publishedMessages;
+  this->publishedBytes += _size;
+
+  if (!_jitter)
+    return;
+
+  const int64_t jitter = std::abs(_jitter->count());
+  ++this->jitterSamples;
+  this->jitterTotal += jitter;
+
+  int64_t max = this->jitterMax.load();
+  while (jitter > max && !this->jitterMax.compare_exchange_weak(max, jitter))
+  {
+  }
+}
+
 //////////////////////////////////////////////////
 bool PlaybackHandle::Implementation::WaitUntil(
     const std::chrono::nanoseconds &_targetTime)
 {
   const auto waitStartTime =
     std::chrono::steady_clock::now().time_since_epoch();
+  const uint64_t seekGeneration = this->prefetchGeneration;
+  const double waitRate = this->rate;
 
   // Lambda used as predicate below to check for spurious wake-ups
-  auto FinishedWaiting = [this, &_targetTime]() -> bool
+  auto FinishedWaiting =
+      [this, &_targetTime, seekGeneration, waitRate]() -> bool
   {
     const auto now =
       std::chrono::steady_clock::now().time_since_epoch();
-    return _targetTime <= now || this->stop || this->paused;
+    return _targetTime <= now || this->stop || this->paused ||
+           seekGeneration != this->prefetchGeneration ||
+           waitRate != this->rate;
   };
 
   // Passing a lock to wait_for is just a formality (we don't actually
@@ -643,7 +1097,10 @@ void PlaybackHandle::Implementation::Step(
     const std::chrono::nanoseconds &_stepDuration)
 {
   if (_stepDuration.count() == 0) return;
-  this->boundaryTime = this->playbackTime + _stepDuration;
+  {
+    std::lock_guard<std::mutex> lk(this->timeMutex);
+    this->boundaryTime = this->playbackTime + _stepDuration;
+  }
   this->Resume();
 }
 
@@ -659,16 +1116,35 @@ void PlaybackHandle::Implementation::Seek(
   const QualifiedTime beginTime(this->firstMessageTime + _newElapsedTime);
   const QualifiedTime endTime(std::chrono::nanoseconds::max());
   const QualifiedTimeRange timeRange(beginTime, endTime);
+  std::chrono::nanoseconds newTime;
   {
     std::unique_lock<std::mutex> lk(this->batchMutex);
     this->batch = this->logFile->QueryMessages(
         TopicList::Create(this->trackedTopics, timeRange));
     this->messageIter = this->batch.begin();
+    newTime = this->messageIter->TimeReceived();
+
+    // Drop everything that was read ahead before the seek. This happens while
+    // batchMutex is still locked so the prefetch thread cannot store a message
+    // from the old batch under the new generation.
+    std::unique_lock<std::mutex> prefetchLk(this->prefetchMutex);
+    ++this->prefetchGeneration;
+    this->prefetchHead = 0;
+    this->prefetchCount = 0;
+    this->prefetchBytes = 0;
+    this->prefetchDone = false;
+  }
+  this->prefetchConditionVariable.notify_all();
+
+  {
+    std::lock_guard<std::mutex> lk(this->timeMutex);
+    this->playbackTime = newTime;
+    this->nextMessageTime = newTime;
+    this->boundaryTime = std::chrono::nanoseconds::max();
+    this->lastEventTime = std::chrono::steady_clock::now().time_since_epoch();
   }
-  this->playbackTime = this->messageIter->TimeReceived();
-  this->nextMessageTime = this->messageIter->TimeReceived();
-  this->boundaryTime = std::chrono::nanoseconds::max();
-  this->lastEventTime = std::chrono::steady_clock::now().time_since_epoch();
+  this->stopConditionVariable.notify_all();
+  this->PublishClock();
 }
 
 //////////////////////////////////////////////////
@@ -679,8 +1155,12 @@ void PlaybackHandle::Implementation::Stop()
     return;
   }
 
-  this->stop = true;
+  {
+    std::unique_lock<std::mutex> lk(this->prefetchMutex);
+    this->stop = true;
+  }
   this->stopConditionVariable.notify_all();
+  this->prefetchConditionVariable.notify_all();
 
   if (this->paused)
   {
@@ -691,6 +1171,9 @@ void PlaybackHandle::Implementation::Stop()
 
   if (this->playbackThread.joinable())
     this->playbackThread.join();
+
+  if (this->prefetchThread.joinable())
+    this->prefetchThread.join();
 }
 
 //////////////////////////////////////////////////
@@ -699,12 +1182,13 @@ void PlaybackHandle::Implementation::Pause()
   std::unique_lock<std::mutex> lk(this->pauseMutex);
   if (!this->paused)
   {
+    std::lock_guard<std::mutex> timeLk(this->timeMutex);
     this->paused = true;
     std::chrono::nanoseconds now(
         std::chrono::steady_clock::now().time_since_epoch());
     // Advance time in the playback frame to the moment when pause started
     this->playbackTime = this->playbackTime +
-        now - this->lastEventTime;
+        this->ToPlaybackTime(now - this->lastEventTime);
     // Update last event time in the realtime frame.
     this->lastEventTime = now;
     this->boundaryTime = std::chrono::nanoseconds::max();
@@ -794,6 +1278,7 @@ std::chrono::nanoseconds PlaybackHandle::StartTime() const
 //////////////////////////////////////////////////
 std::chrono::nanoseconds PlaybackHandle::CurrentTime() const
 {
+  std::lock_guard<std::mutex> lk(this->dataPtr->timeMutex);
   return this->dataPtr->playbackTime;
 }
 
@@ -803,6 +1288,69 @@ std::chrono::nanoseconds PlaybackHandle::EndTime() const
   return this->dataPtr->playbackEndTime;
 }
 
+//////////////////////////////////////////////////
+bool PlaybackHandle::SetRate(double _rate)
+{
+  return this->dataPtr->SetRate(_rate);
+}
+
+//////////////////////////////////////////////////
+double PlaybackHandle::Rate() const
+{
+  return this->dataPtr->rate;
+}
+
+//////////////////////////////////////////////////
+uint64_t PlaybackHandle::PublishedMessages() const
+{
+  return this->dataPtr->publishedMessages;
+}
+
+//////////////////////////////////////////////////
+uint64_t PlaybackHandle::PublishedBytes() const
+{
+  return this->dataPtr->publishedBytes;
+}
+
+//////////////////////////////////////////////////
+double PlaybackHandle::PublishRate() const
+{
+  const auto end = this->dataPtr->finished ?
+      this->dataPtr->wallEndTime : std::chrono::steady_clock::now();
+  const std::chrono::duration<double> elapsed =
+      end - this->dataPtr->wallStartTime;
+
+  if (elapsed.count() <= 0)
+    return 0;
+
+  return static_cast<double>(this->dataPtr->publishedMessages) /
+      elapsed.count();
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds PlaybackHandle::MeanJitter() const
+{
+  const uint64_t samples = this->dataPtr->jitterSamples;
+  if (samples == 0)
+    return std::chrono::nanoseconds::zero();
+
+  return std::chrono::nanoseconds(
+      this->dataPtr->jitterTotal / static_cast<int64_t>(samples));
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds PlaybackHandle::MaxJitter() const
+{
+  return std::chrono::nanoseconds(this->dataPtr->jitterMax);
+}
+
+//////////////////////////////////////////////////
+std::size_t PlaybackHandle::PrefetchedMessages() const
+{
+  std::unique_lock<std::mutex> lk(this->dataPtr->prefetchMutex);
+  return this->dataPtr->prefetchCount;
+}
+
 //////////////////////////////////////////////////
 PlaybackHandle::PlaybackHandle(
   std::unique_ptr<Implementation> &&_internal) // NOLINT
@@ -31,6 +31,22 @@ TEST(Playback, PlaybackEmptyDatabase)
   EXPECT_EQ(nullptr, playback.Start());
 }
 
+//////////////////////////////////////////////////
+TEST(Playback, ClockTopic)
+{
+  log::Playback playback(":memory:");
+  EXPECT_TRUE(playback.ClockTopic().empty());
+
+  EXPECT_TRUE(playback.SetClockTopic("/clock"));
+  EXPECT_EQ("/clock", playback.ClockTopic());
+
+  EXPECT_FALSE(playback.SetClockTopic("invalid topic"));
+  EXPECT_EQ("/clock", playback.ClockTopic());
+
+  EXPECT_TRUE(playback.SetClockTopic(""));
+  EXPECT_TRUE(playback.ClockTopic().empty());
+}
+
 
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
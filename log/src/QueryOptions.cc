@@ -15,6 +15,7 @@
  *
 */
 
+#include <cstddef>
 #include <cstdint>
 #include <regex>
 #include <set>
@@ -53,6 +54,78 @@ static void AppendTopicListClause(
   _sql.statement += ")";
 }
 
+//////////////////////////////////////////////////
+/// \brief Largest number of topic IDs for which a topic-restricted query is
+/// split into one SELECT per topic. SQLite limits the number of terms of a
+/// compound SELECT (500 by default), so keep well below that.
+static constexpr std::size_t kMaxMergedTopics = 64;
+
+//////////////////////////////////////////////////
+/// \brief Generate the complete statement for a query restricted to a set of
+/// Topic IDs and, optionally, a time range.
+///
+/// A single "topic_id IN (...) ORDER BY time_recv" query cannot use the
+/// (topic_id, time_recv) index without sorting every matching row, so SQLite
+/// scans the time index instead and filters the topics, which is slow when
+/// seeking into a large log. When the index exists, each topic gets its own
+/// SELECT, which jumps straight to the requested time, and the branches are
+/// merged in time order by a UNION ALL.
+/// \param[in] _descriptor Descriptor of the log that will be queried
+/// \param[in] _ids The Topic IDs to include in the query
+/// \param[in] _timeCondition Time range condition, may be empty
+/// \return The complete statement, including its closing clause
+static SqlStatement GenerateTopicListStatement(
+    const Descriptor &_descriptor,
+    const std::vector<int64_t> &_ids,
+    const SqlStatement &_timeCondition)
+{
+  const auto appendTimeCondition = [&](SqlStatement &_sql)
+  {
+    if (!_timeCondition.statement.empty())
+    {
+      _sql.statement += " AND (";
+      _sql.Append(_timeCondition);
+      _sql.statement += ")";
+    }
+  };
+
+  if (_ids.size() > 1 && _ids.size() <= kMaxMergedTopics &&
+      _descriptor.HasTopicTimeIndex())
+  {
+    SqlStatement sql;
+    for (const int64_t id : _ids)
+    {
+      if (!sql.statement.empty())
+        sql.statement += " UNION ALL ";
+
+      sql.Append(QueryOptions::StandardMessageQueryPreamble());
+      sql.statement += " WHERE (topic_id = ?)";
+      sql.parameters.emplace_back(id);
+      appendTimeCondition(sql);
+    }
+
+    // The ORDER BY of a compound SELECT can only refer to its result columns
+    sql.statement += " ORDER BY time_recv;";
+    return sql;
+  }
+
+  SqlStatement sql = QueryOptions::StandardMessageQueryPreamble();
+  sql.statement += " WHERE (";
+
+  // With a single topic the (topic_id, time_recv) index already returns the
+  // rows in time order. Otherwise the unary "+" prevents SQLite from using
+  // it, so that the rows are read in order from the time index.
+  if (_ids.size() > 1)
+    sql.statement += "+";
+
+  AppendTopicListClause(sql, _ids);
+  sql.statement += ")";
+  appendTimeCondition(sql);
+  sql.Append(QueryOptions::StandardMessageQueryClose());
+
+  return sql;
+}
+
 //////////////////////////////////////////////////
 SqlStatement QueryOptions::StandardMessageQueryPreamble()
 {
@@ -181,11 +254,11 @@ TimeRangeOption::~TimeRangeOption()
 //////////////////////////////////////////////////
 class TopicList::Implementation
 {
-  /// \brief Generate a WHERE clause for topics that exist in the requested list
+  /// \brief Find the IDs of the topics that exist in the requested list
   /// \param[in] _descriptor The descriptor forwarded by the interface class
-  /// \return The desired WHERE clause
-  public: SqlStatement GenerateStatement(
-    const Descriptor &_descriptor)
+  /// \return The IDs of the requested topics
+  public: std::vector<int64_t> TopicIds(
+    const Descriptor &_descriptor) const
   {
     const Descriptor::NameToMap &map = _descriptor.TopicsToMsgTypesToId();
     std::vector<int64_t> rowIDs;
@@ -203,12 +276,7 @@ class TopicList::Implementation
       }
     }
 
-    SqlStatement sql = QueryOptions::StandardMessageQueryPreamble();
-    sql.statement += " WHERE (";
-    AppendTopicListClause(sql, rowIDs);
-    sql.statement += ")";
-
-    return sql;
+    return rowIDs;
   }
 
   /// \brief Topics for this option
@@ -266,20 +334,8 @@ const std::set<std::string> &TopicList::Topics() const
 std::vector<SqlStatement> TopicList::GenerateStatements(
     const Descriptor &_descriptor) const
 {
-  SqlStatement sql = this->dataPtr->GenerateStatement(_descriptor);
-
-  // Add the time range condition
-  const SqlStatement &timeCondition = this->GenerateTimeConditions();
-  if (!timeCondition.statement.empty())
-  {
-    sql.statement += " AND (";
-    sql.Append(timeCondition);
-    sql.statement += ")";
-  }
-
-  sql.Append(QueryOptions::StandardMessageQueryClose());
-
-  return {sql};
+  return {GenerateTopicListStatement(_descriptor,
+      this->dataPtr->TopicIds(_descriptor), this->GenerateTimeConditions())};
 }
 
 //////////////////////////////////////////////////
@@ -291,11 +347,11 @@ TopicList::~TopicList()
 //////////////////////////////////////////////////
 class TopicPattern::Implementation
 {
-  /// \brief Generate a WHERE clause for topics that match the requested pattern
+  /// \brief Find the IDs of the topics that match the requested pattern
   /// \param[in] _descriptor The descriptor forwarded by the interface class
-  /// \return The desired WHERE clause
-  public: SqlStatement GenerateStatement(
-      const Descriptor &_descriptor)
+  /// \return The IDs of the matching topics
+  public: std::vector<int64_t> TopicIds(
+      const Descriptor &_descriptor) const
   {
     const Descriptor::NameToMap &map = _descriptor.TopicsToMsgTypesToId();
     std::vector<int64_t> rowIDs;
@@ -315,12 +371,7 @@ class TopicPattern::Implementation
       }
     }
 
-    SqlStatement sql = QueryOptions::StandardMessageQueryPreamble();
-    sql.statement += " WHERE (";
-    AppendTopicListClause(sql, rowIDs);
-    sql.statement += ")";
-
-    return sql;
+    return rowIDs;
   }
 
   /// \brief Pattern for this option
@@ -370,20 +421,8 @@ const std::regex &TopicPattern::Pattern() const
 std::vector<SqlStatement> TopicPattern::GenerateStatements(
     const Descriptor &_descriptor) const
 {
-  SqlStatement sql = this->dataPtr->GenerateStatement(_descriptor);
-
-  // Add the time range condition
-  const SqlStatement &timeCondition = this->GenerateTimeConditions();
-  if (!timeCondition.statement.empty())
-  {
-    sql.statement += " AND (";
-    sql.Append(timeCondition);
-    sql.statement += ")";
-  }
-
-  sql.Append(QueryOptions::StandardMessageQueryClose());
-
-  return {sql};
+  return {GenerateTopicListStatement(_descriptor,
+      this->dataPtr->TopicIds(_descriptor), this->GenerateTimeConditions())};
 }
 
 //////////////////////////////////////////////////
@@ -15,11 +15,22 @@
  *
 */
 
+#include <algorithm>
+#include <atomic>
 #include <csignal>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <regex>
+#include <string>
+#include <string_view>
+#include <thread>
 
 #include <ignition/transport/log/Export.hh>
+#include <ignition/transport/log/Log.hh>
 #include <ignition/transport/log/Playback.hh>
 #include <ignition/transport/log/Recorder.hh>
 #include <ignition/transport/Node.hh>
@@ -135,3 +146,97 @@ int playbackTopics(const char *_file, const char *_pattern, const int _wait_ms,
   LDBG("Shutting down\n");
   return SUCCESS;
 }
+
+//////////////////////////////////////////////////
+int exportTopics(const char *_file, const char *_pattern, const char *_dir,
+  int _jobs)
+{
+  std::regex regexPattern;
+  try
+  {
+    regexPattern = _pattern;
+  }
+  catch (const std::regex_error &e)
+  {
+    LERR("Regex pattern is invalid\n");
+    return BAD_REGEX;
+  }
+
+  transport::log::Log input;
+  if (!input.Open(_file, std::ios_base::in))
+    return FAILED_TO_OPEN;
+
+  const transport::log::Descriptor *desc = input.Descriptor();
+  if (!desc)
+    return FAILED_TO_OPEN;
+
+  // Each output log is written by whichever shard thread reads its messages
+  struct Output
+  {
+    std::mutex mutex;
+    transport::log::Log log;
+  };
+  std::map<std::string, std::unique_ptr<Output>, std::less<>> outputs;
+
+  const std::string dir(_dir);
+  for (const auto &topicEntry : desc->TopicsToMsgTypesToId())
+  {
+    const std::string &topic = topicEntry.first;
+    if (!std::regex_match(topic, regexPattern))
+      continue;
+
+    std::string name = topic;
+    std::replace(name.begin(), name.end(), '/', '_');
+    const std::string path = dir + "/" + name + ".tlog";
+
+    if (std::ifstream(path).good())
+    {
+      LERR("Refusing to overwrite [" << path << "]\n");
+      return FAILED_TO_EXPORT;
+    }
+
+    std::unique_ptr<Output> output(new Output);
+    if (!output->log.Open(path, std::ios_base::out))
+    {
+      LERR("Failed to create [" << path << "]\n");
+      return FAILED_TO_EXPORT;
+    }
+
+    LDBG("Exporting [" << topic << "] to [" << path << "]\n");
+    outputs.emplace(topic, std::move(output));
+  }
+
+  if (outputs.empty())
+  {
+    LWRN("No topic matches the pattern\n");
+    return SUCCESS;
+  }
+
+  std::size_t jobs = _jobs > 0 ?
+      static_cast<std::size_t>(_jobs) : std::thread::hardware_concurrency();
+
+  std::atomic<bool> inserted{true};
+  const bool queried = input.QueryMessagesParallel(
+      transport::log::TopicPattern(regexPattern), jobs,
+      [&](std::size_t, const transport::log::Message &_msg)
+      {
+        auto it = outputs.find(_msg.TopicView());
+        if (it == outputs.end())
+          return;
+
+        Output &output = *it->second;
+        const std::string_view data = _msg.DataView();
+
+        std::lock_guard<std::mutex> lk(output.mutex);
+        if (!output.log.InsertMessage(_msg.TimeReceived(), it->first,
+              std::string(_msg.TypeView()), data.data(), data.size()))
+        {
+          inserted = false;
+        }
+      });
+
+  if (!queried || !inserted)
+    return FAILED_TO_EXPORT;
+
+  return SUCCESS;
+}
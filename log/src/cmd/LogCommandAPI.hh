@@ -27,6 +27,7 @@ extern "C"
     FAILED_TO_SUBSCRIBE = 4,
     INVALID_VERSION     = 5,
     INVALID_REMAP       = 6,
+    FAILED_TO_EXPORT    = 7,
   };
 
   /// \brief Sets verbosity of library
@@ -52,4 +53,19 @@ extern "C"
     const int _wait_ms,
     const char *_remap,
     int _fast);
+
+  /// \brief Export each topic whose name matches the given pattern to its
+  /// own log file. The input log is read by several threads in parallel.
+  /// \param[in] _file Path to the log file to read
+  /// \param[in] _pattern ECMAScript regular expression to match against topics
+  /// \param[in] _dir Directory where the log file of each topic is written.
+  /// The file name is the topic name, with '/' replaced by '_', followed by
+  /// ".tlog". Existing files are not overwritten.
+  /// \param[in] _jobs Number of threads that read the input log. Set to 0 to
+  /// use one thread per hardware core.
+  int IGNITION_TRANSPORT_LOG_VISIBLE exportTopics(
+    const char *_file,
+    const char *_pattern,
+    const char *_dir,
+    int _jobs);
 }
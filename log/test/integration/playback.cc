@@ -20,6 +20,7 @@
 #include <ignition/transport/log/Log.hh>
 #include <ignition/transport/log/Playback.hh>
 #include <ignition/transport/log/Recorder.hh>
+#include <ignition/transport/Clock.hh>
 #include <ignition/transport/Node.hh>
 
 #include "ChirpParams.hh"
@@ -166,6 +167,14 @@ TEST(playback, ReplayLog)
 #endif
   EXPECT_EQ(handle->EndTime(), handle->CurrentTime());
 
+  // Every message must have gone through the prefetch ring and be accounted
+  // for in the statistics.
+  EXPECT_EQ(originalData.size(), handle->PublishedMessages());
+  EXPECT_LT(0u, handle->PublishedBytes());
+  EXPECT_LT(0.0, handle->PublishRate());
+  EXPECT_EQ(0u, handle->PrefetchedMessages());
+  EXPECT_LE(handle->MeanJitter(), handle->MaxJitter());
+
   // Wait to make sure our callbacks are done processing the incoming messages
   // (Strangely, Windows throws an exception when this is ~1s or more)
   std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -792,6 +801,89 @@ TEST(playback, ReplaySeek)
   std::this_thread::sleep_for(std::chrono::milliseconds(100));
 }
 
+//////////////////////////////////////////////////
+/// \brief Play a log faster than real time while publishing the playback
+/// time, and verify that a NetworkClock follows the log.
+TEST(playback, ReplayRateAndClock)
+{
+  std::vector<std::string> topics = {"/foo", "/bar", "/baz"};
+
+  std::vector<MessageInformation> incomingData;
+
+  auto callback = [&incomingData](
+      const char *_data,
+      std::size_t _len,
+      const ignition::transport::MessageInfo &_msgInfo)
+  {
+    TrackMessages(incomingData, _data, _len, _msgInfo);
+  };
+
+  ignition::transport::Node node;
+  ignition::transport::log::Recorder recorder;
+
+  for (const std::string &topic : topics)
+  {
+    node.SubscribeRaw(topic, callback);
+    recorder.AddTopic(topic);
+  }
+
+  const std::string logName =
+    "file:playbackReplayRate?mode=memory&cache=shared";
+  EXPECT_EQ(ignition::transport::log::RecorderError::SUCCESS,
+    recorder.Start(logName));
+
+  const int numChirps = 100;
+  testing::forkHandlerType chirper =
+    ignition::transport::log::test::BeginChirps(topics, numChirps, partition);
+
+  // Wait for the chirping to finish
+  testing::waitAndCleanupFork(chirper);
+
+  // Wait to make sure our callbacks are done processing the incoming messages
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+
+  // Create playback before stopping so sqlite memory database is shared
+  ignition::transport::log::Playback playback(logName);
+  recorder.Stop();
+
+  std::vector<MessageInformation> originalData = incomingData;
+  incomingData.clear();
+
+  for (const std::string &topic : topics)
+  {
+    playback.AddTopic(topic);
+  }
+  EXPECT_TRUE(playback.SetClockTopic("/playback_clock"));
+
+  ignition::transport::NetworkClock clock("/playback_clock");
+
+  const auto handle = playback.Start();
+  ASSERT_NE(nullptr, handle);
+  EXPECT_DOUBLE_EQ(1.0, handle->Rate());
+  EXPECT_FALSE(handle->SetRate(0.0));
+  EXPECT_FALSE(handle->SetRate(1000.0));
+  EXPECT_TRUE(handle->SetRate(4.0));
+  EXPECT_DOUBLE_EQ(4.0, handle->Rate());
+
+  const auto wallStart = std::chrono::steady_clock::now();
+  handle->WaitUntilFinished();
+  const auto wallDuration = std::chrono::steady_clock::now() - wallStart;
+  handle->Stop();
+
+  const std::chrono::nanoseconds logDuration =
+    handle->EndTime() - handle->StartTime();
+
+  // Playing at 4x must take clearly less than the duration of the log.
+  EXPECT_LT(wallDuration, logDuration / 2);
+  EXPECT_EQ(handle->EndTime(), handle->CurrentTime());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  EXPECT_TRUE(clock.IsReady());
+  EXPECT_EQ(handle->EndTime(), clock.Time());
+  EXPECT_TRUE(ExpectSameMessages(originalData, incomingData));
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -16,8 +16,12 @@
 */
 
 #include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
 #include <regex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "ignition/transport/log/Log.hh"
@@ -490,6 +494,116 @@ TEST(QueryMessages, QueryTopicListBeforeInclusive)
   EXPECT_EQ(5u, num_msgs);
 }
 
+//////////////////////////////////////////////////
+TEST(QueryMessages, QuerySharded)
+{
+  log::Log logFile;
+  ASSERT_TRUE(logFile.Open(
+      "file:querySharded?mode=memory&cache=shared", std::ios_base::out));
+
+  auto testMessages = StandardTestMessages();
+  InsertMessages(logFile, testMessages);
+
+  // Reading the shards in order gives the same result as a single batch
+  std::vector<log::Batch> batches =
+      logFile.QueryMessagesSharded(log::AllTopics(), 3);
+  ASSERT_EQ(3u, batches.size());
+
+  std::size_t num_msgs = 0;
+  auto goldenIter = testMessages.begin();
+  for (log::Batch &batch : batches)
+  {
+    for (const log::Message &msg : batch)
+    {
+      ASSERT_NE(testMessages.end(), goldenIter);
+      CheckEquality(*goldenIter, msg);
+      ++goldenIter;
+      ++num_msgs;
+    }
+  }
+  EXPECT_EQ(testMessages.size(), num_msgs);
+
+  // The time range of the options still applies
+  log::QualifiedTime beginTime(2s, log::QualifiedTime::Qualifier::INCLUSIVE);
+  batches = logFile.QueryMessagesSharded(log::TopicList(
+        "/topic/one", log::QualifiedTimeRange::From(beginTime)), 4);
+  ASSERT_EQ(4u, batches.size());
+
+  num_msgs = 0;
+  goldenIter = testMessages.begin() + 3;
+  for (log::Batch &batch : batches)
+  {
+    for (const log::Message &msg : batch)
+    {
+      while (goldenIter != testMessages.end() &&
+             goldenIter->topic != "/topic/one")
+      {
+        ++goldenIter;
+      }
+      ASSERT_NE(testMessages.end(), goldenIter);
+      CheckEquality(*goldenIter, msg);
+      ++goldenIter;
+      ++num_msgs;
+    }
+  }
+  EXPECT_EQ(4u, num_msgs);
+}
+
+//////////////////////////////////////////////////
+TEST(QueryMessages, QueryParallel)
+{
+  // The file is created in the working directory of the test.
+  const std::string file = "queryParallel.tlog";
+  std::remove(file.c_str());
+
+  for (const std::string &name :
+      {std::string(":memory:"),
+       std::string("file:queryParallel?mode=memory&cache=shared"),
+       file})
+  {
+    const bool inMemory = name != file;
+    log::Log logFile;
+    ASSERT_TRUE(logFile.Open(name, std::ios_base::out));
+
+    auto testMessages = StandardTestMessages();
+    InsertMessages(logFile, testMessages);
+
+    // The shards of an in-memory log share its connection, so they are read
+    // sequentially from this thread.
+    std::mutex mutex;
+    std::map<std::size_t, std::vector<std::chrono::nanoseconds>> times;
+    std::size_t lastShard = 0;
+    const std::thread::id caller = std::this_thread::get_id();
+    EXPECT_TRUE(logFile.QueryMessagesParallel(log::AllTopics(), 4,
+        [&](std::size_t _shard, const log::Message &_msg)
+        {
+          std::lock_guard<std::mutex> lk(mutex);
+          if (inMemory)
+          {
+            EXPECT_EQ(caller, std::this_thread::get_id());
+            EXPECT_LE(lastShard, _shard);
+          }
+          lastShard = _shard;
+          times[_shard].push_back(_msg.TimeReceived());
+        }));
+
+    // Every message was delivered once, in time order within its shard, and
+    // the shards cover consecutive intervals.
+    std::vector<std::chrono::nanoseconds> allTimes;
+    for (const auto &shard : times)
+    {
+      EXPECT_LT(shard.first, 4u);
+      allTimes.insert(allTimes.end(), shard.second.begin(), shard.second.end());
+    }
+
+    ASSERT_EQ(testMessages.size(), allTimes.size());
+    for (std::size_t i = 0; i < testMessages.size(); ++i)
+      EXPECT_EQ(testMessages[i].time, allTimes[i]);
+  }
+
+  std::remove(file.c_str());
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
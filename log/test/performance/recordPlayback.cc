@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+/// \file recordPlayback.cc
+/// \brief Benchmarks of the log component: writing messages to a log file,
+/// reading them back and playing them back as fast as possible.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "ignition/transport/log/Log.hh"
+#include "ignition/transport/log/Playback.hh"
+
+using namespace ignition::transport;
+
+/// \brief Topic of the logged messages.
+static const std::string kTopic = "/bench/log";  // NOLINT(*)
+
+/// \brief Type of the logged messages. The payload is not parsed by any of
+/// the benchmarks, so it does not need to match.
+static const std::string kType = "ign_msgs.Bytes";  // NOLINT(*)
+
+/// \brief Approximate number of payload bytes in the logs used by the query
+/// and playback benchmarks.
+static const int64_t kLogBytes = 64 << 20;
+
+/// \brief Maximum number of messages in the logs used by the query and
+/// playback benchmarks.
+static const int64_t kMaxLogMessages = 20000;
+
+//////////////////////////////////////////////////
+/// \brief Path of a log file used by a benchmark. The file is removed when
+/// this goes out of scope, since the logs can be large.
+class ScopedLogPath
+{
+  /// \brief Constructor. Removes any previous file with the same name.
+  /// \param[in] _name Name of the benchmark.
+  /// \param[in] _size Message size.
+  public: ScopedLogPath(const std::string &_name, const int64_t _size)
+    : path(std::string(IGN_TRANSPORT_LOG_BUILD_PATH) + "/" + _name + "_" +
+           std::to_string(_size) + ".tlog")
+  {
+    std::remove(this->path.c_str());
+  }
+
+  /// \brief Destructor. Removes the file.
+  public: ~ScopedLogPath()
+  {
+    std::remove(this->path.c_str());
+  }
+
+  /// \brief Path of the log file.
+  public: const std::string path;
+};
+
+//////////////////////////////////////////////////
+/// \brief Number of messages in the logs used by the query and playback
+/// benchmarks.
+/// \param[in] _size Message size.
+/// \return Number of messages.
+static int64_t logMessages(const int64_t _size)
+{
+  return std::max<int64_t>(16, std::min(kMaxLogMessages, kLogBytes / _size));
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a log file with messages 1 ms apart.
+/// \param[in] _path Path of the log file.
+/// \param[in] _size Size of each message.
+/// \param[in] _count Number of messages.
+/// \return True on success.
+static bool writeLog(const std::string &_path, const int64_t _size,
+    const int64_t _count)
+{
+  log::Log logFile;
+  if (!logFile.Open(_path, std::ios_base::out))
+    return false;
+
+  const std::vector<char> data(static_cast<std::size_t>(_size), 'x');
+  for (int64_t i = 0; i < _count; ++i)
+  {
+    if (!logFile.InsertMessage(std::chrono::milliseconds(i + 1), kTopic,
+          kType, data.data(), data.size()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Write messages to a log file, the way the recorder stores each
+/// message it receives. range(0) is the message size.
+static void BM_LogRecord(benchmark::State &_state)
+{
+  const ScopedLogPath logPath("record", _state.range(0));
+  log::Log logFile;
+  if (!logFile.Open(logPath.path, std::ios_base::out))
+  {
+    _state.SkipWithError("Unable to create the log");
+    return;
+  }
+
+  const std::vector<char> data(static_cast<std::size_t>(_state.range(0)),
+      'x');
+  int64_t time = 0;
+  for (auto _ : _state)
+  {
+    if (!logFile.InsertMessage(std::chrono::nanoseconds(++time), kTopic,
+          kType, data.data(), data.size()))
+    {
+      _state.SkipWithError("Unable to insert the message");
+      break;
+    }
+  }
+
+  _state.SetItemsProcessed(_state.iterations());
+  _state.SetBytesProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_LogRecord)
+  ->ArgName("size")
+  ->RangeMultiplier(8)->Range(16, 1 << 20)
+  ->UseRealTime();
+
+//////////////////////////////////////////////////
+/// \brief Read every message of a log file. range(0) is the message size.
+static void BM_LogQuery(benchmark::State &_state)
+{
+  const ScopedLogPath logPath("query", _state.range(0));
+  const int64_t count = logMessages(_state.range(0));
+  log::Log logFile;
+  if (!writeLog(logPath.path, _state.range(0), count) ||
+      !logFile.Open(logPath.path))
+  {
+    _state.SkipWithError("Unable to create the log");
+    return;
+  }
+
+  for (auto _ : _state)
+  {
+    int64_t read = 0;
+    for (const log::Message &msg : logFile.QueryMessages())
+    {
+      benchmark::DoNotOptimize(msg.DataView().data());
+      ++read;
+    }
+
+    if (read != count)
+    {
+      _state.SkipWithError("Unexpected number of messages");
+      break;
+    }
+  }
+
+  _state.SetItemsProcessed(_state.iterations() * count);
+  _state.SetBytesProcessed(_state.iterations() * count * _state.range(0));
+}
+BENCHMARK(BM_LogQuery)
+  ->ArgName("size")
+  ->RangeMultiplier(8)->Range(16, 1 << 20)
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+
+//////////////////////////////////////////////////
+/// \brief Play back a log file as fast as possible, without waiting between
+/// messages. range(0) is the message size.
+static void BM_LogPlayback(benchmark::State &_state)
+{
+  const ScopedLogPath logPath("playback", _state.range(0));
+  const int64_t count = logMessages(_state.range(0));
+  if (!writeLog(logPath.path, _state.range(0), count))
+  {
+    _state.SkipWithError("Unable to create the log");
+    return;
+  }
+
+  log::Playback playback(logPath.path);
+  if (!playback.Valid() || !playback.AddTopic(kTopic))
+  {
+    _state.SkipWithError("Unable to open the log");
+    return;
+  }
+
+  for (auto _ : _state)
+  {
+    const auto handle = playback.Start(std::chrono::nanoseconds::zero(),
+        false);
+    if (!handle)
+    {
+      _state.SkipWithError("Unable to start the playback");
+      break;
+    }
+    handle->WaitUntilFinished();
+
+    if (handle->PublishedMessages() != static_cast<uint64_t>(count))
+    {
+      _state.SkipWithError("Unexpected number of messages");
+      break;
+    }
+  }
+
+  _state.SetItemsProcessed(_state.iterations() * count);
+  _state.SetBytesProcessed(_state.iterations() * count * _state.range(0));
+}
+BENCHMARK(BM_LogPlayback)
+  ->ArgName("size")
+  ->RangeMultiplier(8)->Range(16, 1 << 20)
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -57,6 +57,21 @@ namespace ignition
 
       /// \brief Default message publication rate.
       public: uint64_t msgsPerSec = kUnthrottled;
+
+      /// \brief Maximum bytes pending to be sent, or zero for no limit.
+      public: uint64_t sendBufferLimit = 0;
+
+      /// \brief What to do when the send buffer limit is reached.
+      public: FlowControl_t flowControl = FlowControl_t::DROP;
+
+      /// \brief Maximum time waiting for room with FlowControl_t::BLOCK (ms).
+      public: unsigned int flowControlTimeout = 1000;
+
+      /// \brief Priority class of the topic.
+      public: Priority_t priority = Priority_t::NORMAL;
+
+      /// \brief Whether the topic is sent through multicast.
+      public: bool multicast = false;
     };
 
     /// \internal
@@ -197,6 +212,11 @@ AdvertiseMessageOptions &AdvertiseMessageOptions::operator=(
 {
   AdvertiseOptions::operator=(_other);
   this->SetMsgsPerSec(_other.MsgsPerSec());
+  this->SetSendBufferLimit(_other.SendBufferLimit());
+  this->SetFlowControl(_other.FlowControl());
+  this->SetFlowControlTimeout(_other.FlowControlTimeout());
+  this->SetPriority(_other.Priority());
+  this->SetMulticast(_other.Multicast());
   return *this;
 }
 
@@ -205,7 +225,12 @@ bool AdvertiseMessageOptions::operator==(
   const AdvertiseMessageOptions &_other) const
 {
   return AdvertiseOptions::operator==(_other) &&
-         this->MsgsPerSec() == _other.MsgsPerSec();
+         this->MsgsPerSec() == _other.MsgsPerSec() &&
+         this->SendBufferLimit() == _other.SendBufferLimit() &&
+         this->FlowControl() == _other.FlowControl() &&
+         this->FlowControlTimeout() == _other.FlowControlTimeout() &&
+         this->Priority() == _other.Priority() &&
+         this->Multicast() == _other.Multicast();
 }
 
 //////////////////////////////////////////////////
@@ -233,6 +258,67 @@ void AdvertiseMessageOptions::SetMsgsPerSec(const uint64_t _newMsgsPerSec)
   this->dataPtr->msgsPerSec = _newMsgsPerSec;
 }
 
+//////////////////////////////////////////////////
+uint64_t AdvertiseMessageOptions::SendBufferLimit() const
+{
+  return this->dataPtr->sendBufferLimit;
+}
+
+//////////////////////////////////////////////////
+void AdvertiseMessageOptions::SetSendBufferLimit(const uint64_t _bytes)
+{
+  this->dataPtr->sendBufferLimit = _bytes;
+}
+
+//////////////////////////////////////////////////
+FlowControl_t AdvertiseMessageOptions::FlowControl() const
+{
+  return this->dataPtr->flowControl;
+}
+
+//////////////////////////////////////////////////
+void AdvertiseMessageOptions::SetFlowControl(const FlowControl_t _policy)
+{
+  this->dataPtr->flowControl = _policy;
+}
+
+//////////////////////////////////////////////////
+unsigned int AdvertiseMessageOptions::FlowControlTimeout() const
+{
+  return this->dataPtr->flowControlTimeout;
+}
+
+//////////////////////////////////////////////////
+void AdvertiseMessageOptions::SetFlowControlTimeout(
+  const unsigned int _timeout)
+{
+  this->dataPtr->flowControlTimeout = _timeout;
+}
+
+//////////////////////////////////////////////////
+Priority_t AdvertiseMessageOptions::Priority() const
+{
+  return this->dataPtr->priority;
+}
+
+//////////////////////////////////////////////////
+void AdvertiseMessageOptions::SetPriority(const Priority_t _priority)
+{
+  this->dataPtr->priority = _priority;
+}
+
+//////////////////////////////////////////////////
+bool AdvertiseMessageOptions::Multicast() const
+{
+  return this->dataPtr->multicast;
+}
+
+//////////////////////////////////////////////////
+void AdvertiseMessageOptions::SetMulticast(const bool _multicast)
+{
+  this->dataPtr->multicast = _multicast;
+}
+
 #ifndef _WIN32
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
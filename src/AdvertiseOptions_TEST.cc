@@ -145,6 +145,11 @@ TEST(AdvertiseOptionsTest, msgCopyConstructor)
   AdvertiseMessageOptions opts1;
   opts1.SetScope(Scope_t::HOST);
   opts1.SetMsgsPerSec(10u);
+  opts1.SetSendBufferLimit(1024u);
+  opts1.SetFlowControl(FlowControl_t::BLOCK);
+  opts1.SetFlowControlTimeout(200u);
+  opts1.SetPriority(Priority_t::HIGH);
+  opts1.SetMulticast(true);
   AdvertiseMessageOptions opts2(opts1);
   EXPECT_EQ(opts1, opts2);
 }
@@ -175,6 +180,24 @@ TEST(AdvertiseOptionsTest, msgEqualityOp)
   opts2.SetMsgsPerSec(10u);
   EXPECT_TRUE(opts1 == opts2);
   EXPECT_FALSE(opts1 != opts2);
+  opts1.SetSendBufferLimit(1024u);
+  EXPECT_TRUE(opts1 != opts2);
+  opts2.SetSendBufferLimit(1024u);
+  EXPECT_TRUE(opts1 == opts2);
+  opts1.SetFlowControl(FlowControl_t::BLOCK);
+  EXPECT_TRUE(opts1 != opts2);
+  opts2.SetFlowControl(FlowControl_t::BLOCK);
+  EXPECT_TRUE(opts1 == opts2);
+  opts1.SetFlowControlTimeout(200u);
+  EXPECT_TRUE(opts1 != opts2);
+  opts2.SetFlowControlTimeout(200u);
+  EXPECT_TRUE(opts1 == opts2);
+  opts1.SetPriority(Priority_t::HIGH);
+  EXPECT_TRUE(opts1 != opts2);
+  opts2.SetPriority(Priority_t::HIGH);
+  EXPECT_TRUE(opts1 == opts2);
+  opts1.SetMulticast(true);
+  EXPECT_TRUE(opts1 != opts2);
 }
 
 //////////////////////////////////////////////////
@@ -200,6 +223,25 @@ TEST(AdvertiseOptionsTest, msgStreamInsertion)
     "\tThrottled? Yes\n"
     "\tRate: 10 msgs/sec\n";
   EXPECT_EQ(output.str(), expectedOutput);
+
+  output.clear();
+  output.str("");
+  opts.SetSendBufferLimit(1024u);
+  opts.SetFlowControl(FlowControl_t::BLOCK);
+  opts.SetPriority(Priority_t::HIGH);
+  opts.SetMulticast(true);
+  output << opts;
+  expectedOutput =
+    "Advertise options:\n"
+    "\tScope: All\n"
+    "\tThrottled? Yes\n"
+    "\tRate: 10 msgs/sec\n"
+    "\tPriority: High\n"
+    "\tMulticast? Yes\n"
+    "\tSend buffer limit: 1024 bytes\n"
+    "\tFlow control: Block\n"
+    "\tFlow control timeout: 1000 ms\n";
+  EXPECT_EQ(output.str(), expectedOutput);
 }
 
 //////////////////////////////////////////////////
@@ -218,6 +260,27 @@ TEST(AdvertiseOptionsTest, msgAccessors)
   opts.SetMsgsPerSec(10u);
   EXPECT_EQ(opts.MsgsPerSec(), 10u);
   EXPECT_TRUE(opts.Throttled());
+
+  // Flow control.
+  EXPECT_EQ(opts.SendBufferLimit(), 0u);
+  EXPECT_EQ(opts.FlowControl(), FlowControl_t::DROP);
+  opts.SetSendBufferLimit(1024u);
+  opts.SetFlowControl(FlowControl_t::BLOCK);
+  EXPECT_EQ(opts.SendBufferLimit(), 1024u);
+  EXPECT_EQ(opts.FlowControl(), FlowControl_t::BLOCK);
+  EXPECT_EQ(opts.FlowControlTimeout(), 1000u);
+  opts.SetFlowControlTimeout(200u);
+  EXPECT_EQ(opts.FlowControlTimeout(), 200u);
+
+  // Priority.
+  EXPECT_EQ(opts.Priority(), Priority_t::NORMAL);
+  opts.SetPriority(Priority_t::HIGH);
+  EXPECT_EQ(opts.Priority(), Priority_t::HIGH);
+
+  // Multicast.
+  EXPECT_FALSE(opts.Multicast());
+  opts.SetMulticast(true);
+  EXPECT_TRUE(opts.Multicast());
 }
 
 //////////////////////////////////////////////////
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGN_TRANSPORT_BATCHPRIVATE_HH_
+#define IGN_TRANSPORT_BATCHPRIVATE_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ignition/transport/config.hh"
+
+namespace ignition
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_TRANSPORT_VERSION_NAMESPACE {
+    //
+    /// \brief A batch of messages is sent as a single buffer, where every
+    /// serialized message is preceded by its index in the batch and its
+    /// size, both as 32 bit unsigned integers in little endian order. The
+    /// index gives the sequence number of the message, because some of the
+    /// messages of a batch may not be sent, e.g. if they do not match the
+    /// filters of the remote subscribers.
+    const std::size_t kBatchEntryPrefixSize = 8;
+
+    /// \brief Appended by the subscribers to the code of the NEW_CONNECTION
+    /// control message, before the optional rate and filter, to tell the
+    /// publisher that they accept batches. Publishers send the messages of
+    /// a batch one at a time when any of their remote subscribers did not
+    /// send it, e.g. because it was built with an older version.
+    const char kBatchSupport[] = ";b";
+
+    /// \brief A message of a batch.
+    struct BatchEntry
+    {
+      /// \brief Index of the message in the batch.
+      uint32_t index;
+
+      /// \brief Serialized message.
+      const char *data;
+
+      /// \brief Size of the serialized message.
+      std::size_t size;
+    };
+
+    //////////////////////////////////////////////////
+    /// \brief Write the prefix of a message of a batch.
+    /// \param[out] _buffer Buffer with room for kBatchEntryPrefixSize bytes.
+    /// \param[in] _index Index of the message in the batch.
+    /// \param[in] _size Size of the serialized message.
+    inline void writeBatchEntryPrefix(char *_buffer, const uint32_t _index,
+                                      const uint32_t _size)
+    {
+      for (int i = 0; i < 4; ++i)
+      {
+        _buffer[i] = static_cast<char>((_index >> (8 * i)) & 0xff);
+        _buffer[4 + i] = static_cast<char>((_size >> (8 * i)) & 0xff);
+      }
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Split a batch in its messages.
+    /// \param[in] _data The batch.
+    /// \param[in] _size Size of the batch.
+    /// \param[out] _entries The messages of the batch. They point into _data.
+    /// \return False if the batch is malformed.
+    inline bool parseBatch(const char *_data, const std::size_t _size,
+                           std::vector<BatchEntry> &_entries)
+    {
+      auto readUint32 = [](const char *_src)
+      {
+        uint32_t value = 0;
+        for (int i = 3; i >= 0; --i)
+          value = (value << 8) | static_cast<unsigned char>(_src[i]);
+        return value;
+      };
+
+      _entries.clear();
+      std::size_t offset = 0;
+      while (offset < _size)
+      {
+        if (_size - offset < kBatchEntryPrefixSize)
+          return false;
+
+        BatchEntry entry;
+        entry.index = readUint32(_data + offset);
+        entry.size = readUint32(_data + offset + 4);
+        offset += kBatchEntryPrefixSize;
+        if (_size - offset < entry.size)
+          return false;
+
+        entry.data = _data + offset;
+        offset += entry.size;
+        _entries.push_back(entry);
+      }
+      return true;
+    }
+    }
+  }
+}
+#endif
@@ -17,11 +17,66 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "ignition/transport/Node.hh"
 #include "ignition/transport/SubscribeOptions.hh"
 #include "ignition/transport/CIface.h"
 
+/// \brief Maximum number of free buffers kept by a publisher for loans.
+static constexpr std::size_t kMaxFreeLoans = 8;
+
+/// \brief A buffer that can be lent to the user of a publisher.
+struct LoanBuffer
+{
+  /// \brief The memory of the buffer.
+  std::unique_ptr<char[]> data;
+
+  /// \brief Size of the buffer (bytes).
+  size_t capacity = 0;
+};
+
+/// \brief Buffers lent by a publisher. It is shared with the messages that
+/// are still being sent, so that their buffers can come back to the pool
+/// after the publisher is gone.
+struct LoanPool
+{
+  /// \brief Protects the members of this pool.
+  std::mutex mutex;
+
+  /// \brief Buffers ready to be lent.
+  std::vector<LoanBuffer> free;
+
+  /// \brief Buffers currently lent, indexed by their address.
+  std::unordered_map<void *, LoanBuffer> lent;
+
+  /// \brief Recycle a buffer, or release it if there are enough of them.
+  /// \param[in] _buffer The buffer.
+  void Recycle(LoanBuffer &&_buffer)
+  {
+    std::lock_guard<std::mutex> lk(this->mutex);
+    if (this->free.size() < kMaxFreeLoans)
+      this->free.push_back(std::move(_buffer));
+  }
+};
+
+/// \brief A wrapper to store an Ignition Transport publisher.
+struct IgnTransportPublisher
+{
+  /// \brief The publisher.
+  ignition::transport::Node::Publisher publisher;
+
+  /// \brief Message type advertised by the publisher.
+  std::string msgType;
+
+  /// \brief Buffers for zero-copy publications.
+  std::shared_ptr<LoanPool> pool = std::make_shared<LoanPool>();
+};
+
 /// \brief A wrapper to store an Ignition Transport node and its publishers.
 struct IgnTransportNode
 {
@@ -29,9 +84,35 @@ struct IgnTransportNode
   std::unique_ptr<ignition::transport::Node> nodePtr;
 
   /// \brief All publishers of this node.
-  std::map<std::string, ignition::transport::Node::Publisher> publishers;
+  std::map<std::string, std::unique_ptr<IgnTransportPublisher>> publishers;
 };
 
+/////////////////////////////////////////////////
+/// \brief Get the publisher of a topic, advertising it if needed.
+/// \param[in] _node Pointer to a node.
+/// \param[in] _topic Topic on which to publish the messages.
+/// \param[in] _msgType Name of the message type.
+/// \return The publisher of the topic, or nullptr if the topic could not
+/// be advertised. A failed advertisement is not cached, so that the next
+/// call tries again.
+static IgnTransportPublisher *publisherOf(IgnTransportNode *_node,
+    const char *_topic, const char *_msgType)
+{
+  auto it = _node->publishers.find(_topic);
+  if (it != _node->publishers.end())
+    return it->second.get();
+
+  std::unique_ptr<IgnTransportPublisher> pub(new IgnTransportPublisher);
+  pub->publisher = _node->nodePtr->Advertise(_topic, _msgType);
+  if (!pub->publisher)
+    return nullptr;
+
+  pub->msgType = _msgType;
+  IgnTransportPublisher *result = pub.get();
+  _node->publishers[_topic] = std::move(pub);
+  return result;
+}
+
 /////////////////////////////////////////////////
 IgnTransportNode *ignTransportNodeCreate(const char *_partition)
 {
@@ -61,10 +142,7 @@ int ignTransportAdvertise(IgnTransportNode *_node, const char *_topic,
     return 1;
 
   // Create a publisher if one does not exist.
-  if (_node->publishers.find(_topic) == _node->publishers.end())
-    _node->publishers[_topic] = _node->nodePtr->Advertise(_topic, _msgType);
-
-  return 0;
+  return publisherOf(_node, _topic, _msgType) ? 0 : 1;
 }
 
 /////////////////////////////////////////////////
@@ -75,14 +153,147 @@ int ignTransportPublish(IgnTransportNode *_node, const char *_topic,
     return 1;
 
   // Create a publisher if one does not exist.
-  if (ignTransportAdvertise(_node, _topic, _msgType) == 0)
+  IgnTransportPublisher *pub = publisherOf(_node, _topic, _msgType);
+  if (!pub)
+    return 1;
+
+  // Publish the message.
+  return pub->publisher.PublishRaw(
+    reinterpret_cast<const char*>(_data), _msgType) ? 0 : 1;
+}
+
+/////////////////////////////////////////////////
+int ignTransportPublishN(IgnTransportNode *_node, const char *_topic,
+    const void *_data, size_t _size, const char *_msgType)
+{
+  if (!_node)
+    return 1;
+
+  // Create a publisher if one does not exist.
+  IgnTransportPublisher *pub = publisherOf(_node, _topic, _msgType);
+  if (!pub)
+    return 1;
+
+  // Publish the message.
+  return pub->publisher.PublishRaw(reinterpret_cast<const char*>(_data),
+    _size, _msgType, nullptr) ? 0 : 1;
+}
+
+/////////////////////////////////////////////////
+IgnTransportPublisher *ignTransportAdvertisePublisher(IgnTransportNode *_node,
+    const char *_topic, const char *_msgType)
+{
+  if (!_node)
+    return nullptr;
+
+  return publisherOf(_node, _topic, _msgType);
+}
+
+/////////////////////////////////////////////////
+int ignTransportPublisherPublish(IgnTransportPublisher *_pub,
+    const void *_data, size_t _size)
+{
+  if (!_pub)
+    return 1;
+
+  return _pub->publisher.PublishRaw(reinterpret_cast<const char*>(_data),
+    _size, _pub->msgType, nullptr) ? 0 : 1;
+}
+
+/////////////////////////////////////////////////
+void *ignTransportPublisherLoan(IgnTransportPublisher *_pub, size_t _size)
+{
+  if (!_pub)
+    return nullptr;
+
+  LoanPool &pool = *_pub->pool;
+  std::lock_guard<std::mutex> lk(pool.mutex);
+
+  LoanBuffer buffer;
+  for (auto it = pool.free.begin(); it != pool.free.end(); ++it)
+  {
+    if (it->capacity >= _size)
+    {
+      buffer = std::move(*it);
+      pool.free.erase(it);
+      break;
+    }
+  }
+
+  if (!buffer.data)
+  {
+    // Never allocate an empty buffer, so that every loan has its own address.
+    buffer.capacity = _size > 0 ? _size : 1;
+    buffer.data.reset(new char[buffer.capacity]);
+  }
+
+  void *address = buffer.data.get();
+  pool.lent.emplace(address, std::move(buffer));
+  return address;
+}
+
+/////////////////////////////////////////////////
+int ignTransportPublisherPublishLoan(IgnTransportPublisher *_pub,
+    void *_buffer, size_t _size)
+{
+  if (!_pub)
+    return 1;
+
+  LoanBuffer buffer;
   {
-    // Publish the message.
-    return _node->publishers[_topic].PublishRaw(
-      reinterpret_cast<const char*>(_data), _msgType) ? 0 : 1;
+    std::lock_guard<std::mutex> lk(_pub->pool->mutex);
+    auto it = _pub->pool->lent.find(_buffer);
+    if (it == _pub->pool->lent.end())
+      return 1;
+
+    buffer = std::move(it->second);
+    _pub->pool->lent.erase(it);
   }
 
-  return 1;
+  if (_size > buffer.capacity)
+  {
+    _pub->pool->Recycle(std::move(buffer));
+    return 1;
+  }
+
+  // The buffer comes back to the pool when the last reference to it is
+  // released, which may happen on a ZeroMQ thread once the message is sent.
+  const size_t capacity = buffer.capacity;
+  std::weak_ptr<LoanPool> weakPool = _pub->pool;
+  std::shared_ptr<const void> owner(buffer.data.release(),
+    [weakPool, capacity](const void *_data)
+    {
+      LoanBuffer released;
+      released.data.reset(static_cast<char *>(const_cast<void *>(_data)));
+      released.capacity = capacity;
+      if (auto pool = weakPool.lock())
+        pool->Recycle(std::move(released));
+    });
+
+  return _pub->publisher.PublishRaw(static_cast<const char *>(_buffer),
+    _size, _pub->msgType, owner) ? 0 : 1;
+}
+
+/////////////////////////////////////////////////
+int ignTransportPublisherReturnLoan(IgnTransportPublisher *_pub,
+    void *_buffer)
+{
+  if (!_pub)
+    return 1;
+
+  LoanBuffer buffer;
+  {
+    std::lock_guard<std::mutex> lk(_pub->pool->mutex);
+    auto it = _pub->pool->lent.find(_buffer);
+    if (it == _pub->pool->lent.end())
+      return 1;
+
+    buffer = std::move(it->second);
+    _pub->pool->lent.erase(it);
+  }
+
+  _pub->pool->Recycle(std::move(buffer));
+  return 0;
 }
 
 /////////////////////////////////////////////////
@@ -14,6 +14,8 @@
  * limitations under the License.
  *
 */
+#include <string>
+
 #include <ignition/msgs/stringmsg.pb.h>
 
 #include "gtest/gtest.h"
@@ -177,6 +179,112 @@ TEST(CIfaceTest, PubSubPartitions)
   EXPECT_EQ(nullptr, nodeBar);
 }
 
+//////////////////////////////////////////////////
+/// \brief Function called each time a binary topic update is received.
+void cbBinary(const char *_data, size_t _size, const char *_msgType,
+    void *_userData)
+{
+  std::string *received = static_cast<std::string *>(_userData);
+  ASSERT_NE(nullptr, received);
+  EXPECT_STREQ("ignition.msgs.StringMsg", _msgType);
+  received->assign(_data, _size);
+  ++count;
+}
+
+//////////////////////////////////////////////////
+TEST(CIfaceTest, PublishNAndPublisherHandles)
+{
+  count = 0;
+  IgnTransportNode *node = ignTransportNodeCreate(nullptr);
+  ASSERT_NE(nullptr, node);
+
+  const char *topic = "/foo_binary";
+
+  std::string received;
+  ASSERT_EQ(0, ignTransportSubscribe(node, topic, cbBinary, &received));
+
+  // A message with null bytes in its serialized data.
+  ignition::msgs::StringMsg msg;
+  msg.set_data(std::string("HE\0LLO", 6));
+  const std::string serialized = msg.SerializeAsString();
+  const char *msgType = "ignition.msgs.StringMsg";
+
+  EXPECT_EQ(0, ignTransportPublishN(node, topic, serialized.data(),
+        serialized.size(), msgType));
+  EXPECT_EQ(1, count);
+  EXPECT_EQ(serialized, received);
+
+  // Publish through a handle.
+  IgnTransportPublisher *pub =
+    ignTransportAdvertisePublisher(node, topic, msgType);
+  ASSERT_NE(nullptr, pub);
+  EXPECT_EQ(pub, ignTransportAdvertisePublisher(node, topic, msgType));
+
+  received.clear();
+  EXPECT_EQ(0, ignTransportPublisherPublish(pub, serialized.data(),
+        serialized.size()));
+  EXPECT_EQ(2, count);
+  EXPECT_EQ(serialized, received);
+
+  // Serialize into a loaned buffer and publish it.
+  void *buffer = ignTransportPublisherLoan(pub, serialized.size());
+  ASSERT_NE(nullptr, buffer);
+  ASSERT_TRUE(msg.SerializeToArray(buffer, serialized.size()));
+
+  received.clear();
+  EXPECT_EQ(0, ignTransportPublisherPublishLoan(pub, buffer,
+        serialized.size()));
+  EXPECT_EQ(3, count);
+  EXPECT_EQ(serialized, received);
+
+  // The buffer has been handed back already.
+  EXPECT_NE(0, ignTransportPublisherPublishLoan(pub, buffer,
+        serialized.size()));
+  EXPECT_NE(0, ignTransportPublisherReturnLoan(pub, buffer));
+
+  // Without remote subscribers, the buffer is recycled right away.
+  void *secondBuffer = ignTransportPublisherLoan(pub, serialized.size());
+  EXPECT_EQ(buffer, secondBuffer);
+  EXPECT_EQ(0, ignTransportPublisherReturnLoan(pub, secondBuffer));
+  EXPECT_EQ(3, count);
+
+  // Publishing more than the size of the loan fails.
+  buffer = ignTransportPublisherLoan(pub, 1);
+  ASSERT_NE(nullptr, buffer);
+  EXPECT_NE(0, ignTransportPublisherPublishLoan(pub, buffer, 1024));
+  EXPECT_EQ(3, count);
+
+  EXPECT_EQ(nullptr, ignTransportAdvertisePublisher(nullptr, topic, msgType));
+  EXPECT_NE(0, ignTransportPublishN(nullptr, topic, serialized.data(),
+        serialized.size(), msgType));
+
+  ignTransportNodeDestroy(&node);
+  EXPECT_EQ(nullptr, node);
+}
+
+//////////////////////////////////////////////////
+TEST(CIfaceTest, AdvertiseInvalidTopic)
+{
+  IgnTransportNode *node = ignTransportNodeCreate(nullptr);
+  ASSERT_NE(nullptr, node);
+
+  const char *topic = "invalid topic";
+  const char *msgType = "ignition.msgs.StringMsg";
+  ignition::msgs::StringMsg msg;
+  msg.set_data("HELLO");
+  const std::string serialized = msg.SerializeAsString();
+
+  // A failed advertisement is reported every time, not only the first one.
+  EXPECT_NE(0, ignTransportAdvertise(node, topic, msgType));
+  EXPECT_NE(0, ignTransportAdvertise(node, topic, msgType));
+  EXPECT_NE(0, ignTransportPublish(node, topic, serialized.data(), msgType));
+  EXPECT_NE(0, ignTransportPublishN(node, topic, serialized.data(),
+        serialized.size(), msgType));
+  EXPECT_EQ(nullptr, ignTransportAdvertisePublisher(node, topic, msgType));
+
+  ignTransportNodeDestroy(&node);
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
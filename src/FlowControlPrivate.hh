@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGN_TRANSPORT_FLOWCONTROLPRIVATE_HH_
+#define IGN_TRANSPORT_FLOWCONTROLPRIVATE_HH_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "ignition/transport/AdvertiseOptions.hh"
+#include "ignition/transport/config.hh"
+#include "ignition/transport/TransportTypes.hh"
+
+namespace ignition
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_TRANSPORT_VERSION_NAMESPACE {
+    //
+    /// \brief Accounts the bytes that a publisher has handed to ZeroMQ and
+    /// that ZeroMQ has not released yet, i.e. the messages that are still
+    /// queued for some remote subscriber.
+    /// \sa AdvertiseMessageOptions::SetSendBufferLimit
+    class SendBudget
+    {
+      /// \brief Constructor.
+      /// \param[in] _limit Maximum number of bytes pending.
+      /// \param[in] _policy What to do when a message does not fit.
+      /// \param[in] _timeout Maximum time waiting for room with the block
+      /// policy.
+      public: SendBudget(const uint64_t _limit, const FlowControl_t _policy,
+                         const std::chrono::milliseconds &_timeout =
+                           std::chrono::milliseconds(1000))
+        : limit(_limit),
+          policy(_policy),
+          timeout(_timeout)
+      {
+      }
+
+      /// \brief Reserve room for a message about to be sent. With the block
+      /// policy, wait until there is enough room or the timeout expires. A
+      /// message larger than the limit fits when nothing else is pending.
+      /// \param[in] _bytes Size of the message.
+      /// \return False if the message does not fit, or did not fit before the
+      /// timeout, and must be dropped.
+      public: bool Acquire(const std::size_t _bytes)
+      {
+        std::unique_lock<std::mutex> lk(this->mutex);
+        auto fits = [this, _bytes]
+        {
+          return this->pending == 0 || this->pending + _bytes <= this->limit;
+        };
+
+        if (!fits())
+        {
+          if (this->policy == FlowControl_t::DROP)
+            return false;
+          if (!this->condition.wait_for(lk, this->timeout, fits))
+            return false;
+        }
+
+        this->pending += _bytes;
+        return true;
+      }
+
+      /// \brief Release the room of a message that ZeroMQ has sent or
+      /// discarded.
+      /// \param[in] _bytes Size of the message.
+      public: void Release(const std::size_t _bytes)
+      {
+        {
+          std::lock_guard<std::mutex> lk(this->mutex);
+          this->pending -= _bytes;
+        }
+        this->condition.notify_all();
+      }
+
+      /// \brief Get the policy of the budget.
+      /// \return What to do when a message does not fit.
+      public: FlowControl_t Policy() const
+      {
+        return this->policy;
+      }
+
+      /// \brief Get the number of bytes pending.
+      /// \return The bytes handed to ZeroMQ and not released yet.
+      public: uint64_t Pending() const
+      {
+        std::lock_guard<std::mutex> lk(this->mutex);
+        return this->pending;
+      }
+
+      /// \brief Maximum number of bytes pending.
+      private: const uint64_t limit;
+
+      /// \brief What to do when a message does not fit.
+      private: const FlowControl_t policy;
+
+      /// \brief Maximum time waiting for room with the block policy.
+      private: const std::chrono::milliseconds timeout;
+
+      /// \brief Bytes pending.
+      private: uint64_t pending = 0;
+
+      /// \brief Protects pending.
+      private: mutable std::mutex mutex;
+
+      /// \brief Signaled when room is released.
+      private: std::condition_variable condition;
+    };
+
+    /// \brief Hint given to ZeroMQ with a message accounted by a SendBudget.
+    /// It wraps the deallocation function of the message.
+    struct BudgetedBuffer
+    {
+      /// \brief Original deallocation function.
+      DeallocFunc *ffn;
+
+      /// \brief Original hint.
+      void *hint;
+
+      /// \brief Budget that accounts the message.
+      std::shared_ptr<SendBudget> budget;
+
+      /// \brief Size of the message.
+      std::size_t bytes;
+    };
+
+    //////////////////////////////////////////////////
+    /// \brief Deallocation function given to ZeroMQ for a message accounted
+    /// by a SendBudget. It calls the original deallocation function and
+    /// releases the room of the message.
+    /// \param[in] _data The message.
+    /// \param[in] _hint A BudgetedBuffer allocated with new.
+    inline void releaseBudgetedBuffer(void *_data, void *_hint)
+    {
+      auto *buffer = static_cast<BudgetedBuffer *>(_hint);
+      if (buffer->ffn)
+        buffer->ffn(_data, buffer->hint);
+      buffer->budget->Release(buffer->bytes);
+      delete buffer;
+    }
+    }
+  }
+}
+#endif
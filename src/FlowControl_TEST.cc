@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "FlowControlPrivate.hh"
+
+using namespace ignition;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief With the drop policy, a message that does not fit is rejected.
+TEST(FlowControlTest, Drop)
+{
+  SendBudget budget(100u, FlowControl_t::DROP);
+
+  // A message larger than the limit fits when nothing is pending.
+  EXPECT_TRUE(budget.Acquire(150u));
+  EXPECT_EQ(150u, budget.Pending());
+  EXPECT_FALSE(budget.Acquire(1u));
+  budget.Release(150u);
+
+  EXPECT_TRUE(budget.Acquire(60u));
+  EXPECT_TRUE(budget.Acquire(40u));
+  EXPECT_FALSE(budget.Acquire(1u));
+  EXPECT_EQ(100u, budget.Pending());
+
+  budget.Release(40u);
+  EXPECT_TRUE(budget.Acquire(30u));
+  EXPECT_EQ(90u, budget.Pending());
+}
+
+//////////////////////////////////////////////////
+/// \brief With the block policy, a message waits until there is room.
+TEST(FlowControlTest, Block)
+{
+  SendBudget budget(100u, FlowControl_t::BLOCK);
+  EXPECT_TRUE(budget.Acquire(80u));
+
+  std::atomic<bool> acquired{false};
+  std::thread sender([&]
+    {
+      EXPECT_TRUE(budget.Acquire(50u));
+      acquired = true;
+    });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(acquired);
+
+  budget.Release(80u);
+  sender.join();
+  EXPECT_TRUE(acquired);
+  EXPECT_EQ(50u, budget.Pending());
+}
+
+//////////////////////////////////////////////////
+/// \brief With the block policy, a message that does not fit before the
+/// timeout is rejected.
+TEST(FlowControlTest, BlockTimeout)
+{
+  SendBudget budget(100u, FlowControl_t::BLOCK,
+    std::chrono::milliseconds(50));
+  EXPECT_EQ(FlowControl_t::BLOCK, budget.Policy());
+  EXPECT_TRUE(budget.Acquire(80u));
+
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(budget.Acquire(50u));
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(50));
+  EXPECT_EQ(80u, budget.Pending());
+}
+
+//////////////////////////////////////////////////
+/// \brief The deallocation function of a budgeted buffer releases its room
+/// and calls the original deallocation function.
+TEST(FlowControlTest, BudgetedBuffer)
+{
+  auto budget = std::make_shared<SendBudget>(100u, FlowControl_t::DROP);
+  EXPECT_TRUE(budget->Acquire(10u));
+
+  int released = 0;
+  auto dealloc = [](void *_data, void *_hint)
+  {
+    EXPECT_EQ(nullptr, _data);
+    ++(*static_cast<int *>(_hint));
+  };
+
+  releaseBudgetedBuffer(nullptr,
+    new BudgetedBuffer{dealloc, &released, budget, 10u});
+  EXPECT_EQ(1, released);
+  EXPECT_EQ(0u, budget->Pending());
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -239,6 +239,67 @@ TEST(RepStorageTest, SubStorageNoCallbacks)
   EXPECT_EQ(handler->HandlerUuid(), sub1HandlerPtr->HandlerUuid());
 }
 
+//////////////////////////////////////////////////
+/// \brief Check that the snapshots of the handlers of a topic are not
+/// modified when handlers are added or removed.
+TEST(RepStorageTest, SubStorageSnapshots)
+{
+  using Storage = transport::HandlerStorage<transport::ISubscriptionHandler>;
+  Storage subs;
+
+  Storage::EntriesPtr empty;
+  EXPECT_FALSE(subs.TopicHandlers(topic, empty));
+  ASSERT_NE(nullptr, empty);
+  EXPECT_TRUE(empty->empty());
+
+  auto h1 = std::make_shared<
+    transport::SubscriptionHandler<ignition::msgs::Int32>>(nUuid1);
+  auto h2 = std::make_shared<
+    transport::SubscriptionHandler<ignition::msgs::Int32>>(nUuid2);
+  auto h3 = std::make_shared<
+    transport::SubscriptionHandler<ignition::msgs::Int32>>(nUuid1);
+
+  subs.AddHandler(topic, nUuid1, h1);
+  subs.AddHandler(topic, nUuid2, h2);
+
+  // Adding a handler twice has no effect.
+  subs.AddHandler(topic, nUuid2, h2);
+
+  Storage::EntriesPtr first;
+  EXPECT_TRUE(subs.TopicHandlers(topic, first));
+  ASSERT_EQ(2u, first->size());
+  EXPECT_EQ(h1, (*first)[0].handler);
+  EXPECT_EQ(nUuid1, (*first)[0].nUuid);
+  EXPECT_EQ(h1->HandlerUuid(), (*first)[0].hUuid);
+  EXPECT_EQ(h2, (*first)[1].handler);
+
+  // The handlers are kept in the order they were added.
+  subs.AddHandler(topic, nUuid1, h3);
+  EXPECT_TRUE(subs.RemoveHandler(topic, nUuid2, h2->HandlerUuid()));
+
+  Storage::EntriesPtr second;
+  EXPECT_TRUE(subs.TopicHandlers(topic, second));
+  ASSERT_EQ(2u, second->size());
+  EXPECT_EQ(h1, (*second)[0].handler);
+  EXPECT_EQ(h3, (*second)[1].handler);
+
+  // The first snapshot did not change.
+  ASSERT_EQ(2u, first->size());
+  EXPECT_EQ(h2, (*first)[1].handler);
+
+  // The map view groups the handlers by node.
+  std::map<std::string, transport::ISubscriptionHandler_M> m;
+  EXPECT_TRUE(subs.Handlers(topic, m));
+  ASSERT_EQ(1u, m.size());
+  EXPECT_EQ(2u, m[nUuid1].size());
+
+  EXPECT_TRUE(subs.RemoveHandlersForNode(topic, nUuid1));
+  EXPECT_FALSE(subs.HasHandlersForTopic(topic));
+  EXPECT_FALSE(subs.TopicHandlers(topic, second));
+  EXPECT_TRUE(second->empty());
+  EXPECT_EQ(2u, first->size());
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
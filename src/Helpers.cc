@@ -15,11 +15,21 @@
  *
 */
 
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include <cstdlib>
+#include <cstring>
+#include <iostream>
 #include <string>
+#include <vector>
 
 #include "ignition/transport/Helpers.hh"
 
+#include "ThreadConfigPrivate.hh"
+
 namespace ignition
 {
   namespace transport
@@ -59,6 +69,81 @@ namespace ignition
       pieces.push_back(_orig.substr(pos1, _orig.size()-pos1));
       return pieces;
     }
+
+    //////////////////////////////////////////////////
+    void configureThread(const std::string &_role)
+    {
+#ifndef _WIN32
+      // Thread names are limited to 15 characters.
+      const std::string name = ("ign-" + _role).substr(0, 15);
+#if defined(__linux__)
+      pthread_setname_np(pthread_self(), name.c_str());
+#elif defined(__APPLE__)
+      pthread_setname_np(name.c_str());
+#endif
+
+      const std::string prefix = threadEnvPrefix(_role);
+      std::string value;
+      if (env(prefix + "_CPUS", value))
+      {
+        std::vector<int> cpus;
+        if (!parseCpuList(value, cpus))
+        {
+          std::cerr << "Invalid " << prefix << "_CPUS value [" << value
+                    << "]. Expected a list of CPUs, e.g. 0,2-3." << std::endl;
+        }
+        else
+        {
+#ifdef __linux__
+          cpu_set_t set;
+          CPU_ZERO(&set);
+          for (const auto cpu : cpus)
+          {
+            if (cpu < CPU_SETSIZE)
+              CPU_SET(cpu, &set);
+          }
+          const int err = pthread_setaffinity_np(pthread_self(), sizeof(set),
+            &set);
+          if (err != 0)
+          {
+            std::cerr << "Unable to set the CPU affinity of the [" << _role
+                      << "] thread: " << std::strerror(err) << std::endl;
+          }
+#else
+          std::cerr << prefix << "_CPUS is not supported on this platform"
+                    << std::endl;
+#endif
+        }
+      }
+
+      if (env(prefix + "_SCHED", value))
+      {
+        ThreadSchedule schedule;
+        if (!parseSchedule(value, schedule) || schedPolicy(schedule) < 0)
+        {
+          std::cerr << "Invalid " << prefix << "_SCHED value [" << value
+                    << "]. Expected other, batch, idle, fifo:<priority> or "
+                    << "rr:<priority>." << std::endl;
+        }
+        else
+        {
+          sched_param param;
+          std::memset(&param, 0, sizeof(param));
+          param.sched_priority = schedule.priority;
+          const int err = pthread_setschedparam(pthread_self(),
+            schedPolicy(schedule), &param);
+          if (err != 0)
+          {
+            std::cerr << "Unable to set the scheduling policy of the ["
+                      << _role << "] thread: " << std::strerror(err)
+                      << std::endl;
+          }
+        }
+      }
+#else
+      (void)_role;
+#endif
+    }
     }
   }
 }
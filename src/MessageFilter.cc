@@ -0,0 +1,781 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ignition/transport/MessageFilter.hh"
+
+namespace ignition
+{
+  namespace transport
+  {
+    inline namespace IGNITION_TRANSPORT_VERSION_NAMESPACE
+    {
+    /// \brief Comparison operators.
+    enum class FilterOp
+    {
+      EQ,
+      NE,
+      LT,
+      LE,
+      GT,
+      GE
+    };
+
+    /// \brief A field name in a path, optionally followed by a key selector.
+    struct FilterPathSegment
+    {
+      /// \brief Name of the field.
+      std::string name;
+
+      /// \brief Value of the "key" field of the selected elements.
+      std::string key;
+
+      /// \brief Whether the segment has a key selector.
+      bool hasKey = false;
+    };
+
+    /// \brief The literal on the right side of a comparison.
+    struct FilterLiteral
+    {
+      /// \brief Kinds of literal.
+      enum class Kind
+      {
+        NUMBER,
+        STRING,
+        BOOL,
+        IDENTIFIER
+      };
+
+      /// \brief Kind of literal.
+      Kind kind = Kind::NUMBER;
+
+      /// \brief Text of a string or an identifier.
+      std::string text;
+
+      /// \brief Value of a number or a bool.
+      double number = 0;
+
+      /// \brief Whether the number is an integer that fits in int64_t or
+      /// uint64_t.
+      bool isInteger = false;
+
+      /// \brief Value of an integer.
+      int64_t integer = 0;
+
+      /// \brief Value of a non-negative integer.
+      uint64_t unsignedInteger = 0;
+    };
+
+    /// \brief A comparison between a field and a literal.
+    struct FilterComparison
+    {
+      /// \brief Path of the field.
+      std::vector<FilterPathSegment> path;
+
+      /// \brief Operator.
+      FilterOp op = FilterOp::EQ;
+
+      /// \brief Literal.
+      FilterLiteral literal;
+    };
+
+    /// \internal
+    /// \brief Private data for the MessageFilter class.
+    class MessageFilterPrivate
+    {
+      /// \brief Parse an expression.
+      /// \param[in] _expression The expression.
+      /// \return True if the expression is valid.
+      public: bool Parse(const std::string &_expression);
+
+      /// \brief Evaluate a comparison on a message.
+      /// \param[in] _msg The message.
+      /// \param[in] _cmp The comparison.
+      /// \param[in] _index Index of the path segment to evaluate.
+      /// \return True if any of the values of the field matches.
+      public: static bool Evaluate(const ProtoMsg &_msg,
+                                   const FilterComparison &_cmp,
+                                   const std::size_t _index);
+
+      /// \brief The expression.
+      public: std::string expression;
+
+      /// \brief Whether the expression is valid.
+      public: bool valid = true;
+
+      /// \brief Position where the parsing failed.
+      public: std::size_t errorOffset = 0;
+
+      /// \brief The expression in disjunctive normal form: the message
+      /// matches if all the comparisons of any of the terms match.
+      public: std::vector<std::vector<FilterComparison>> terms;
+
+      /// \brief Parse the expression from the cursor.
+      /// \return True if the expression is valid.
+      private: bool ParseExpression();
+
+      /// \brief Skip the spaces.
+      private: void SkipSpaces();
+
+      /// \brief Consume a token if it is next.
+      /// \param[in] _token The token.
+      /// \return True if the token was consumed.
+      private: bool Accept(const std::string &_token);
+
+      /// \brief Parse an identifier.
+      /// \param[out] _identifier The identifier.
+      /// \return True if an identifier was found.
+      private: bool ParseIdentifier(std::string &_identifier);
+
+      /// \brief Parse a quoted string.
+      /// \param[out] _text The text without quotes.
+      /// \return True if a valid string was found.
+      private: bool ParseString(std::string &_text);
+
+      /// \brief Parse a comparison.
+      /// \param[out] _cmp The comparison.
+      /// \return True if a valid comparison was found.
+      private: bool ParseComparison(FilterComparison &_cmp);
+
+      /// \brief Parse the literal of a comparison.
+      /// \param[out] _literal The literal.
+      /// \return True if a valid literal was found.
+      private: bool ParseLiteral(FilterLiteral &_literal);
+
+      /// \brief Expression being parsed.
+      private: const char *cursor = nullptr;
+    };
+
+    //////////////////////////////////////////////////
+    /// \brief Compare two values.
+    /// \param[in] _a Left value.
+    /// \param[in] _op Operator.
+    /// \param[in] _b Right value.
+    /// \return The result of the comparison.
+    template <typename T>
+    static bool compare(const T &_a, const FilterOp _op, const T &_b)
+    {
+      switch (_op)
+      {
+        case FilterOp::EQ:
+          return _a == _b;
+        case FilterOp::NE:
+          return _a != _b;
+        case FilterOp::LT:
+          return _a < _b;
+        case FilterOp::LE:
+          return _a <= _b;
+        case FilterOp::GT:
+          return _a > _b;
+        case FilterOp::GE:
+          return _a >= _b;
+      }
+      return false;
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Compare a signed integer with a literal.
+    /// \param[in] _value The value.
+    /// \param[in] _cmp The comparison.
+    /// \return The result of the comparison.
+    static bool compareSigned(const int64_t _value,
+                              const FilterComparison &_cmp)
+    {
+      const FilterLiteral &lit = _cmp.literal;
+      if (lit.kind != FilterLiteral::Kind::NUMBER)
+        return false;
+
+      if (lit.isInteger && (lit.integer < 0 ||
+            lit.unsignedInteger <= static_cast<uint64_t>(INT64_MAX)))
+      {
+        return compare(_value, _cmp.op, lit.integer);
+      }
+
+      return compare(static_cast<double>(_value), _cmp.op, lit.number);
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Compare an unsigned integer with a literal.
+    /// \param[in] _value The value.
+    /// \param[in] _cmp The comparison.
+    /// \return The result of the comparison.
+    static bool compareUnsigned(const uint64_t _value,
+                                const FilterComparison &_cmp)
+    {
+      const FilterLiteral &lit = _cmp.literal;
+      if (lit.kind != FilterLiteral::Kind::NUMBER)
+        return false;
+
+      if (lit.isInteger && lit.integer >= 0)
+        return compare(_value, _cmp.op, lit.unsignedInteger);
+
+      return compare(static_cast<double>(_value), _cmp.op, lit.number);
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Compare a floating point value with a literal.
+    /// \param[in] _value The value.
+    /// \param[in] _cmp The comparison.
+    /// \return The result of the comparison.
+    static bool compareDouble(const double _value,
+                              const FilterComparison &_cmp)
+    {
+      if (_cmp.literal.kind != FilterLiteral::Kind::NUMBER)
+        return false;
+
+      return compare(_value, _cmp.op, _cmp.literal.number);
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Compare a string with a literal.
+    /// \param[in] _value The value.
+    /// \param[in] _cmp The comparison.
+    /// \return The result of the comparison.
+    static bool compareString(const std::string &_value,
+                              const FilterComparison &_cmp)
+    {
+      if (_cmp.literal.kind != FilterLiteral::Kind::STRING &&
+          _cmp.literal.kind != FilterLiteral::Kind::IDENTIFIER)
+      {
+        return false;
+      }
+
+      return compare(_value, _cmp.op, _cmp.literal.text);
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Compare a bool with a literal.
+    /// \param[in] _value The value.
+    /// \param[in] _cmp The comparison.
+    /// \return The result of the comparison.
+    static bool compareBool(const bool _value, const FilterComparison &_cmp)
+    {
+      if (_cmp.literal.kind != FilterLiteral::Kind::BOOL &&
+          _cmp.literal.kind != FilterLiteral::Kind::NUMBER)
+      {
+        return false;
+      }
+
+      return compare(_value ? 1.0 : 0.0, _cmp.op, _cmp.literal.number);
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Compare an enum value with a literal, either by name or by
+    /// number.
+    /// \param[in] _value The value.
+    /// \param[in] _cmp The comparison.
+    /// \return The result of the comparison.
+    static bool compareEnum(const google::protobuf::EnumValueDescriptor *_value,
+                            const FilterComparison &_cmp)
+    {
+      if (!_value)
+        return false;
+
+      if (_cmp.literal.kind == FilterLiteral::Kind::IDENTIFIER ||
+          _cmp.literal.kind == FilterLiteral::Kind::STRING)
+      {
+        const google::protobuf::EnumValueDescriptor *other =
+          _value->type()->FindValueByName(_cmp.literal.text);
+        if (!other)
+          return false;
+
+        return compare(_value->number(), _cmp.op, other->number());
+      }
+
+      return compareSigned(_value->number(), _cmp);
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Compare a singular field with a literal.
+    /// \param[in] _msg The message.
+    /// \param[in] _field The field.
+    /// \param[in] _cmp The comparison.
+    /// \return The result of the comparison.
+    static bool compareField(const ProtoMsg &_msg,
+                             const google::protobuf::FieldDescriptor *_field,
+                             const FilterComparison &_cmp)
+    {
+      using google::protobuf::FieldDescriptor;
+      const google::protobuf::Reflection *refl = _msg.GetReflection();
+
+      switch (_field->cpp_type())
+      {
+        case FieldDescriptor::CPPTYPE_INT32:
+          return compareSigned(refl->GetInt32(_msg, _field), _cmp);
+        case FieldDescriptor::CPPTYPE_INT64:
+          return compareSigned(refl->GetInt64(_msg, _field), _cmp);
+        case FieldDescriptor::CPPTYPE_UINT32:
+          return compareUnsigned(refl->GetUInt32(_msg, _field), _cmp);
+        case FieldDescriptor::CPPTYPE_UINT64:
+          return compareUnsigned(refl->GetUInt64(_msg, _field), _cmp);
+        case FieldDescriptor::CPPTYPE_FLOAT:
+          return compareDouble(refl->GetFloat(_msg, _field), _cmp);
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+          return compareDouble(refl->GetDouble(_msg, _field), _cmp);
+        case FieldDescriptor::CPPTYPE_BOOL:
+          return compareBool(refl->GetBool(_msg, _field), _cmp);
+        case FieldDescriptor::CPPTYPE_ENUM:
+          return compareEnum(refl->GetEnum(_msg, _field), _cmp);
+        case FieldDescriptor::CPPTYPE_STRING:
+        {
+          std::string scratch;
+          return compareString(
+            refl->GetStringReference(_msg, _field, &scratch), _cmp);
+        }
+        default:
+          return false;
+      }
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Compare an element of a repeated field with a literal.
+    /// \param[in] _msg The message.
+    /// \param[in] _field The field.
+    /// \param[in] _index Index of the element.
+    /// \param[in] _cmp The comparison.
+    /// \return The result of the comparison.
+    static bool compareElement(const ProtoMsg &_msg,
+                               const google::protobuf::FieldDescriptor *_field,
+                               const int _index,
+                               const FilterComparison &_cmp)
+    {
+      using google::protobuf::FieldDescriptor;
+      const google::protobuf::Reflection *refl = _msg.GetReflection();
+
+      switch (_field->cpp_type())
+      {
+        case FieldDescriptor::CPPTYPE_INT32:
+          return compareSigned(
+            refl->GetRepeatedInt32(_msg, _field, _index), _cmp);
+        case FieldDescriptor::CPPTYPE_INT64:
+          return compareSigned(
+            refl->GetRepeatedInt64(_msg, _field, _index), _cmp);
+        case FieldDescriptor::CPPTYPE_UINT32:
+          return compareUnsigned(
+            refl->GetRepeatedUInt32(_msg, _field, _index), _cmp);
+        case FieldDescriptor::CPPTYPE_UINT64:
+          return compareUnsigned(
+            refl->GetRepeatedUInt64(_msg, _field, _index), _cmp);
+        case FieldDescriptor::CPPTYPE_FLOAT:
+          return compareDouble(
+            refl->GetRepeatedFloat(_msg, _field, _index), _cmp);
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+          return compareDouble(
+            refl->GetRepeatedDouble(_msg, _field, _index), _cmp);
+        case FieldDescriptor::CPPTYPE_BOOL:
+          return compareBool(
+            refl->GetRepeatedBool(_msg, _field, _index), _cmp);
+        case FieldDescriptor::CPPTYPE_ENUM:
+          return compareEnum(
+            refl->GetRepeatedEnum(_msg, _field, _index), _cmp);
+        case FieldDescriptor::CPPTYPE_STRING:
+        {
+          std::string scratch;
+          return compareString(refl->GetRepeatedStringReference(
+            _msg, _field, _index, &scratch), _cmp);
+        }
+        default:
+          return false;
+      }
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Check whether a message is selected by the key of a path
+    /// segment.
+    /// \param[in] _msg The message.
+    /// \param[in] _segment The path segment.
+    /// \return True if the segment has no key or the "key" field of the
+    /// message is equal to it.
+    static bool keyMatches(const ProtoMsg &_msg,
+                           const FilterPathSegment &_segment)
+    {
+      if (!_segment.hasKey)
+        return true;
+
+      const google::protobuf::FieldDescriptor *keyField =
+        _msg.GetDescriptor()->FindFieldByName("key");
+      if (!keyField || keyField->is_repeated() ||
+          keyField->cpp_type() !=
+            google::protobuf::FieldDescriptor::CPPTYPE_STRING)
+      {
+        return false;
+      }
+
+      std::string scratch;
+      return _msg.GetReflection()->GetStringReference(
+        _msg, keyField, &scratch) == _segment.key;
+    }
+
+    //////////////////////////////////////////////////
+    bool MessageFilterPrivate::Evaluate(const ProtoMsg &_msg,
+                                        const FilterComparison &_cmp,
+                                        const std::size_t _index)
+    {
+      using google::protobuf::FieldDescriptor;
+
+      const FilterPathSegment &segment = _cmp.path[_index];
+      const FieldDescriptor *field =
+        _msg.GetDescriptor()->FindFieldByName(segment.name);
+      if (!field)
+        return false;
+
+      const google::protobuf::Reflection *refl = _msg.GetReflection();
+      const bool last = _index + 1 == _cmp.path.size();
+      const bool isMessage =
+        field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE;
+
+      // Keys only select the elements of repeated messages, the last field
+      // has to be a scalar and the others have to be messages.
+      if ((segment.hasKey && (!field->is_repeated() || !isMessage)) ||
+          last == isMessage)
+      {
+        return false;
+      }
+
+      if (!field->is_repeated())
+      {
+        if (last)
+          return compareField(_msg, field, _cmp);
+        return Evaluate(refl->GetMessage(_msg, field), _cmp, _index + 1);
+      }
+
+      const int size = refl->FieldSize(_msg, field);
+      for (int i = 0; i < size; ++i)
+      {
+        if (last)
+        {
+          if (compareElement(_msg, field, i, _cmp))
+            return true;
+          continue;
+        }
+
+        const ProtoMsg &element = refl->GetRepeatedMessage(_msg, field, i);
+        if (keyMatches(element, segment) &&
+            Evaluate(element, _cmp, _index + 1))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    //////////////////////////////////////////////////
+    void MessageFilterPrivate::SkipSpaces()
+    {
+      while (std::isspace(static_cast<unsigned char>(*this->cursor)))
+        ++this->cursor;
+    }
+
+    //////////////////////////////////////////////////
+    bool MessageFilterPrivate::Accept(const std::string &_token)
+    {
+      this->SkipSpaces();
+      if (this->expression.compare(
+            static_cast<std::size_t>(this->cursor - this->expression.c_str()),
+            _token.size(), _token) != 0)
+      {
+        return false;
+      }
+
+      this->cursor += _token.size();
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    bool MessageFilterPrivate::ParseIdentifier(std::string &_identifier)
+    {
+      this->SkipSpaces();
+      const char *start = this->cursor;
+      if (!std::isalpha(static_cast<unsigned char>(*start)) && *start != '_')
+        return false;
+
+      while (std::isalnum(static_cast<unsigned char>(*this->cursor)) ||
+             *this->cursor == '_')
+      {
+        ++this->cursor;
+      }
+
+      _identifier.assign(start, this->cursor);
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    bool MessageFilterPrivate::ParseString(std::string &_text)
+    {
+      this->SkipSpaces();
+      const char quote = *this->cursor;
+      if (quote != '"' && quote != '\'')
+        return false;
+
+      _text.clear();
+      for (++this->cursor; *this->cursor != quote; ++this->cursor)
+      {
+        if (*this->cursor == '\0')
+          return false;
+
+        if (*this->cursor == '\\' && *(this->cursor + 1) != '\0')
+          ++this->cursor;
+
+        _text.push_back(*this->cursor);
+      }
+
+      ++this->cursor;
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    bool MessageFilterPrivate::ParseLiteral(FilterLiteral &_literal)
+    {
+      this->SkipSpaces();
+
+      if (this->ParseString(_literal.text))
+      {
+        _literal.kind = FilterLiteral::Kind::STRING;
+        return true;
+      }
+
+      std::string identifier;
+      if (this->ParseIdentifier(identifier))
+      {
+        if (identifier == "true" || identifier == "false")
+        {
+          _literal.kind = FilterLiteral::Kind::BOOL;
+          _literal.number = identifier == "true" ? 1.0 : 0.0;
+        }
+        else
+        {
+          _literal.kind = FilterLiteral::Kind::IDENTIFIER;
+          _literal.text = identifier;
+        }
+        return true;
+      }
+
+      // A number.
+      char *end = nullptr;
+      _literal.kind = FilterLiteral::Kind::NUMBER;
+      _literal.number = std::strtod(this->cursor, &end);
+      if (end == this->cursor)
+        return false;
+
+      // Keep the exact value of the integers.
+      const std::string text(this->cursor, static_cast<const char *>(end));
+      this->cursor = end;
+      if (text.find_first_not_of("-0123456789") == std::string::npos)
+      {
+        errno = 0;
+        if (text[0] == '-')
+        {
+          _literal.integer = std::strtoll(text.c_str(), nullptr, 10);
+          _literal.isInteger = errno == 0;
+        }
+        else
+        {
+          _literal.unsignedInteger = std::strtoull(text.c_str(), nullptr, 10);
+          _literal.integer = static_cast<int64_t>(std::min(
+            _literal.unsignedInteger, static_cast<uint64_t>(INT64_MAX)));
+          _literal.isInteger = errno == 0;
+        }
+      }
+      return true;
+    }
+
+    //////////////////////////////////////////////////
+    bool MessageFilterPrivate::ParseComparison(FilterComparison &_cmp)
+    {
+      do
+      {
+        FilterPathSegment segment;
+        if (!this->ParseIdentifier(segment.name))
+          return false;
+
+        if (this->Accept("["))
+        {
+          segment.hasKey = true;
+          if (!this->ParseString(segment.key) &&
+              !this->ParseIdentifier(segment.key))
+          {
+            return false;
+          }
+
+          if (!this->Accept("]"))
+            return false;
+        }
+
+        _cmp.path.push_back(segment);
+      } while (this->Accept("."));
+
+      // Two-character operators first.
+      if (this->Accept("=="))
+        _cmp.op = FilterOp::EQ;
+      else if (this->Accept("!="))
+        _cmp.op = FilterOp::NE;
+      else if (this->Accept("<="))
+        _cmp.op = FilterOp::LE;
+      else if (this->Accept(">="))
+        _cmp.op = FilterOp::GE;
+      else if (this->Accept("<"))
+        _cmp.op = FilterOp::LT;
+      else if (this->Accept(">"))
+        _cmp.op = FilterOp::GT;
+      else
+        return false;
+
+      return this->ParseLiteral(_cmp.literal);
+    }
+
+    //////////////////////////////////////////////////
+    bool MessageFilterPrivate::Parse(const std::string &_expression)
+    {
+      this->expression = _expression;
+      this->cursor = this->expression.c_str();
+      this->terms.clear();
+
+      if (this->ParseExpression())
+        return true;
+
+      this->errorOffset =
+        static_cast<std::size_t>(this->cursor - this->expression.c_str());
+      this->terms.clear();
+      return false;
+    }
+
+    //////////////////////////////////////////////////
+    bool MessageFilterPrivate::ParseExpression()
+    {
+      this->SkipSpaces();
+      if (*this->cursor == '\0')
+        return true;
+
+      do
+      {
+        std::vector<FilterComparison> term;
+        do
+        {
+          FilterComparison cmp;
+          if (!this->ParseComparison(cmp))
+            return false;
+          term.push_back(cmp);
+        } while (this->Accept("&&"));
+
+        this->terms.push_back(term);
+      } while (this->Accept("||"));
+
+      this->SkipSpaces();
+      return *this->cursor == '\0';
+    }
+
+    //////////////////////////////////////////////////
+    MessageFilter::MessageFilter()
+      : dataPtr(std::make_shared<MessageFilterPrivate>())
+    {
+    }
+
+    //////////////////////////////////////////////////
+    MessageFilter::MessageFilter(const std::string &_expression)
+    {
+      auto data = std::make_shared<MessageFilterPrivate>();
+      data->valid = data->Parse(_expression);
+      if (!data->valid)
+      {
+        std::cerr << "MessageFilter: Invalid expression [" << _expression
+                  << "] at position " << data->errorOffset << std::endl;
+      }
+      this->dataPtr = data;
+    }
+
+    //////////////////////////////////////////////////
+    MessageFilter::MessageFilter(const MessageFilter &_other)
+      : dataPtr(_other.dataPtr)
+    {
+    }
+
+    //////////////////////////////////////////////////
+    MessageFilter &MessageFilter::operator=(const MessageFilter &_other)
+    {
+      this->dataPtr = _other.dataPtr;
+      return *this;
+    }
+
+    //////////////////////////////////////////////////
+    MessageFilter::~MessageFilter()
+    {
+    }
+
+    //////////////////////////////////////////////////
+    const std::string &MessageFilter::Expression() const
+    {
+      return this->dataPtr->expression;
+    }
+
+    //////////////////////////////////////////////////
+    bool MessageFilter::Empty() const
+    {
+      return this->dataPtr->valid && this->dataPtr->terms.empty();
+    }
+
+    //////////////////////////////////////////////////
+    bool MessageFilter::Valid() const
+    {
+      return this->dataPtr->valid;
+    }
+
+    //////////////////////////////////////////////////
+    bool MessageFilter::Matches(const ProtoMsg &_msg) const
+    {
+      if (!this->dataPtr->valid)
+        return false;
+
+      if (this->dataPtr->terms.empty())
+        return true;
+
+      for (const auto &term : this->dataPtr->terms)
+      {
+        bool matches = true;
+        for (const auto &cmp : term)
+        {
+          if (!MessageFilterPrivate::Evaluate(_msg, cmp, 0))
+          {
+            matches = false;
+            break;
+          }
+        }
+
+        if (matches)
+          return true;
+      }
+      return false;
+    }
+    }
+  }
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <ignition/msgs/discovery.pb.h>
+#include <ignition/msgs/int32.pb.h>
+#include <ignition/msgs/pose.pb.h>
+#include <ignition/msgs/pose_v.pb.h>
+
+#include <string>
+
+#include "ignition/transport/MessageFilter.hh"
+#include "gtest/gtest.h"
+
+using namespace ignition;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Create a pose with a frame id.
+/// \param[in] _name Name of the pose.
+/// \param[in] _frame Frame id.
+/// \param[in] _z Height.
+/// \return The pose.
+msgs::Pose makePose(const std::string &_name, const std::string &_frame,
+                    const double _z)
+{
+  msgs::Pose pose;
+  pose.set_name(_name);
+  pose.set_id(7);
+  pose.mutable_position()->set_z(_z);
+
+  auto *stamp = pose.mutable_header()->add_data();
+  stamp->set_key("seq");
+  stamp->add_value("12");
+
+  auto *frame = pose.mutable_header()->add_data();
+  frame->set_key("frame_id");
+  frame->add_value(_frame);
+  return pose;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the empty filter and the accessors.
+TEST(MessageFilterTest, Empty)
+{
+  msgs::Int32 msg;
+
+  MessageFilter filter;
+  EXPECT_TRUE(filter.Empty());
+  EXPECT_TRUE(filter.Valid());
+  EXPECT_TRUE(filter.Expression().empty());
+  EXPECT_TRUE(filter.Matches(msg));
+
+  MessageFilter blank("  ");
+  EXPECT_TRUE(blank.Empty());
+  EXPECT_TRUE(blank.Matches(msg));
+
+  MessageFilter notEmpty("data == 1");
+  EXPECT_FALSE(notEmpty.Empty());
+  EXPECT_EQ("data == 1", notEmpty.Expression());
+
+  // Copies share the expression.
+  MessageFilter copy(notEmpty);
+  EXPECT_EQ(notEmpty.Expression(), copy.Expression());
+  filter = copy;
+  EXPECT_FALSE(filter.Empty());
+}
+
+//////////////////////////////////////////////////
+/// \brief Invalid expressions never match.
+TEST(MessageFilterTest, Invalid)
+{
+  msgs::Int32 msg;
+  for (const char *expr : {"data", "data ==", "== 3", "data = 3",
+         "data == 3 &&", "data == 3 || ", "data == \"3", "data[ == 3",
+         "data == 3 extra", "1data == 3"})
+  {
+    MessageFilter filter(expr);
+    EXPECT_FALSE(filter.Valid()) << expr;
+    EXPECT_FALSE(filter.Empty()) << expr;
+    EXPECT_FALSE(filter.Matches(msg)) << expr;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the operators on numeric fields.
+TEST(MessageFilterTest, Numbers)
+{
+  msgs::Int32 msg;
+  msg.set_data(-3);
+
+  EXPECT_TRUE(MessageFilter("data == -3").Matches(msg));
+  EXPECT_FALSE(MessageFilter("data != -3").Matches(msg));
+  EXPECT_TRUE(MessageFilter("data < 0").Matches(msg));
+  EXPECT_TRUE(MessageFilter("data <= -3").Matches(msg));
+  EXPECT_FALSE(MessageFilter("data > -3").Matches(msg));
+  EXPECT_TRUE(MessageFilter("data >= -3.5").Matches(msg));
+  EXPECT_TRUE(MessageFilter("data>-4&&data<-2").Matches(msg));
+
+  // Strings are not compared with numbers.
+  EXPECT_FALSE(MessageFilter("data == \"-3\"").Matches(msg));
+
+  // Unsigned and floating point fields.
+  msgs::Pose pose = makePose("robot_1", "world", 0.25);
+  EXPECT_TRUE(MessageFilter("id == 7").Matches(pose));
+  EXPECT_TRUE(MessageFilter("id > -1").Matches(pose));
+  EXPECT_TRUE(MessageFilter("position.z > 0.2").Matches(pose));
+  EXPECT_TRUE(MessageFilter("position.z < 2.5e-1 || id == 7").Matches(pose));
+  EXPECT_FALSE(MessageFilter("position.z < 2.5e-1 && id == 7").Matches(pose));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check strings, nested messages and keys.
+TEST(MessageFilterTest, Fields)
+{
+  msgs::Pose pose = makePose("robot_1", "world", 1.0);
+
+  EXPECT_TRUE(MessageFilter("name == \"robot_1\"").Matches(pose));
+  EXPECT_TRUE(MessageFilter("name == 'robot_1'").Matches(pose));
+  EXPECT_TRUE(MessageFilter("name > \"robot_0\"").Matches(pose));
+  EXPECT_FALSE(MessageFilter("name == \"robot_2\"").Matches(pose));
+
+  // Select the elements of a repeated message by key.
+  EXPECT_TRUE(MessageFilter(
+    "header.data[frame_id].value == \"world\"").Matches(pose));
+  EXPECT_TRUE(MessageFilter(
+    "header.data['frame_id'].value == \"world\"").Matches(pose));
+  EXPECT_FALSE(MessageFilter(
+    "header.data[seq].value == \"world\"").Matches(pose));
+
+  // Without a key, any element can match.
+  EXPECT_TRUE(MessageFilter("header.data.value == \"12\"").Matches(pose));
+  EXPECT_FALSE(MessageFilter("header.data.key == \"other\"").Matches(pose));
+
+  // Fields that do not exist, messages compared with literals and keys on
+  // fields that are not repeated messages never match.
+  EXPECT_FALSE(MessageFilter("frame == \"world\"").Matches(pose));
+  EXPECT_FALSE(MessageFilter("position == 1").Matches(pose));
+  EXPECT_FALSE(MessageFilter("name[x] == \"robot_1\"").Matches(pose));
+  EXPECT_FALSE(MessageFilter("name.x == 1").Matches(pose));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check repeated messages and enums.
+TEST(MessageFilterTest, RepeatedAndEnums)
+{
+  msgs::Pose_V poses;
+  *poses.add_pose() = makePose("robot_1", "world", 1.0);
+  *poses.add_pose() = makePose("robot_2", "map", 2.0);
+
+  EXPECT_TRUE(MessageFilter("pose.name == \"robot_2\"").Matches(poses));
+  EXPECT_TRUE(MessageFilter(
+    "pose.header.data[frame_id].value == \"map\"").Matches(poses));
+  EXPECT_FALSE(MessageFilter("pose.position.z > 2").Matches(poses));
+
+  msgs::Discovery discovery;
+  discovery.set_type(msgs::Discovery::NEW_CONNECTION);
+  EXPECT_TRUE(MessageFilter("type == NEW_CONNECTION").Matches(discovery));
+  EXPECT_TRUE(MessageFilter("type != END_CONNECTION").Matches(discovery));
+  EXPECT_TRUE(MessageFilter("type == 6").Matches(discovery));
+  EXPECT_FALSE(MessageFilter("type == UNKNOWN_VALUE").Matches(discovery));
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
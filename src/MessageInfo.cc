@@ -15,7 +15,10 @@
  *
 */
 
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "ignition/transport/MessageInfo.hh"
 #include "ignition/transport/TopicUtils.hh"
@@ -29,6 +32,19 @@ namespace ignition
   {
     inline namespace IGNITION_TRANSPORT_VERSION_NAMESPACE
     {
+    /// \internal
+    /// \brief Topic and partition of a message. The descriptors of the fully
+    /// qualified topic names are interned, so the messages of a topic share
+    /// the same descriptor.
+    struct TopicDescriptor
+    {
+      /// \brief Topic name.
+      std::string topic;
+
+      /// \brief Partition name.
+      std::string partition;
+    };
+
     /// \internal
     /// \brief Private data for MessageInfo class.
     class MessageInfoPrivate
@@ -39,31 +55,140 @@ namespace ignition
       /// \brief Destructor.
       public: virtual ~MessageInfoPrivate() = default;
 
-      /// \brief Topic name.
-      public: std::string topic = "";
+      /// \brief Get a private data object, reusing one released by this
+      /// thread if possible, so building a MessageInfo does not allocate.
+      /// \return The private data, with default values.
+      public: static MessageInfoPrivate *Acquire();
 
-      /// \brief Message type name.
-      public: std::string type = "";
+      /// \brief Release a private data object obtained with Acquire().
+      /// \param[in] _data The private data.
+      public: static void Release(MessageInfoPrivate *_data);
 
-      /// \brief Partition name.
-      public: std::string partition = "";
+      /// \brief Restore the default values, keeping the memory of the
+      /// strings.
+      public: void Reset();
+
+      /// \brief Topic and partition.
+      public: std::shared_ptr<const TopicDescriptor> descriptor;
+
+      /// \brief Identifier of the message type name.
+      public: NameId typeId = kNoNameId;
+
+      /// \brief Message type name, only used when the name could not be
+      /// interned.
+      public: std::string type;
 
       /// \brief Was the message sent via intra-process?
       public: bool isIntraProcess = false;
+
+      /// \brief Publication time.
+      public: std::chrono::steady_clock::time_point publicationTime;
+
+      /// \brief Sequence number of the message.
+      public: uint64_t sequenceNumber = 0;
+
+      /// \brief Publisher UUID.
+      public: std::string publisherUuid = "";
+
+      /// \brief Downsampling period of the publisher.
+      public: std::chrono::nanoseconds downsamplingPeriod{0};
+
+      /// \brief Reception time.
+      public: std::chrono::steady_clock::time_point receptionTime;
+
+      /// \brief Size of the serialized message.
+      public: uint64_t size = 0;
     };
     }
   }
 }
 
+namespace
+{
+  /// \brief Maximum number of private data objects kept by each thread.
+  const std::size_t kMaxPooled = 32;
+
+  /// \brief Private data objects released by a thread, ready to be reused.
+  struct MessageInfoPool
+  {
+    /// \brief Destructor.
+    ~MessageInfoPool();
+
+    /// \brief The objects.
+    std::vector<MessageInfoPrivate *> free;
+  };
+
+  /// \brief Set when the pool of the thread has been destroyed, so the
+  /// MessageInfo objects destroyed later do not use it. It is trivially
+  /// destructible, so it can be read until the thread ends.
+  thread_local bool tPoolDestroyed = false;
+
+  /// \brief Pool of the thread.
+  thread_local MessageInfoPool tPool;
+
+  //////////////////////////////////////////////////
+  MessageInfoPool::~MessageInfoPool()
+  {
+    tPoolDestroyed = true;
+    for (auto *data : this->free)
+      delete data;
+  }
+
+  /// \brief Empty string returned when a name is not set.
+  const std::string kEmpty;
+}
+
+//////////////////////////////////////////////////
+MessageInfoPrivate *MessageInfoPrivate::Acquire()
+{
+  if (tPoolDestroyed || tPool.free.empty())
+    return new MessageInfoPrivate();
+
+  MessageInfoPrivate *data = tPool.free.back();
+  tPool.free.pop_back();
+  return data;
+}
+
+//////////////////////////////////////////////////
+void MessageInfoPrivate::Release(MessageInfoPrivate *_data)
+{
+  if (!_data)
+    return;
+
+  if (tPoolDestroyed || tPool.free.size() >= kMaxPooled)
+  {
+    delete _data;
+    return;
+  }
+
+  _data->Reset();
+  tPool.free.push_back(_data);
+}
+
+//////////////////////////////////////////////////
+void MessageInfoPrivate::Reset()
+{
+  this->descriptor.reset();
+  this->typeId = kNoNameId;
+  this->type.clear();
+  this->isIntraProcess = false;
+  this->publicationTime = std::chrono::steady_clock::time_point();
+  this->sequenceNumber = 0;
+  this->publisherUuid.clear();
+  this->downsamplingPeriod = std::chrono::nanoseconds(0);
+  this->receptionTime = std::chrono::steady_clock::time_point();
+  this->size = 0;
+}
+
 //////////////////////////////////////////////////
 MessageInfo::MessageInfo()
-  : dataPtr(new MessageInfoPrivate())
+  : dataPtr(MessageInfoPrivate::Acquire())
 {
 }
 
 //////////////////////////////////////////////////
 MessageInfo::MessageInfo(const MessageInfo &_other)
-  : dataPtr(new MessageInfoPrivate())
+  : dataPtr(MessageInfoPrivate::Acquire())
 {
   *this->dataPtr = *_other.dataPtr;
 }
@@ -77,51 +202,84 @@ MessageInfo::MessageInfo(MessageInfo &&_other)  // NOLINT
 //////////////////////////////////////////////////
 MessageInfo::~MessageInfo()
 {
+  MessageInfoPrivate::Release(this->dataPtr.release());
 }
 
 //////////////////////////////////////////////////
 const std::string &MessageInfo::Topic() const
 {
-  return this->dataPtr->topic;
+  return this->dataPtr->descriptor ? this->dataPtr->descriptor->topic : kEmpty;
 }
 
 //////////////////////////////////////////////////
 void MessageInfo::SetTopic(const std::string &_topic)
 {
-  this->dataPtr->topic = _topic;
+  auto descriptor = std::make_shared<TopicDescriptor>();
+  descriptor->topic = _topic;
+  descriptor->partition = this->Partition();
+  this->dataPtr->descriptor = descriptor;
 }
 
 //////////////////////////////////////////////////
 const std::string &MessageInfo::Type() const
 {
+  if (this->dataPtr->typeId != kNoNameId)
+    return NameTable::Name(this->dataPtr->typeId);
   return this->dataPtr->type;
 }
 
 //////////////////////////////////////////////////
 void MessageInfo::SetType(const std::string &_type)
 {
-  this->dataPtr->type = _type;
+  this->dataPtr->typeId = NameTable::Intern(_type);
+  if (this->dataPtr->typeId == kNoNameId)
+    this->dataPtr->type = _type;
+  else
+    this->dataPtr->type.clear();
+}
+
+//////////////////////////////////////////////////
+NameId MessageInfo::TypeId() const
+{
+  return this->dataPtr->typeId;
 }
 
 //////////////////////////////////////////////////
 const std::string &MessageInfo::Partition() const
 {
-  return this->dataPtr->partition;
+  return this->dataPtr->descriptor ?
+    this->dataPtr->descriptor->partition : kEmpty;
 }
 
 //////////////////////////////////////////////////
 void MessageInfo::SetPartition(const std::string &_partition)
 {
-  this->dataPtr->partition = _partition;
+  auto descriptor = std::make_shared<TopicDescriptor>();
+  descriptor->topic = this->Topic();
+  descriptor->partition = _partition;
+  this->dataPtr->descriptor = descriptor;
 }
 
 //////////////////////////////////////////////////
 bool MessageInfo::SetTopicAndPartition(const std::string &_fullyQualifiedName)
 {
-  return TopicUtils::DecomposeFullyQualifiedTopic(
-        _fullyQualifiedName,
-        this->dataPtr->partition,
-        this->dataPtr->topic);
+  auto descriptor = std::make_shared<TopicDescriptor>();
+  if (!TopicUtils::DecomposeFullyQualifiedTopic(_fullyQualifiedName,
+        descriptor->partition, descriptor->topic))
+  {
+    return false;
+  }
+
+  this->dataPtr->descriptor = std::move(descriptor);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void MessageInfo::SetTopicAndType(const MessageInfo &_other)
+{
+  this->dataPtr->descriptor = _other.dataPtr->descriptor;
+  this->dataPtr->typeId = _other.dataPtr->typeId;
+  this->dataPtr->type = _other.dataPtr->type;
 }
 
 //////////////////////////////////////////////////
@@ -135,3 +293,78 @@ void MessageInfo::SetIntraProcess(bool _value)
 {
   this->dataPtr->isIntraProcess = _value;
 }
+
+//////////////////////////////////////////////////
+std::chrono::steady_clock::time_point MessageInfo::PublicationTime() const
+{
+  return this->dataPtr->publicationTime;
+}
+
+//////////////////////////////////////////////////
+void MessageInfo::SetPublicationTime(
+    const std::chrono::steady_clock::time_point &_time)
+{
+  this->dataPtr->publicationTime = _time;
+}
+
+//////////////////////////////////////////////////
+uint64_t MessageInfo::SequenceNumber() const
+{
+  return this->dataPtr->sequenceNumber;
+}
+
+//////////////////////////////////////////////////
+void MessageInfo::SetSequenceNumber(const uint64_t _seq)
+{
+  this->dataPtr->sequenceNumber = _seq;
+}
+
+//////////////////////////////////////////////////
+const std::string &MessageInfo::PublisherUuid() const
+{
+  return this->dataPtr->publisherUuid;
+}
+
+//////////////////////////////////////////////////
+void MessageInfo::SetPublisherUuid(const std::string &_uuid)
+{
+  this->dataPtr->publisherUuid = _uuid;
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds MessageInfo::DownsamplingPeriod() const
+{
+  return this->dataPtr->downsamplingPeriod;
+}
+
+//////////////////////////////////////////////////
+void MessageInfo::SetDownsamplingPeriod(
+    const std::chrono::nanoseconds &_period)
+{
+  this->dataPtr->downsamplingPeriod = _period;
+}
+
+//////////////////////////////////////////////////
+std::chrono::steady_clock::time_point MessageInfo::ReceptionTime() const
+{
+  return this->dataPtr->receptionTime;
+}
+
+//////////////////////////////////////////////////
+void MessageInfo::SetReceptionTime(
+    const std::chrono::steady_clock::time_point &_time)
+{
+  this->dataPtr->receptionTime = _time;
+}
+
+//////////////////////////////////////////////////
+uint64_t MessageInfo::Size() const
+{
+  return this->dataPtr->size;
+}
+
+//////////////////////////////////////////////////
+void MessageInfo::SetSize(const uint64_t _size)
+{
+  this->dataPtr->size = _size;
+}
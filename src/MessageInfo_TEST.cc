@@ -15,6 +15,7 @@
  *
 */
 
+#include <chrono>
 #include <string>
 
 #include "ignition/transport/MessageInfo.hh"
@@ -111,6 +112,33 @@ TEST(MessageInfoTest, InterProcess)
   EXPECT_FALSE(info.IntraProcess());
 }
 
+//////////////////////////////////////////////////
+/// \brief Check the publication time, sequence number and publisher UUID.
+TEST(MessageInfoTest, Header)
+{
+  transport::MessageInfo info;
+  EXPECT_EQ(std::chrono::steady_clock::time_point(), info.PublicationTime());
+  EXPECT_EQ(0u, info.SequenceNumber());
+  EXPECT_TRUE(info.PublisherUuid().empty());
+  EXPECT_EQ(std::chrono::nanoseconds(0), info.DownsamplingPeriod());
+
+  auto now = std::chrono::steady_clock::now();
+  info.SetPublicationTime(now);
+  info.SetSequenceNumber(42u);
+  info.SetPublisherUuid("a_uuid");
+  info.SetDownsamplingPeriod(std::chrono::milliseconds(100));
+  EXPECT_EQ(now, info.PublicationTime());
+  EXPECT_EQ(std::chrono::milliseconds(100), info.DownsamplingPeriod());
+  EXPECT_EQ(42u, info.SequenceNumber());
+  EXPECT_EQ("a_uuid", info.PublisherUuid());
+
+  transport::MessageInfo infoCopy(info);
+  EXPECT_EQ(now, infoCopy.PublicationTime());
+  EXPECT_EQ(42u, infoCopy.SequenceNumber());
+  EXPECT_EQ("a_uuid", infoCopy.PublisherUuid());
+  EXPECT_EQ(std::chrono::milliseconds(100), infoCopy.DownsamplingPeriod());
+}
+
 //////////////////////////////////////////////////
 /// \brief Check Copy constructor.
 TEST(MessageInfoTest, CopyConstructor)
@@ -127,6 +155,79 @@ TEST(MessageInfoTest, CopyConstructor)
   EXPECT_TRUE(infoCopy.IntraProcess());
 }
 
+//////////////////////////////////////////////////
+/// \brief Check the reception time and the size.
+TEST(MessageInfoTest, ReceptionTimeAndSize)
+{
+  transport::MessageInfo info;
+  EXPECT_EQ(std::chrono::steady_clock::time_point(), info.ReceptionTime());
+  EXPECT_EQ(0u, info.Size());
+
+  auto now = std::chrono::steady_clock::now();
+  info.SetReceptionTime(now);
+  info.SetSize(128u);
+  EXPECT_EQ(now, info.ReceptionTime());
+  EXPECT_EQ(128u, info.Size());
+
+  transport::MessageInfo infoCopy(info);
+  EXPECT_EQ(now, infoCopy.ReceptionTime());
+  EXPECT_EQ(128u, infoCopy.Size());
+}
+
+//////////////////////////////////////////////////
+/// \brief The names of the messages of a topic are shared, and changing
+/// them only affects one message.
+TEST(MessageInfoTest, SharedNames)
+{
+  transport::MessageInfo info1;
+  transport::MessageInfo info2;
+  EXPECT_TRUE(info1.SetTopicAndPartition("@/a_partition@/shared_topic"));
+  info1.SetType("ign_msgs.Int32");
+  info2.SetTopicAndType(info1);
+  EXPECT_EQ(&info1.Topic(), &info2.Topic());
+  EXPECT_EQ(&info1.Partition(), &info2.Partition());
+  EXPECT_EQ(&info1.Type(), &info2.Type());
+  EXPECT_EQ(info1.TypeId(), info2.TypeId());
+
+  info2.SetTopic("/other_topic");
+  EXPECT_EQ("/shared_topic", info1.Topic());
+  EXPECT_EQ("/other_topic", info2.Topic());
+  EXPECT_EQ("/a_partition", info2.Partition());
+
+  info2.SetPartition("/other_partition");
+  EXPECT_EQ("/a_partition", info1.Partition());
+  EXPECT_EQ("/other_partition", info2.Partition());
+  EXPECT_EQ("/other_topic", info2.Topic());
+
+  // An invalid name keeps the previous one.
+  EXPECT_FALSE(info1.SetTopicAndPartition("invalid@"));
+  EXPECT_EQ("/shared_topic", info1.Topic());
+}
+
+//////////////////////////////////////////////////
+/// \brief A MessageInfo always starts with the default values, even if it
+/// reuses the memory of a destroyed one.
+TEST(MessageInfoTest, Reuse)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    transport::MessageInfo info;
+    EXPECT_TRUE(info.Topic().empty());
+    EXPECT_TRUE(info.Type().empty());
+    EXPECT_FALSE(info.IntraProcess());
+    EXPECT_EQ(0u, info.SequenceNumber());
+    EXPECT_TRUE(info.PublisherUuid().empty());
+    EXPECT_EQ(0u, info.Size());
+
+    info.SetTopicAndPartition("@/a_partition@/b_topic");
+    info.SetType("ign_msgs.Int32");
+    info.SetIntraProcess(true);
+    info.SetSequenceNumber(7u);
+    info.SetPublisherUuid("a_uuid");
+    info.SetSize(3u);
+  }
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "ignition/transport/NameTable.hh"
+#include "ignition/transport/TransportTypes.hh"
+
+using namespace ignition;
+using namespace transport;
+
+namespace
+{
+  /// \brief The interned names.
+  struct Table
+  {
+    /// \brief Constructor.
+    Table()
+    {
+      for (auto &name : this->names)
+        name.store(nullptr, std::memory_order_relaxed);
+    }
+
+    /// \brief Protects ids.
+    std::shared_mutex mutex;
+
+    /// \brief Identifier of every name. The nodes of the map are never
+    /// released, so the names can be referenced from the names array.
+    std::unordered_map<std::string, NameId> ids;
+
+    /// \brief Interned names, indexed by identifier. They are read without
+    /// locking the mutex.
+    std::array<std::atomic<const std::string *>, NameTable::kMaxNames> names;
+  };
+
+  /// \brief Empty string returned for the invalid identifiers.
+  const std::string kEmpty;
+
+  //////////////////////////////////////////////////
+  /// \brief Get the table of the process, with kGenericMessageType interned.
+  /// \return The table.
+  Table &table()
+  {
+    static Table *t = []()
+    {
+      // Never destroyed, so the names can be used by other static objects.
+      auto *result = new Table();
+      auto it = result->ids.emplace(kGenericMessageType,
+        kGenericMessageTypeId).first;
+      result->names[kGenericMessageTypeId].store(
+        &it->first, std::memory_order_release);
+      return result;
+    }();
+    return *t;
+  }
+}
+
+//////////////////////////////////////////////////
+NameId NameTable::Intern(const std::string &_name)
+{
+  Table &t = table();
+  {
+    std::shared_lock<std::shared_mutex> lk(t.mutex);
+    auto it = t.ids.find(_name);
+    if (it != t.ids.end())
+      return it->second;
+  }
+
+  std::unique_lock<std::shared_mutex> lk(t.mutex);
+  auto it = t.ids.find(_name);
+  if (it != t.ids.end())
+    return it->second;
+
+  if (t.ids.size() >= kMaxNames)
+    return kNoNameId;
+
+  const NameId id = static_cast<NameId>(t.ids.size());
+  it = t.ids.emplace(_name, id).first;
+  t.names[id].store(&it->first, std::memory_order_release);
+  return id;
+}
+
+//////////////////////////////////////////////////
+NameId NameTable::Find(const std::string &_name)
+{
+  Table &t = table();
+  std::shared_lock<std::shared_mutex> lk(t.mutex);
+  auto it = t.ids.find(_name);
+  return it == t.ids.end() ? kNoNameId : it->second;
+}
+
+//////////////////////////////////////////////////
+const std::string &NameTable::Name(const NameId _id)
+{
+  if (_id >= kMaxNames)
+    return kEmpty;
+
+  const std::string *name =
+    table().names[_id].load(std::memory_order_acquire);
+  return name ? *name : kEmpty;
+}
+
+//////////////////////////////////////////////////
+std::size_t NameTable::Size()
+{
+  Table &t = table();
+  std::shared_lock<std::shared_mutex> lk(t.mutex);
+  return t.ids.size();
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <ignition/msgs/int32.pb.h>
+#include <ignition/msgs/vector3d.pb.h>
+
+#include <string>
+
+#include "ignition/transport/MessageInfo.hh"
+#include "ignition/transport/NameTable.hh"
+#include "ignition/transport/SubscriptionHandler.hh"
+#include "ignition/transport/TransportTypes.hh"
+#include "gtest/gtest.h"
+
+using namespace ignition;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Check the identifiers of the names.
+TEST(NameTableTest, Intern)
+{
+  EXPECT_EQ(kGenericMessageTypeId, NameTable::Intern(kGenericMessageType));
+  EXPECT_EQ(kGenericMessageType, NameTable::Name(kGenericMessageTypeId));
+
+  const std::string name = "ignition.msgs.NameTableTest";
+  EXPECT_EQ(kNoNameId, NameTable::Find(name));
+
+  const std::size_t size = NameTable::Size();
+  const NameId id = NameTable::Intern(name);
+  EXPECT_NE(kNoNameId, id);
+  EXPECT_EQ(size + 1, NameTable::Size());
+  EXPECT_EQ(id, NameTable::Intern(name));
+  EXPECT_EQ(id, NameTable::Find(name));
+  EXPECT_EQ(size + 1, NameTable::Size());
+  EXPECT_EQ(name, NameTable::Name(id));
+
+  EXPECT_NE(id, NameTable::Intern(name + "2"));
+  EXPECT_TRUE(NameTable::Name(kNoNameId).empty());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the type identifiers of the messages and the handlers.
+TEST(NameTableTest, HandlerTypes)
+{
+  const std::string int32Type = msgs::Int32().GetTypeName();
+  const std::string vectorType = msgs::Vector3d().GetTypeName();
+
+  SubscriptionHandler<msgs::Int32> typed("nUuid");
+  EXPECT_EQ(int32Type, typed.TypeName());
+  EXPECT_EQ(NameTable::Find(int32Type), typed.TypeId());
+
+  SubscriptionHandler<ProtoMsg> generic("nUuid");
+  EXPECT_EQ(kGenericMessageTypeId, generic.TypeId());
+
+  RawSubscriptionHandler raw("nUuid", vectorType);
+  EXPECT_EQ(NameTable::Find(vectorType), raw.TypeId());
+
+  MessageInfo info;
+  EXPECT_EQ(kNoNameId, info.TypeId());
+  info.SetType(int32Type);
+  EXPECT_EQ(typed.TypeId(), info.TypeId());
+  EXPECT_EQ(int32Type, info.Type());
+
+  EXPECT_TRUE(typed.AcceptsType(info.TypeId(), info.Type()));
+  EXPECT_TRUE(generic.AcceptsType(info.TypeId(), info.Type()));
+  EXPECT_FALSE(raw.AcceptsType(info.TypeId(), info.Type()));
+
+  // Types that are not interned are compared by name.
+  EXPECT_TRUE(typed.AcceptsType(kNoNameId, int32Type));
+  EXPECT_FALSE(typed.AcceptsType(kNoNameId, vectorType));
+  EXPECT_TRUE(generic.AcceptsType(kNoNameId, vectorType));
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,19 +17,24 @@
 #include <ignition/msgs/discovery.pb.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <csignal>
 #include <condition_variable>
+#include <future>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
 
+#include "ignition/transport/MessageFilter.hh"
 #include "ignition/transport/MessageInfo.hh"
+#include "ignition/transport/NameTable.hh"
 #include "ignition/transport/Node.hh"
 #include "ignition/transport/NodeOptions.hh"
 #include "ignition/transport/NodeShared.hh"
@@ -37,8 +42,12 @@
 #include "ignition/transport/TransportTypes.hh"
 #include "ignition/transport/Uuid.hh"
 
+#include "BatchPrivate.hh"
+#include "FlowControlPrivate.hh"
 #include "NodePrivate.hh"
 #include "NodeSharedPrivate.hh"
+#include "SenderFramePrivate.hh"
+#include "StatisticsPrivate.hh"
 
 #ifdef _MSC_VER
 #pragma warning(disable: 4503)
@@ -103,8 +112,157 @@ namespace ignition
       /// \param[in] _publisher The message publisher.
       public: explicit PublisherPrivate(const MessagePublisher &_publisher)
         : shared(NodeShared::Instance()),
-          publisher(_publisher)
+          publisher(_publisher),
+          msgTypeId(NameTable::Intern(_publisher.MsgTypeName())),
+          uuid(Uuid().ToString())
       {
+        const bool highPriority =
+          this->publisher.Options().Priority() == Priority_t::HIGH;
+        const std::string &address = highPriority ?
+          this->shared->dataPtr->priorityAddress : this->shared->myAddress;
+        this->senderFrame.reset(new SenderFrame(address, this->uuid));
+        this->batchSenderFrame.reset(
+          new SenderFrame(address, this->uuid, true));
+
+        this->topicInfo.SetTopicAndPartition(this->publisher.Topic());
+        this->topicInfo.SetType(this->publisher.MsgTypeName());
+
+        if (StatisticsEnabled())
+        {
+          this->counters = std::make_shared<EndpointCounters>();
+          this->shared->dataPtr->AddPublisherStatistics(
+            this->publisher, this->counters);
+        }
+
+        const AdvertiseMessageOptions &opts = this->publisher.Options();
+        if (opts.SendBufferLimit() > 0)
+        {
+          this->sendBudget = std::make_shared<SendBudget>(
+            opts.SendBufferLimit(), opts.FlowControl(),
+            std::chrono::milliseconds(opts.FlowControlTimeout()));
+        }
+      }
+
+      /// \brief Send serialized data to the remote subscribers, applying the
+      /// flow control of the publisher.
+      /// \param[in] _data Serialized data, released with _ffn.
+      /// \param[in] _dataSize Data size (bytes).
+      /// \param[in] _ffn Deallocation function of _data.
+      /// \param[in] _hint Argument passed to _ffn.
+      /// \param[in] _msgType Message type.
+      /// \param[in] _header Publication time, sequence number and publisher.
+      /// \param[in] _count Number of messages in _data, if it is a batch, or
+      /// zero otherwise.
+      /// \return False if the data could not be sent. Data dropped by the
+      /// drop policy of the flow control is not an error, but a timeout of
+      /// the block policy is.
+      public: bool PublishRemote(char *_data, const std::size_t _dataSize,
+                                 DeallocFunc *_ffn, void *_hint,
+                                 const std::string &_msgType,
+                                 const MessageInfo &_header,
+                                 const uint64_t _count = 0)
+      {
+        const uint64_t msgCount = std::max<uint64_t>(_count, 1u);
+
+        if (this->sendBudget)
+        {
+          if (!this->sendBudget->Acquire(_dataSize))
+          {
+            _ffn(_data, _hint);
+            this->flowControlDrops.fetch_add(msgCount);
+            if (this->counters)
+              this->counters->AddDrop(msgCount);
+
+            // Dropping is the expected behavior of the drop policy, but the
+            // block policy promises to deliver every message.
+            if (this->sendBudget->Policy() == FlowControl_t::DROP)
+              return true;
+
+            std::cerr << "Node::Publisher::Publish(): Timeout waiting for "
+                      << "the remote subscribers of topic ["
+                      << this->publisher.Topic() << "]. The message was "
+                      << "dropped." << std::endl;
+            return false;
+          }
+
+          _hint = new BudgetedBuffer{_ffn, _hint, this->sendBudget, _dataSize};
+          _ffn = releaseBudgetedBuffer;
+        }
+
+        // The frames are shared by all the messages of this publisher, so
+        // they are updated and sent under senderMutex.
+        std::lock_guard<std::mutex> lk(this->senderMutex);
+        SenderFrame &sender =
+          _count > 0 ? *this->batchSenderFrame : *this->senderFrame;
+        sender.Update(_header, _count);
+        if (!this->shared->Publish(this->publisher.Topic(), _data, _dataSize,
+              _ffn, _hint, _msgType, &sender.Data(),
+              this->publisher.Options().Priority(),
+              !this->publisher.MulticastAddr().empty()))
+        {
+          if (this->counters)
+            this->counters->AddDrop(msgCount);
+          return false;
+        }
+        return true;
+      }
+
+      /// \brief Send a batch to the remote subscribers. If any of them does
+      /// not accept batches, the messages of the batch are sent one at a
+      /// time, sharing the buffer of the batch.
+      /// \param[in] _batch The batch (see BatchPrivate.hh), allocated with
+      /// new[]. It is released when it has been sent.
+      /// \param[in] _batchSize Size of the batch (bytes).
+      /// \param[in] _msgType Message type.
+      /// \param[in] _header Publication time, sequence number of the first
+      /// message and publisher.
+      /// \param[in] _count Number of messages published in the batch,
+      /// including the ones that were not serialized in _batch.
+      /// \return False if the data could not be sent.
+      public: bool PublishRemoteBatch(char *_batch,
+                                      const std::size_t _batchSize,
+                                      const std::string &_msgType,
+                                      const MessageInfo &_header,
+                                      const uint64_t _count)
+      {
+        auto deleteBatch = [](void *_buffer, void *)
+        {
+          delete[] reinterpret_cast<char*>(_buffer);
+        };
+
+        bool batches;
+        {
+          std::lock_guard<std::mutex> lk(this->mutex);
+          batches = this->remoteBatches;
+        }
+
+        if (batches)
+        {
+          return this->PublishRemote(_batch, _batchSize, deleteBatch,
+            nullptr, _msgType, _header, _count);
+        }
+
+        std::vector<BatchEntry> entries;
+        parseBatch(_batch, _batchSize, entries);
+
+        // Every message holds a reference to the batch, released by ZeroMQ
+        // when the message has been sent.
+        std::shared_ptr<char> batch(_batch, std::default_delete<char[]>());
+        auto releaseBatch = [](void * /*_buffer*/, void *_hint)
+        {
+          delete static_cast<std::shared_ptr<char> *>(_hint);
+        };
+
+        bool sent = true;
+        MessageInfo header(_header);
+        for (const BatchEntry &entry : entries)
+        {
+          header.SetSequenceNumber(_header.SequenceNumber() + entry.index);
+          sent = this->PublishRemote(const_cast<char *>(entry.data),
+            entry.size, releaseBatch, new std::shared_ptr<char>(batch),
+            _msgType, header) && sent;
+        }
+        return sent;
       }
 
       /// \brief Check if this Publisher is ready to send an update based on
@@ -144,6 +302,227 @@ namespace ignition
         return true;
       }
 
+      /// \brief Count the nodes subscribed to this publisher, in this
+      /// process or in remote ones.
+      /// \return The number of subscribed nodes.
+      public: std::size_t SubscriberCount() const
+      {
+        const std::string &topic = this->publisher.Topic();
+        const std::string &msgType = this->publisher.MsgTypeName();
+
+        std::lock_guard<std::recursive_mutex> lk(this->shared->mutex);
+
+        // A node with several handlers only counts once.
+        const auto localNodes =
+          this->shared->localSubscribers.NodeUuids(topic, msgType);
+        std::size_t count = std::unordered_set<std::string>(
+          localNodes.begin(), localNodes.end()).size();
+
+        std::map<std::string, std::vector<MessagePublisher>> remoteNodes;
+        if (this->shared->remoteSubscribers.Publishers(topic, remoteNodes))
+        {
+          for (const auto &proc : remoteNodes)
+          {
+            count += std::count_if(proc.second.begin(), proc.second.end(),
+              [&msgType](const MessagePublisher &_sub)
+              {
+                return _sub.MsgTypeName() == msgType ||
+                       _sub.MsgTypeName() == kGenericMessageType;
+              });
+          }
+        }
+
+        return count;
+      }
+
+      /// \brief Check whether any remote subscriber wants a message,
+      /// according to the filters that they sent.
+      /// \param[in] _msg The message.
+      /// \return True if the message should be sent to the remote
+      /// subscribers.
+      public: bool RemoteFilterMatches(const ProtoMsg &_msg)
+      {
+        this->UpdateRemoteSubscribers();
+
+        std::shared_ptr<const std::vector<MessageFilter>> filters;
+        {
+          std::lock_guard<std::mutex> lk(this->mutex);
+          filters = this->remoteFilters;
+        }
+
+        // A remote subscriber wants every message.
+        if (!filters)
+          return true;
+
+        for (const MessageFilter &filter : *filters)
+        {
+          if (filter.Matches(_msg))
+            return true;
+        }
+        return false;
+      }
+
+      /// \brief Check whether the remote subscribers want a new message.
+      /// When all of them are throttled and want the same messages, the
+      /// messages are downsampled to the highest of their rates, so they do
+      /// not receive messages that they would discard.
+      /// \param[out] _period Downsampling period, or zero if every message is
+      /// sent.
+      /// \return True if the message should be sent to the remote
+      /// subscribers.
+      public: bool RemoteUpdateReady(std::chrono::nanoseconds &_period)
+      {
+        this->UpdateRemoteSubscribers();
+
+        std::lock_guard<std::mutex> lk(this->mutex);
+        _period = this->remotePeriod;
+        if (_period.count() == 0)
+          return true;
+
+        Timestamp now = std::chrono::steady_clock::now();
+        if (now - this->lastRemoteTimestamp < _period)
+          return false;
+
+        this->lastRemoteTimestamp = now;
+        return true;
+      }
+
+      /// \brief Update the rate, the filters and the support for batches of
+      /// the remote subscribers, if they changed since the last call.
+      public: void UpdateRemoteSubscribers()
+      {
+        const uint64_t generation =
+          this->shared->dataPtr->subscribersGeneration.load();
+        {
+          std::lock_guard<std::mutex> lk(this->mutex);
+          if (this->remoteValid && generation == this->remoteGeneration)
+            return;
+        }
+
+        const std::string &topic = this->publisher.Topic();
+        const std::string &msgType = this->publisher.MsgTypeName();
+
+        uint64_t msgsPerSec = 0;
+        bool unthrottled = false;
+        auto filters = std::make_shared<std::vector<MessageFilter>>();
+        bool unfiltered = false;
+        bool throttledFiltered = false;
+        std::set<std::string> expressions;
+        bool batches = true;
+        {
+          std::lock_guard<std::recursive_mutex> lk(this->shared->mutex);
+
+          std::map<std::string, std::vector<MessagePublisher>> remoteNodes;
+          this->shared->remoteSubscribers.Publishers(topic, remoteNodes);
+
+          const auto &remoteFilters = this->shared->dataPtr->remoteFilters;
+          auto topicFilters = remoteFilters.find(topic);
+
+          const auto &remoteBatchSupport =
+            this->shared->dataPtr->remoteBatchSupport;
+          auto topicBatches = remoteBatchSupport.find(topic);
+
+          for (const auto &proc : remoteNodes)
+          {
+            for (const auto &sub : proc.second)
+            {
+              if (sub.MsgTypeName() != msgType &&
+                  sub.MsgTypeName() != kGenericMessageType)
+              {
+                continue;
+              }
+
+              if (!sub.Options().Throttled())
+                unthrottled = true;
+              else
+                msgsPerSec = std::max(msgsPerSec, sub.Options().MsgsPerSec());
+
+              if (topicFilters == remoteFilters.end() ||
+                  topicFilters->second.find(sub.NUuid()) ==
+                    topicFilters->second.end())
+              {
+                unfiltered = true;
+                expressions.insert("");
+              }
+              else
+              {
+                const MessageFilter &filter =
+                  topicFilters->second.at(sub.NUuid()).second;
+                filters->push_back(filter);
+                expressions.insert(filter.Expression());
+                throttledFiltered =
+                  throttledFiltered || sub.Options().Throttled();
+              }
+
+              if (topicBatches == remoteBatchSupport.end() ||
+                  topicBatches->second.find(sub.NUuid()) ==
+                    topicBatches->second.end())
+              {
+                batches = false;
+              }
+            }
+          }
+        }
+
+        // A single downsampling slot can only be shared by subscribers that
+        // want the same messages. Otherwise, the messages of one filter could
+        // always take the slot of the messages of another, so the throttled
+        // subscribers with filters throttle on their side instead.
+        const bool sharedSlot = !throttledFiltered || expressions.size() == 1;
+
+        std::chrono::nanoseconds period(0);
+        if (!unthrottled && sharedSlot && msgsPerSec > 0)
+        {
+          period = std::chrono::nanoseconds(
+            static_cast<int64_t>(1e9 / static_cast<double>(msgsPerSec)));
+        }
+
+        std::lock_guard<std::mutex> lk(this->mutex);
+        this->remotePeriod = period;
+        if (unfiltered)
+          this->remoteFilters.reset();
+        else
+          this->remoteFilters = filters;
+        this->remoteBatches = batches;
+        this->remoteGeneration = generation;
+        this->remoteValid = true;
+      }
+
+      /// \brief Block until there are enough subscribers.
+      /// \param[in] _count Number of subscribed nodes to wait for.
+      /// \param[in] _timeout Maximum time to wait.
+      /// \return True if there are at least _count subscribers.
+      public: bool WaitForSubscribers(const unsigned int _count,
+                  const std::chrono::milliseconds &_timeout) const
+      {
+        NodeSharedPrivate &sharedPrivate = *this->shared->dataPtr;
+        const auto deadline = std::chrono::steady_clock::now() + _timeout;
+
+        while (true)
+        {
+          // Read the generation before counting, so that a change between
+          // both is not missed.
+          uint64_t generation;
+          {
+            std::lock_guard<std::mutex> lk(sharedPrivate.subscribersMutex);
+            generation = sharedPrivate.subscribersGeneration;
+          }
+
+          if (this->SubscriberCount() >= _count)
+            return true;
+
+          std::unique_lock<std::mutex> lk(sharedPrivate.subscribersMutex);
+          if (!sharedPrivate.subscribersCondition.wait_until(lk, deadline,
+                [&]
+                {
+                  return sharedPrivate.subscribersGeneration != generation;
+                }))
+          {
+            return false;
+          }
+        }
+      }
+
       /// \brief Check if this Publisher is valid
       /// \return True if we have a topic to publish to, otherwise false.
       public: bool Valid()
@@ -164,18 +543,31 @@ namespace ignition
         }
       }
 
-      /// \brief Create a MessageInfo object for this Publisher
-      MessageInfo CreateMessageInfo()
+      /// \brief Set the publication time, the next sequence number and the
+      /// publisher UUID of a message about to be published.
+      /// \param[out] _info Information of the message.
+      /// \param[in] _count Number of messages published at once. They get
+      /// consecutive sequence numbers, and _info gets the first one.
+      public: void StampMessageInfo(MessageInfo &_info,
+                                    const uint64_t _count = 1)
       {
-        MessageInfo info;
-
-        // Set the topic and the partition at the same time
-        info.SetTopicAndPartition(this->publisher.Topic());
-
-        // Set the message type name
-        info.SetType(this->publisher.MsgTypeName());
+        _info.SetPublicationTime(std::chrono::steady_clock::now());
+        _info.SetSequenceNumber(
+          this->sequence.fetch_add(_count, std::memory_order_relaxed) + 1);
+        _info.SetPublisherUuid(this->uuid);
+      }
 
-        return info;
+      /// \brief Set the topic, the partition and the type of a message about
+      /// to be published. They are shared with topicInfo.
+      /// \param[out] _info Information of the message.
+      /// \param[in] _msgType Type of the message, which only differs from the
+      /// advertised type for generic publishers.
+      public: void SetMessageTopic(MessageInfo &_info,
+                                   const std::string &_msgType) const
+      {
+        _info.SetTopicAndType(this->topicInfo);
+        if (_msgType != this->topicInfo.Type())
+          _info.SetType(_msgType);
       }
 
       /// \brief Pointer to the object shared between all the nodes within the
@@ -185,6 +577,13 @@ namespace ignition
       /// \brief The message publisher.
       public: MessagePublisher publisher;
 
+      /// \brief Identifier of the message type of the publisher.
+      public: NameId msgTypeId = kNoNameId;
+
+      /// \brief Topic, partition and type of the messages, set once and
+      /// shared by the MessageInfo of each message published.
+      public: MessageInfo topicInfo;
+
       /// \brief Timestamp of the last callback executed.
       public: Timestamp lastCbTimestamp;
 
@@ -194,6 +593,55 @@ namespace ignition
 
       /// \brief Mutex to protect the node::publisher from race conditions.
       public: mutable std::mutex mutex;
+
+      /// \brief Statistics of this publisher, or nullptr if the statistics
+      /// are disabled.
+      public: std::shared_ptr<EndpointCounters> counters;
+
+      /// \brief Unique identifier of this publisher, sent with every message.
+      public: std::string uuid;
+
+      /// \brief Sender frame of the single messages sent to the remote
+      /// subscribers.
+      public: std::unique_ptr<SenderFrame> senderFrame;
+
+      /// \brief Sender frame of the batches sent to the remote subscribers.
+      public: std::unique_ptr<SenderFrame> batchSenderFrame;
+
+      /// \brief Protects the sender frames while a message is sent.
+      public: std::mutex senderMutex;
+
+      /// \brief Sequence number of the last message published.
+      public: std::atomic<uint64_t> sequence{0};
+
+      /// \brief Downsampling period for the remote subscribers.
+      public: std::chrono::nanoseconds remotePeriod{0};
+
+      /// \brief Filters of the remote subscribers, or nullptr if any of them
+      /// wants every message.
+      public: std::shared_ptr<const std::vector<MessageFilter>> remoteFilters;
+
+      /// \brief Whether all the remote subscribers accept batches.
+      public: bool remoteBatches = false;
+
+      /// \brief Value of NodeSharedPrivate::subscribersGeneration when
+      /// remotePeriod, remoteFilters and remoteBatches were computed.
+      public: uint64_t remoteGeneration = 0;
+
+      /// \brief Whether remotePeriod, remoteFilters and remoteBatches have
+      /// been computed.
+      public: bool remoteValid = false;
+
+      /// \brief Time of the last message sent to the remote subscribers
+      /// while downsampling.
+      public: Timestamp lastRemoteTimestamp;
+
+      /// \brief Bytes pending to be sent to the remote subscribers, or
+      /// nullptr if the send buffer is not limited.
+      public: std::shared_ptr<SendBudget> sendBudget;
+
+      /// \brief Number of messages dropped by the flow control.
+      public: std::atomic<uint64_t> flowControlDrops{0};
     };
     }
   }
@@ -258,6 +706,37 @@ bool Node::Publisher::HasConnections() const
      this->dataPtr->shared->remoteSubscribers.HasTopic(topic, msgType));
 }
 
+//////////////////////////////////////////////////
+bool Node::Publisher::WaitForSubscribers(const unsigned int _count,
+    const unsigned int _timeout) const
+{
+  if (!this->Valid())
+    return false;
+
+  return this->dataPtr->WaitForSubscribers(_count,
+    std::chrono::milliseconds(_timeout));
+}
+
+//////////////////////////////////////////////////
+std::future<bool> Node::Publisher::WaitForSubscribersAsync(
+    const unsigned int _count, const unsigned int _timeout) const
+{
+  if (!this->Valid())
+  {
+    std::promise<bool> invalid;
+    invalid.set_value(false);
+    return invalid.get_future();
+  }
+
+  // The task keeps the publisher alive until it finishes.
+  std::shared_ptr<PublisherPrivate> publisher = this->dataPtr;
+  return std::async(std::launch::async, [publisher, _count, _timeout]
+    {
+      return publisher->WaitForSubscribers(_count,
+        std::chrono::milliseconds(_timeout));
+    });
+}
+
 //////////////////////////////////////////////////
 bool Node::Publisher::Publish(const ProtoMsg &_msg)
 {
@@ -267,7 +746,8 @@ bool Node::Publisher::Publish(const ProtoMsg &_msg)
   const std::string &publisherMsgType = this->dataPtr->publisher.MsgTypeName();
 
   // Check that the msg type matches the topic type previously advertised.
-  if (publisherMsgType != _msg.GetTypeName())
+  // The descriptor returns a reference to the name, unlike GetTypeName().
+  if (publisherMsgType != _msg.GetDescriptor()->full_name())
   {
     std::cerr << "Node::Publisher::Publish() Type mismatch.\n"
               << "\t* Type advertised: "
@@ -278,14 +758,33 @@ bool Node::Publisher::Publish(const ProtoMsg &_msg)
 
   // Check the publication throttling option.
   if (!this->UpdateThrottling())
+  {
+    if (this->dataPtr->counters)
+      this->dataPtr->counters->AddDrop();
     return true;
+  }
 
   const std::string &publisherTopic = this->dataPtr->publisher.Topic();
 
-  const NodeShared::SubscriberInfo &subscribers =
+  // Time, sequence number and publisher of this message.
+  MessageInfo header;
+  this->dataPtr->StampMessageInfo(header);
+
+  NodeShared::SubscriberInfo subscribers =
       this->dataPtr->shared->CheckSubscriberInfo(
         publisherTopic, publisherMsgType);
 
+  // Skip the remote subscribers if the message does not match their filters
+  // or if they are throttled and do not need this message yet.
+  std::chrono::nanoseconds downsamplingPeriod(0);
+  if (subscribers.haveRemote)
+  {
+    subscribers.haveRemote =
+      this->dataPtr->RemoteFilterMatches(_msg) &&
+      this->dataPtr->RemoteUpdateReady(downsamplingPeriod);
+    header.SetDownsamplingPeriod(downsamplingPeriod);
+  }
+
   // The serialized message size and buffer.
 #if GOOGLE_PROTOBUF_VERSION < 3001000
   const std::size_t msgSize = static_cast<std::size_t>(_msg.ByteSize());
@@ -324,72 +823,71 @@ bool Node::Publisher::Publish(const ProtoMsg &_msg)
     // This must be a shared pointer so that we can pass it to
     // multiple threads below, and then allow this function to go
     // out of scope.
-    pubMsgDetails->info.SetTopicAndPartition(this->dataPtr->publisher.Topic());
-    pubMsgDetails->info.SetType(this->dataPtr->publisher.MsgTypeName());
+    pubMsgDetails->info.SetTopicAndType(this->dataPtr->topicInfo);
     pubMsgDetails->info.SetIntraProcess(true);
+    pubMsgDetails->info.SetPublicationTime(header.PublicationTime());
+    pubMsgDetails->info.SetSequenceNumber(header.SequenceNumber());
+    pubMsgDetails->info.SetPublisherUuid(header.PublisherUuid());
+    pubMsgDetails->info.SetSize(msgSize);
+    pubMsgDetails->msgSize = msgSize;
+    pubMsgDetails->counters = this->dataPtr->counters;
 
     pubMsgDetails->msgCopy.reset(_msg.New());
     pubMsgDetails->msgCopy->CopyFrom(_msg);
 
     if (subscribers.haveLocal)
     {
-      for (const std::pair<std::string, ISubscriptionHandler_M> &node :
-           subscribers.localHandlers)
+      for (const auto &entry : *subscribers.localHandlers)
       {
-        for (const std::pair<std::string, ISubscriptionHandlerPtr> &handler :
-             node.second)
+        if (!entry.handler)
         {
-          if (!handler.second)
-          {
-            std::cerr << "Node::Publisher::Publish(): "
-                      << "NULL local subscription handler" << std::endl;
-            continue;
-          }
-
-          if (handler.second->TypeName() != kGenericMessageType &&
-              handler.second->TypeName() != _msg.GetTypeName())
-          {
-            continue;
-          }
+          std::cerr << "Node::Publisher::Publish(): "
+                    << "NULL local subscription handler" << std::endl;
+          continue;
+        }
 
-          pubMsgDetails->localHandlers.push_back(handler.second);
+        if (!entry.handler->AcceptsType(
+              this->dataPtr->msgTypeId, publisherMsgType))
+        {
+          continue;
         }
+
+        pubMsgDetails->localHandlers.push_back(entry.handler);
       }
     }
 
     if (subscribers.haveRaw)
     {
-      for (auto &node : subscribers.rawHandlers)
+      for (const auto &entry : *subscribers.rawHandlers)
       {
-        for (auto &handler : node.second)
-        {
-          const RawSubscriptionHandlerPtr &rawHandler = handler.second;
+        const RawSubscriptionHandlerPtr &rawHandler = entry.handler;
 
-          if (!rawHandler)
-          {
-            std::cerr << "Node::Publisher::Publish(): "
-                      << "NULL raw subscription handler" << std::endl;
-            continue;
-          }
+        if (!rawHandler)
+        {
+          std::cerr << "Node::Publisher::Publish(): "
+                    << "NULL raw subscription handler" << std::endl;
+          continue;
+        }
 
-          if (rawHandler->TypeName() != kGenericMessageType &&
-              rawHandler->TypeName() != _msg.GetTypeName())
-          {
-            continue;
-          }
+        if (!rawHandler->AcceptsType(
+              this->dataPtr->msgTypeId, publisherMsgType))
+        {
+          continue;
+        }
 
-          if (!pubMsgDetails->sharedBuffer)
-          {
-            pubMsgDetails->msgSize = msgSize;
-            // If the sharedBuffer has not been created, do so now.
-            pubMsgDetails->sharedBuffer.reset(new char[msgSize]);
-            memcpy(pubMsgDetails->sharedBuffer.get(), msgBuffer, msgSize);
-          }
-          pubMsgDetails->rawHandlers.push_back(rawHandler);
+        if (!pubMsgDetails->sharedBuffer)
+        {
+          // If the sharedBuffer has not been created, do so now.
+          pubMsgDetails->sharedBuffer.reset(new char[msgSize]);
+          memcpy(pubMsgDetails->sharedBuffer.get(), msgBuffer, msgSize);
         }
+        pubMsgDetails->rawHandlers.push_back(rawHandler);
       }
     }
 
+    if (this->dataPtr->counters)
+      this->dataPtr->counters->AddQueued(1);
+
     // Add the publish message details to the publish queue. The message
     // will be published asynchronously to the local and raw callbacks.
     {
@@ -411,8 +909,8 @@ bool Node::Publisher::Publish(const ProtoMsg &_msg)
       delete[] reinterpret_cast<char*>(_buffer);
     };
 
-    if (!this->dataPtr->shared->Publish(this->dataPtr->publisher.Topic(),
-          msgBuffer, msgSize, myDeallocator, _msg.GetTypeName()))
+    if (!this->dataPtr->PublishRemote(msgBuffer, msgSize, myDeallocator,
+          nullptr, _msg.GetTypeName(), header))
     {
       return false;
     }
@@ -422,6 +920,9 @@ bool Node::Publisher::Publish(const ProtoMsg &_msg)
     delete[] msgBuffer;
   }
 
+  if (this->dataPtr->counters)
+    this->dataPtr->counters->AddMessage(msgSize);
+
   return true;
 }
 
@@ -429,6 +930,16 @@ bool Node::Publisher::Publish(const ProtoMsg &_msg)
 bool Node::Publisher::PublishRaw(
     const std::string &_msgData,
     const std::string &_msgType)
+{
+  return this->PublishRaw(_msgData.data(), _msgData.size(), _msgType, nullptr);
+}
+
+//////////////////////////////////////////////////
+bool Node::Publisher::PublishRaw(
+    const char *_msgData,
+    const std::size_t _msgSize,
+    const std::string &_msgType,
+    const std::shared_ptr<const void> &_owner)
 {
   if (!this->dataPtr->Valid())
     return false;
@@ -445,45 +956,355 @@ bool Node::Publisher::PublishRaw(
   }
 
   if (!this->dataPtr->UpdateThrottling())
+  {
+    if (this->dataPtr->counters)
+      this->dataPtr->counters->AddDrop();
     return true;
+  }
 
   const std::string &topic = this->dataPtr->publisher.Topic();
 
-  const NodeShared::SubscriberInfo &subscribers =
+  NodeShared::SubscriberInfo subscribers =
       this->dataPtr->shared->CheckSubscriberInfo(topic, _msgType);
 
   MessageInfo info;
-  info.SetTopicAndPartition(topic);
-  info.SetType(_msgType);
+  this->dataPtr->SetMessageTopic(info, _msgType);
   info.SetIntraProcess(true);
+  info.SetSize(_msgSize);
+  info.SetReceptionTime(std::chrono::steady_clock::now());
+  this->dataPtr->StampMessageInfo(info);
 
   // Trigger local subscribers.
-  this->dataPtr->shared->TriggerCallbacks(info, _msgData, subscribers);
+  this->dataPtr->shared->TriggerCallbacks(
+      info, _msgData, _msgSize, subscribers);
 
   // Remote subscribers. Note that the data is already presumed to be
-  // serialized, so we just pass it along for publication.
-  if (subscribers.haveRemote)
+  // serialized, so we just pass it along for publication. Skip them if they
+  // are throttled and do not need this message yet.
+  std::chrono::nanoseconds downsamplingPeriod(0);
+  if (!subscribers.haveRemote ||
+      !this->dataPtr->RemoteUpdateReady(downsamplingPeriod))
+  {
+    if (this->dataPtr->counters)
+      this->dataPtr->counters->AddMessage(_msgSize);
+    return true;
+  }
+  info.SetDownsamplingPeriod(downsamplingPeriod);
+
+  bool sent;
+  if (_owner)
   {
-    const std::size_t msgSize = _msgData.size();
-    char *msgBuffer = static_cast<char *>(new char[msgSize]);
-    memcpy(msgBuffer, _msgData.c_str(), msgSize);
+    // Zero copy: ZeroMQ keeps a reference to the owner of the buffer until
+    // the data has been sent. ZeroMQ does not modify the buffer.
+    auto releaseOwner = [](void * /*_buffer*/, void *_hint)
+    {
+      delete static_cast<std::shared_ptr<const void> *>(_hint);
+    };
+
+    sent = this->dataPtr->PublishRemote(
+        const_cast<char *>(_msgData), _msgSize, releaseOwner,
+        new std::shared_ptr<const void>(_owner), _msgType, info);
+  }
+  else
+  {
+    char *msgBuffer = static_cast<char *>(new char[_msgSize]);
+    memcpy(msgBuffer, _msgData, _msgSize);
     auto myDeallocator = [](void *_buffer, void * /*_hint*/)
     {
       delete[] reinterpret_cast<char*>(_buffer);
     };
 
     // Note: This will copy _msgData (i.e. not zero copy)
-    if (!this->dataPtr->shared->Publish(
-          this->dataPtr->publisher.Topic(),
-          msgBuffer, msgSize, myDeallocator, _msgType))
+    sent = this->dataPtr->PublishRemote(
+        msgBuffer, _msgSize, myDeallocator, nullptr, _msgType, info);
+  }
+
+  if (sent && this->dataPtr->counters)
+    this->dataPtr->counters->AddMessage(_msgSize);
+
+  return sent;
+}
+
+//////////////////////////////////////////////////
+bool Node::Publisher::PublishBatch(const std::vector<const ProtoMsg *> &_msgs)
+{
+  if (!this->Valid())
+    return false;
+
+  const std::string &publisherMsgType = this->dataPtr->publisher.MsgTypeName();
+
+  // Check that the msg types match the topic type previously advertised.
+  for (const ProtoMsg *msg : _msgs)
+  {
+    if (!msg || publisherMsgType != msg->GetTypeName())
+    {
+      std::cerr << "Node::Publisher::PublishBatch() Type mismatch.\n"
+                << "\t* Type advertised: " << publisherMsgType
+                << "\n\t* Type published: "
+                << (msg ? msg->GetTypeName() : "null") << std::endl;
+      return false;
+    }
+  }
+
+  if (_msgs.empty())
+    return true;
+
+  const uint64_t count = _msgs.size();
+
+  // The whole batch counts as a single publication.
+  if (!this->UpdateThrottling())
+  {
+    if (this->dataPtr->counters)
+      this->dataPtr->counters->AddDrop(count);
+    return true;
+  }
+
+  // Time, sequence number of the first message and publisher of the batch.
+  MessageInfo header;
+  this->dataPtr->StampMessageInfo(header, count);
+
+  NodeShared::SubscriberInfo subscribers =
+      this->dataPtr->shared->CheckSubscriberInfo(
+        this->dataPtr->publisher.Topic(), publisherMsgType);
+
+  // Messages wanted by the remote subscribers, according to their filters.
+  std::vector<bool> remoteWanted(_msgs.size(), true);
+  std::chrono::nanoseconds downsamplingPeriod(0);
+  if (subscribers.haveRemote)
+  {
+    bool anyWanted = false;
+    for (std::size_t i = 0; i < _msgs.size(); ++i)
+    {
+      remoteWanted[i] = this->dataPtr->RemoteFilterMatches(*_msgs[i]);
+      anyWanted = anyWanted || remoteWanted[i];
+    }
+
+    subscribers.haveRemote =
+      anyWanted && this->dataPtr->RemoteUpdateReady(downsamplingPeriod);
+    header.SetDownsamplingPeriod(downsamplingPeriod);
+  }
+
+  std::vector<std::size_t> sizes;
+  sizes.reserve(_msgs.size());
+  std::size_t batchSize = 0;
+  std::size_t remoteSize = 0;
+  for (std::size_t i = 0; i < _msgs.size(); ++i)
+  {
+#if GOOGLE_PROTOBUF_VERSION < 3001000
+    sizes.push_back(static_cast<std::size_t>(_msgs[i]->ByteSize()));
+#else
+    sizes.push_back(static_cast<std::size_t>(_msgs[i]->ByteSizeLong()));
+#endif
+    batchSize += kBatchEntryPrefixSize + sizes.back();
+    if (remoteWanted[i])
+      remoteSize += kBatchEntryPrefixSize + sizes.back();
+  }
+
+  // Serialize the messages in a single buffer, skipping the ones not wanted.
+  auto serialize = [&](char *_buffer, const std::vector<bool> *_wanted)
+  {
+    char *dst = _buffer;
+    for (std::size_t i = 0; i < _msgs.size(); ++i)
+    {
+      if (_wanted && !(*_wanted)[i])
+        continue;
+
+      writeBatchEntryPrefix(dst, static_cast<uint32_t>(i),
+        static_cast<uint32_t>(sizes[i]));
+      dst += kBatchEntryPrefixSize;
+      if (!_msgs[i]->SerializeToArray(dst, static_cast<int>(sizes[i])))
+        return false;
+      dst += sizes[i];
+    }
+    return true;
+  };
+
+  // Serialize everything before delivering anything, so we do not send a
+  // corrupt batch to some subscribers and not others.
+  std::unique_ptr<char[]> rawBuffer;
+  if (subscribers.haveRaw)
+  {
+    rawBuffer.reset(new char[batchSize]);
+    if (!serialize(rawBuffer.get(), nullptr))
     {
+      std::cerr << "Node::Publisher::PublishBatch(): Error serializing data"
+                << std::endl;
       return false;
     }
   }
 
+  char *remoteBuffer = nullptr;
+  if (subscribers.haveRemote)
+  {
+    remoteBuffer = new char[remoteSize];
+    if (!serialize(remoteBuffer, &remoteWanted))
+    {
+      delete[] remoteBuffer;
+      std::cerr << "Node::Publisher::PublishBatch(): Error serializing data"
+                << std::endl;
+      return false;
+    }
+  }
+
+  // Local and raw subscribers.
+  if (subscribers.haveLocal || subscribers.haveRaw)
+  {
+    std::unique_ptr<NodeSharedPrivate::PublishMsgDetails> pubMsgDetails(
+      new NodeSharedPrivate::PublishMsgDetails);
+
+    pubMsgDetails->info.SetTopicAndType(this->dataPtr->topicInfo);
+    pubMsgDetails->info.SetIntraProcess(true);
+    pubMsgDetails->info.SetPublicationTime(header.PublicationTime());
+    pubMsgDetails->info.SetSequenceNumber(header.SequenceNumber());
+    pubMsgDetails->info.SetPublisherUuid(header.PublisherUuid());
+    pubMsgDetails->msgSize = batchSize;
+    pubMsgDetails->counters = this->dataPtr->counters;
+    pubMsgDetails->sharedBuffer = std::move(rawBuffer);
+
+    pubMsgDetails->batchCopies.reserve(_msgs.size());
+    for (const ProtoMsg *msg : _msgs)
+    {
+      pubMsgDetails->batchCopies.emplace_back(msg->New());
+      pubMsgDetails->batchCopies.back()->CopyFrom(*msg);
+    }
+
+    for (const auto &entry : *subscribers.localHandlers)
+    {
+      if (entry.handler && entry.handler->AcceptsType(
+            this->dataPtr->msgTypeId, publisherMsgType))
+      {
+        pubMsgDetails->localHandlers.push_back(entry.handler);
+      }
+    }
+
+    for (const auto &entry : *subscribers.rawHandlers)
+    {
+      if (entry.handler && entry.handler->AcceptsType(
+            this->dataPtr->msgTypeId, publisherMsgType))
+      {
+        pubMsgDetails->rawHandlers.push_back(entry.handler);
+      }
+    }
+
+    if (this->dataPtr->counters)
+      this->dataPtr->counters->AddQueued(1);
+
+    {
+      std::unique_lock<std::mutex> queueLock(
+          this->dataPtr->shared->dataPtr->pubThreadMutex);
+      this->dataPtr->shared->dataPtr->pubQueue.push(std::move(pubMsgDetails));
+    }
+
+    this->dataPtr->shared->dataPtr->signalNewPub.notify_one();
+  }
+
+  // Handle remote subscribers. The batch goes out in the data frame of a
+  // single ZeroMQ message, and ZeroMQ releases the buffer when it has been
+  // sent.
+  if (subscribers.haveRemote &&
+      !this->dataPtr->PublishRemoteBatch(remoteBuffer, remoteSize,
+        publisherMsgType, header, count))
+  {
+    return false;
+  }
+
+  if (this->dataPtr->counters)
+    this->dataPtr->counters->AddMessage(batchSize, count);
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Node::Publisher::PublishRawBatch(
+    const std::vector<std::string> &_msgData,
+    const std::string &_msgType)
+{
+  if (!this->dataPtr->Valid())
+    return false;
+
+  const std::string &publisherMsgType = this->dataPtr->publisher.MsgTypeName();
+
+  if (publisherMsgType  != _msgType && publisherMsgType != kGenericMessageType)
+  {
+    std::cerr << "Node::Publisher::PublishRawBatch() type mismatch.\n"
+              << "\t* Type advertised: " << publisherMsgType
+              << "\n\t* Type published: " << _msgType << std::endl;
+    return false;
+  }
+
+  if (_msgData.empty())
+    return true;
+
+  const uint64_t count = _msgData.size();
+
+  if (!this->dataPtr->UpdateThrottling())
+  {
+    if (this->dataPtr->counters)
+      this->dataPtr->counters->AddDrop(count);
+    return true;
+  }
+
+  std::size_t batchSize = 0;
+  for (const std::string &data : _msgData)
+    batchSize += kBatchEntryPrefixSize + data.size();
+
+  char *batchBuffer = new char[batchSize];
+  char *dst = batchBuffer;
+  for (std::size_t i = 0; i < _msgData.size(); ++i)
+  {
+    writeBatchEntryPrefix(dst, static_cast<uint32_t>(i),
+      static_cast<uint32_t>(_msgData[i].size()));
+    dst += kBatchEntryPrefixSize;
+    memcpy(dst, _msgData[i].data(), _msgData[i].size());
+    dst += _msgData[i].size();
+  }
+
+  const std::string &topic = this->dataPtr->publisher.Topic();
+
+  NodeShared::SubscriberInfo subscribers =
+      this->dataPtr->shared->CheckSubscriberInfo(topic, _msgType);
+
+  MessageInfo info;
+  this->dataPtr->SetMessageTopic(info, _msgType);
+  info.SetIntraProcess(true);
+  info.SetReceptionTime(std::chrono::steady_clock::now());
+  this->dataPtr->StampMessageInfo(info, count);
+
+  // Trigger local subscribers.
+  this->dataPtr->shared->TriggerBatchCallbacks(
+      info, batchBuffer, batchSize, subscribers);
+
+  // Skip the remote subscribers if they are throttled and do not need this
+  // batch yet.
+  std::chrono::nanoseconds downsamplingPeriod(0);
+  if (!subscribers.haveRemote ||
+      !this->dataPtr->RemoteUpdateReady(downsamplingPeriod))
+  {
+    delete[] batchBuffer;
+    if (this->dataPtr->counters)
+      this->dataPtr->counters->AddMessage(batchSize, count);
+    return true;
+  }
+  info.SetDownsamplingPeriod(downsamplingPeriod);
+
+  if (!this->dataPtr->PublishRemoteBatch(batchBuffer, batchSize, _msgType,
+        info, count))
+  {
+    return false;
+  }
+
+  if (this->dataPtr->counters)
+    this->dataPtr->counters->AddMessage(batchSize, count);
+
   return true;
 }
 
+//////////////////////////////////////////////////
+uint64_t Node::Publisher::FlowControlDrops() const
+{
+  return this->dataPtr->flowControlDrops.load();
+}
+
 //////////////////////////////////////////////////
 bool Node::Publisher::ThrottledUpdateReady() const
 {
@@ -506,6 +1327,9 @@ Node::Node(const NodeOptions &_options)
 
   // Save the options.
   this->dataPtr->options = _options;
+
+  // Publish the statistics if IGN_TRANSPORT_STATS=1.
+  this->dataPtr->shared->StartStatistics();
 }
 
 //////////////////////////////////////////////////
@@ -605,12 +1429,21 @@ bool Node::Unsubscribe(const std::string &_topic)
   // Remove the topic from the list of subscribed topics in this node.
   this->dataPtr->topicsSubscribed.erase(fullyQualifiedTopic);
 
+  this->dataPtr->shared->dataPtr->NotifySubscribersChanged();
+
   // Remove the filter for this topic if I am the last subscriber.
   if (!this->dataPtr->shared->localSubscribers
       .HasSubscriber(fullyQualifiedTopic))
   {
     this->dataPtr->shared->dataPtr->subscriber->setsockopt(
       ZMQ_UNSUBSCRIBE, fullyQualifiedTopic.data(), fullyQualifiedTopic.size());
+    this->dataPtr->shared->dataPtr->prioritySubscriber->setsockopt(
+      ZMQ_UNSUBSCRIBE, fullyQualifiedTopic.data(), fullyQualifiedTopic.size());
+    this->dataPtr->shared->dataPtr->multicastSubscriber->setsockopt(
+      ZMQ_UNSUBSCRIBE, fullyQualifiedTopic.data(), fullyQualifiedTopic.size());
+    this->dataPtr->shared->dataPtr->multicastSequences.erase(
+      fullyQualifiedTopic);
+    this->dataPtr->shared->dataPtr->topicInfos.erase(fullyQualifiedTopic);
   }
 
   // Notify to the publishers that I am no longer interested in the topic.
@@ -955,10 +1788,20 @@ Node::Publisher Node::Advertise(const std::string &_topic,
   std::lock_guard<std::recursive_mutex> lk(this->Shared()->mutex);
 
   // Notify the discovery service to register and advertise my topic.
+  // High priority topics are sent through their own socket.
   MessagePublisher publisher(fullyQualifiedTopic,
-      this->Shared()->myAddress,
+      _options.Priority() == Priority_t::HIGH ?
+        this->Shared()->dataPtr->priorityAddress : this->Shared()->myAddress,
       this->Shared()->myControlAddress,
       this->Shared()->pUuid, this->NodeUuid(), _msgTypeName, _options);
+  publisher.SetIpcAddr(_options.Priority() == Priority_t::HIGH ?
+    this->Shared()->dataPtr->priorityIpcAddress :
+    this->Shared()->dataPtr->ipcAddress);
+  if (_options.Multicast())
+  {
+    publisher.SetMulticastAddr(this->Shared()->dataPtr->EnableMulticast(
+      this->Shared()->hostAddr, this->Shared()->pUuid));
+  }
 
   if (!this->Shared()->dataPtr->msgDiscovery->Advertise(publisher))
   {
@@ -978,6 +1821,13 @@ bool NodePrivate::SubscribeHelper(const std::string &_fullyQualifiedTopic)
   // Add the topic to the list of subscribed topics (if it was not before).
   this->topicsSubscribed.insert(_fullyQualifiedTopic);
 
+  // Set the names shared by the messages received on the topic.
+  auto &topicInfo = this->shared->dataPtr->topicInfos[_fullyQualifiedTopic];
+  if (topicInfo.Topic().empty())
+    topicInfo.SetTopicAndPartition(_fullyQualifiedTopic);
+
+  this->shared->dataPtr->NotifySubscribersChanged();
+
   // Discover the list of nodes that publish on the topic.
   if (!this->shared->dataPtr->msgDiscovery->Discover(_fullyQualifiedTopic))
   {
@@ -996,3 +1846,39 @@ bool Node::SubscribeHelper(const std::string &_fullyQualifiedTopic)
 {
   return this->dataPtr->SubscribeHelper(_fullyQualifiedTopic);
 }
+
+//////////////////////////////////////////////////
+bool Node::SubscribeHandler(const std::string &_topic,
+    const std::shared_ptr<ISubscriptionHandler> &_handler)
+{
+  // Topic remapping.
+  std::string topic = _topic;
+  this->Options().TopicRemap(_topic, topic);
+
+  std::string fullyQualifiedTopic;
+  if (!TopicUtils::FullyQualifiedName(this->dataPtr->options.Partition(),
+                                      this->dataPtr->options.NameSpace(),
+                                      topic, fullyQualifiedTopic))
+  {
+    std::cerr << "Topic [" << topic << "] is not valid." << std::endl;
+    return false;
+  }
+
+  if (!_handler->Filter().Valid())
+  {
+    std::cerr << "Filter [" << _handler->Filter().Expression()
+              << "] is not valid." << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lk(this->dataPtr->shared->mutex);
+
+  // Store the subscription handler. Each subscription handler is
+  // associated with a topic. When the receiving thread gets new data,
+  // it will recover the subscription handler associated to the topic and
+  // will invoke the callback.
+  this->dataPtr->shared->localSubscribers.normal.AddHandler(
+    fullyQualifiedTopic, this->dataPtr->nUuid, _handler);
+
+  return this->dataPtr->SubscribeHelper(fullyQualifiedTopic);
+}
@@ -23,19 +23,29 @@
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 // TODO(anyone): Remove after fixing the warnings.
 #ifdef _MSC_VER
 #pragma warning(push, 0)
 #endif
+#include <google/protobuf/arena.h>
 #include <ignition/msgs.hh>
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -44,14 +54,22 @@
 #include "ignition/transport/AdvertiseOptions.hh"
 #include "ignition/transport/Discovery.hh"
 #include "ignition/transport/Helpers.hh"
+#include "ignition/transport/MessageFilter.hh"
+#include "ignition/transport/NameTable.hh"
+#include "ignition/transport/Node.hh"
 #include "ignition/transport/NodeShared.hh"
 #include "ignition/transport/RepHandler.hh"
 #include "ignition/transport/ReqHandler.hh"
 #include "ignition/transport/SubscriptionHandler.hh"
+#include "ignition/transport/TopicUtils.hh"
 #include "ignition/transport/TransportTypes.hh"
 #include "ignition/transport/Uuid.hh"
 
+#include "BatchPrivate.hh"
 #include "NodeSharedPrivate.hh"
+#include "SenderFramePrivate.hh"
+#include "StatisticsPrivate.hh"
+#include "ThreadConfigPrivate.hh"
 
 #ifdef _MSC_VER
 # pragma warning(disable: 4503)
@@ -121,6 +139,464 @@ void sendAuthErrorHelper(zmq::socket_t &_socket, const std::string &_err)
   sendHelper(_socket, "", 0);
 }
 
+//////////////////////////////////////////////////
+// Helper to get the maximum number of messages queued for each remote
+// subscriber, from the IGN_TRANSPORT_SNDHWM environment variable. Zero,
+// the default, means no limit.
+int sendHighWaterMark()
+{
+  std::string ignSndHwm;
+  if (!env("IGN_TRANSPORT_SNDHWM", ignSndHwm))
+    return 0;
+
+  try
+  {
+    const int hwm = std::stoi(ignSndHwm);
+    if (hwm >= 0)
+      return hwm;
+  }
+  catch (...)
+  {
+  }
+
+  std::cerr << "Invalid IGN_TRANSPORT_SNDHWM value [" << ignSndHwm
+            << "]. Not limiting the send queues." << std::endl;
+  return 0;
+}
+
+//////////////////////////////////////////////////
+// Default multicast group of the topics sent through multicast.
+const char kDefaultMulticastGroup[] = "239.255.0.8";
+
+//////////////////////////////////////////////////
+// First port of the multicast topics. Each process uses a port derived from
+// its UUID, so the subscribers mostly receive the data of the publishers
+// they are connected to.
+const int kMulticastBasePort = 10400;
+
+//////////////////////////////////////////////////
+// Number of ports of the multicast topics.
+const int kMulticastPorts = 1000;
+
+//////////////////////////////////////////////////
+// Default multicast rate (kilobits per second). The ZeroMQ default is only
+// 100 kbit/s.
+const int kDefaultMulticastRate = 100000;
+
+//////////////////////////////////////////////////
+// Time (ms) during which the multicast messages can be retransmitted.
+const int kMulticastRecoveryIvl = 1000;
+
+//////////////////////////////////////////////////
+// SO_PRIORITY of the connections of the high priority topics when they are
+// marked. Values above 6 require CAP_NET_ADMIN.
+const int kPrioritySocketPriority = 6;
+
+//////////////////////////////////////////////////
+// Helper to get the IP type of service of the high priority topics, from the
+// DSCP value in the IGN_TRANSPORT_PRIORITY_DSCP environment variable.
+// \param[out] _tos The type of service.
+// \return True if the packets of the high priority topics must be marked.
+bool priorityTos(int &_tos)
+{
+  std::string ignDscp;
+  if (!env("IGN_TRANSPORT_PRIORITY_DSCP", ignDscp))
+    return false;
+
+  try
+  {
+    const int dscp = std::stoi(ignDscp);
+    if (dscp >= 0 && dscp < 64)
+    {
+      // The DSCP is the upper 6 bits of the type of service.
+      _tos = dscp << 2;
+      return true;
+    }
+  }
+  catch (...)
+  {
+  }
+
+  std::cerr << "Invalid IGN_TRANSPORT_PRIORITY_DSCP value [" << ignDscp
+            << "]. The value must be between 0 and 63." << std::endl;
+  return false;
+}
+
+//////////////////////////////////////////////////
+// Helper to bind a publisher socket to an IPC endpoint in a temporary
+// directory, so the subscribers of the same host can skip the TCP stack.
+// \param[in] _socket The publisher socket.
+// \param[out] _address The IPC address or an empty string on failure.
+void bindIpc(zmq::socket_t &_socket, std::string &_address)
+{
+  _address.clear();
+#ifndef _WIN32
+  try
+  {
+    char bindEndPoint[1024];
+    size_t size = sizeof(bindEndPoint);
+    _socket.bind("ipc://*");
+    _socket.getsockopt(ZMQ_LAST_ENDPOINT, &bindEndPoint, &size);
+    _address = bindEndPoint;
+  }
+  catch(const zmq::error_t &)
+  {
+    // Remote subscribers will connect through TCP.
+  }
+#else
+  (void)_socket;
+#endif
+}
+
+//////////////////////////////////////////////////
+// Helper to check if a TCP address belongs to this host.
+// \param[in] _addr The address, e.g. tcp://192.168.1.2:3000.
+// \param[in] _hostAddr Address of this host.
+// \return True if _addr is an address of this host.
+bool sameHost(const std::string &_addr, const std::string &_hostAddr)
+{
+  const std::string tcpPrefix = "tcp://";
+  const auto portPos = _addr.rfind(':');
+  return _addr.compare(0, tcpPrefix.size(), tcpPrefix) == 0 &&
+    portPos != std::string::npos && portPos >= tcpPrefix.size() &&
+    _addr.substr(tcpPrefix.size(), portPos - tcpPrefix.size()) == _hostAddr;
+}
+
+//////////////////////////////////////////////////
+// Helper to get the address to connect to a publisher. Publishers running on
+// the same host are reached through their IPC address, if they have one and
+// it is visible from this process (e.g. not in another container).
+// \param[in] _pub The publisher.
+// \param[in] _hostAddr Address of this host.
+// \return The address to connect to.
+std::string dataAddress(const MessagePublisher &_pub,
+  const std::string &_hostAddr)
+{
+  const std::string addr = _pub.Addr();
+  const std::string ipcAddr = _pub.IpcAddr();
+  const std::string tcpPrefix = "tcp://";
+  const std::string ipcPrefix = "ipc://";
+  if (ipcAddr.compare(0, ipcPrefix.size(), ipcPrefix) != 0 ||
+      addr.compare(0, tcpPrefix.size(), tcpPrefix) != 0)
+  {
+    return addr;
+  }
+
+  if (!sameHost(addr, _hostAddr))
+    return addr;
+
+#ifndef _WIN32
+  if (access(ipcAddr.c_str() + ipcPrefix.size(), F_OK) == 0)
+    return ipcAddr;
+#endif
+  return addr;
+}
+
+//////////////////////////////////////////////////
+// Helper to get the multicast rate, from the IGN_TRANSPORT_MULTICAST_RATE
+// environment variable.
+// \return The rate (kilobits per second).
+int multicastRate()
+{
+  std::string ignRate;
+  if (!env("IGN_TRANSPORT_MULTICAST_RATE", ignRate))
+    return kDefaultMulticastRate;
+
+  try
+  {
+    const int rate = std::stoi(ignRate);
+    if (rate > 0)
+      return rate;
+  }
+  catch (...)
+  {
+  }
+
+  std::cerr << "Invalid IGN_TRANSPORT_MULTICAST_RATE value [" << ignRate
+            << "]. The value must be a positive integer." << std::endl;
+  return kDefaultMulticastRate;
+}
+
+//////////////////////////////////////////////////
+// Helper to set the options shared by the multicast sockets.
+// \param[in] _socket The socket.
+void setMulticastOptions(zmq::socket_t &_socket)
+{
+  int rate = multicastRate();
+  _socket.setsockopt(ZMQ_RATE, &rate, sizeof(rate));
+
+  // Messages are not retransmitted after this time, which also bounds the
+  // memory used to keep them.
+  int recoveryIvl = kMulticastRecoveryIvl;
+  _socket.setsockopt(ZMQ_RECOVERY_IVL, &recoveryIvl, sizeof(recoveryIvl));
+}
+
+//////////////////////////////////////////////////
+// Reference counted wrapper of the buffer of a message sent through two
+// sockets. The buffer is released by the last one.
+struct SharedBuffer
+{
+  /// \brief Function that releases the buffer.
+  DeallocFunc *ffn;
+
+  /// \brief Hint passed to ffn.
+  void *hint;
+
+  /// \brief Number of sockets that still use the buffer.
+  std::atomic<int> refs;
+};
+
+//////////////////////////////////////////////////
+// Deallocation function of the messages that use a SharedBuffer.
+// \param[in] _data The buffer.
+// \param[in] _hint The SharedBuffer.
+void releaseSharedBuffer(void *_data, void *_hint)
+{
+  auto *shared = static_cast<SharedBuffer *>(_hint);
+  if (shared->refs.fetch_sub(1) != 1)
+    return;
+
+  if (shared->ffn)
+    shared->ffn(_data, shared->hint);
+  delete shared;
+}
+
+//////////////////////////////////////////////////
+// Helper to select the handler that deserializes a message for all the
+// handlers of a topic. A typed handler is preferred, because the generic
+// handlers have to look up the type of the message.
+// \param[in] _handlers The handlers of the topic.
+// \param[in] _info Information of the message.
+// \param[out] _heap True if a handler that accepts the message asked for
+// messages allocated on the heap (SubscribeOptions::HeapMessages()).
+// \return The handler, or nullptr if no handler accepts the message.
+ISubscriptionHandler *messageCreator(
+  const HandlerStorage<ISubscriptionHandler>::Entries &_handlers,
+  const MessageInfo &_info,
+  bool &_heap)
+{
+  ISubscriptionHandler *typed = nullptr;
+  ISubscriptionHandler *generic = nullptr;
+  _heap = false;
+  for (const auto &entry : _handlers)
+  {
+    if (!entry.handler ||
+        !entry.handler->AcceptsType(_info.TypeId(), _info.Type()))
+    {
+      continue;
+    }
+
+    _heap = _heap || entry.handler->Options().HeapMessages();
+
+    if (entry.handler->TypeId() != kGenericMessageTypeId)
+    {
+      if (!typed)
+        typed = entry.handler.get();
+    }
+    else if (!generic)
+      generic = entry.handler.get();
+  }
+  return typed ? typed : generic;
+}
+
+//////////////////////////////////////////////////
+// Size of the initial block of the dispatch arena of each thread.
+const std::size_t kDispatchArenaBlockSize = 64 * 1024;
+
+//////////////////////////////////////////////////
+// Get the options of a dispatch arena.
+// \param[in] _block Initial block, of kDispatchArenaBlockSize bytes.
+// \return The options.
+google::protobuf::ArenaOptions dispatchArenaOptions(char *_block)
+{
+  google::protobuf::ArenaOptions options;
+  options.initial_block = _block;
+  options.initial_block_size = kDispatchArenaBlockSize;
+  return options;
+}
+
+//////////////////////////////////////////////////
+// Arena where a thread deserializes the messages that it dispatches to the
+// local handlers, so receiving a message does not allocate once the initial
+// block is large enough. The callbacks may dispatch other messages from the
+// same thread (e.g. publishing raw messages), so the arena is only reset when
+// the outermost dispatch returns.
+class DispatchArenaScope
+{
+  /// \brief Constructor.
+  public: DispatchArenaScope()
+  {
+    ++state().depth;
+  }
+
+  /// \brief Destructor. Releases the messages of the arena if this is the
+  /// outermost dispatch of the thread.
+  public: ~DispatchArenaScope()
+  {
+    State &s = state();
+    if (--s.depth == 0)
+      s.arena.Reset();
+  }
+
+  /// \brief Get the arena of the thread.
+  /// \return The arena.
+  public: google::protobuf::Arena *Arena()
+  {
+    return &state().arena;
+  }
+
+  /// \brief Arena of a thread.
+  private: struct State
+  {
+    /// \brief Constructor.
+    State()
+      : block(new char[kDispatchArenaBlockSize]),
+        arena(dispatchArenaOptions(block.get()))
+    {
+    }
+
+    /// \brief Initial block of the arena, kept across the resets.
+    std::unique_ptr<char[]> block;
+
+    /// \brief The arena. Declared after block, so it is destroyed first.
+    google::protobuf::Arena arena;
+
+    /// \brief Number of nested dispatches.
+    unsigned int depth = 0;
+  };
+
+  /// \brief Get the arena of the calling thread.
+  /// \return The arena.
+  private: static State &state()
+  {
+    thread_local State s;
+    return s;
+  }
+};
+
+//////////////////////////////////////////////////
+// Helper to get the number of ZeroMQ I/O threads, from the
+// IGN_TRANSPORT_IO_THREADS environment variable. The default is one.
+int ioThreads()
+{
+  std::string ignIoThreads;
+  if (!env("IGN_TRANSPORT_IO_THREADS", ignIoThreads))
+    return 1;
+
+  try
+  {
+    const int threads = std::stoi(ignIoThreads);
+    if (threads >= 1)
+      return threads;
+  }
+  catch (...)
+  {
+  }
+
+  std::cerr << "Invalid IGN_TRANSPORT_IO_THREADS value [" << ignIoThreads
+            << "]. The value must be a positive integer." << std::endl;
+  return 1;
+}
+
+//////////////////////////////////////////////////
+// Helper to set a numeric value of a statistics entry.
+void setStatistic(msgs::Param &_param, const std::string &_key,
+    const double _value)
+{
+  auto &value = (*_param.mutable_params())[_key];
+  value.set_type(msgs::Any::DOUBLE);
+  value.set_double_value(_value);
+}
+
+//////////////////////////////////////////////////
+// Helper to set a string value of a statistics entry.
+void setStatistic(msgs::Param &_param, const std::string &_key,
+    const std::string &_value)
+{
+  auto &value = (*_param.mutable_params())[_key];
+  value.set_type(msgs::Any::STRING);
+  value.set_string_value(_value);
+}
+
+//////////////////////////////////////////////////
+// Helper to add the statistics of a publisher or subscriber to a message.
+// The rates are computed from the values at the previous publication, which
+// happened _elapsed seconds ago.
+void addStatistics(msgs::Param_V &_msg, const std::string &_role,
+    const std::string &_fullyQualifiedTopic, const std::string &_msgType,
+    const std::string &_nUuid, EndpointCounters &_counters,
+    const double _elapsed)
+{
+  std::string partition;
+  std::string topic;
+  if (!TopicUtils::DecomposeFullyQualifiedTopic(
+        _fullyQualifiedTopic, partition, topic))
+  {
+    return;
+  }
+
+  // Do not report the statistics topic itself.
+  if (topic == kStatisticsTopic)
+    return;
+
+  const uint64_t messages = _counters.messages.load(std::memory_order_relaxed);
+  const uint64_t bytes = _counters.bytes.load(std::memory_order_relaxed);
+
+  auto *param = _msg.add_param();
+  setStatistic(*param, "role", _role);
+  setStatistic(*param, "topic", topic);
+  setStatistic(*param, "partition", partition);
+  setStatistic(*param, "type", _msgType);
+  setStatistic(*param, "node", _nUuid);
+  setStatistic(*param, "messages", static_cast<double>(messages));
+  setStatistic(*param, "bytes", static_cast<double>(bytes));
+  setStatistic(*param, "drops", static_cast<double>(
+    _counters.drops.load(std::memory_order_relaxed)));
+  setStatistic(*param, "queue_depth", static_cast<double>(
+    _counters.queued.load(std::memory_order_relaxed)));
+  setStatistic(*param, "callback_time_ns", static_cast<double>(
+    _counters.callbackNs.load(std::memory_order_relaxed)));
+  setStatistic(*param, "max_callback_time_ns", static_cast<double>(
+    _counters.maxCallbackNs.load(std::memory_order_relaxed)));
+
+  if (_elapsed > 0)
+  {
+    setStatistic(*param, "msgs_per_sec",
+      static_cast<double>(messages - _counters.lastMessages) / _elapsed);
+    setStatistic(*param, "bytes_per_sec",
+      static_cast<double>(bytes - _counters.lastBytes) / _elapsed);
+  }
+
+  _counters.lastMessages = messages;
+  _counters.lastBytes = bytes;
+}
+
+//////////////////////////////////////////////////
+// Helper to add the statistics of all the handlers of a HandlerStorage.
+template<typename T>
+void addHandlerStatistics(msgs::Param_V &_msg, const std::string &_role,
+    const HandlerStorage<T> &_storage, const double _elapsed)
+{
+  std::map<std::string, std::map<std::string,
+    std::map<std::string, std::shared_ptr<T>>>> handlers;
+  _storage.AllHandlers(handlers);
+
+  for (const auto &topic : handlers)
+  {
+    for (const auto &node : topic.second)
+    {
+      for (const auto &handler : node.second)
+      {
+        if (handler.second && handler.second->Counters())
+        {
+          addStatistics(_msg, _role, topic.first, handler.second->TypeName(),
+            node.first, *handler.second->Counters(), _elapsed);
+        }
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 NodeShared *NodeShared::Instance()
 {
@@ -175,6 +651,13 @@ NodeShared::NodeShared()
     std::cout << "Current host address: " << this->hostAddr << std::endl;
     std::cout << "Process UUID: " << this->pUuid << std::endl;
     std::cout << "Bind at: [" << this->myAddress << "] for pub/sub\n";
+    std::cout << "Bind at: [" << this->dataPtr->priorityAddress
+              << "] for high priority pub/sub\n";
+    if (!this->dataPtr->ipcAddress.empty())
+    {
+      std::cout << "Bind at: [" << this->dataPtr->ipcAddress
+                << "] for pub/sub within the host\n";
+    }
     std::cout << "Bind at: [" << this->myControlAddress << "] for control\n";
     std::cout << "Bind at: [" << this->myReplierAddress << "] for srv. calls\n";
     std::cout << "Identity for receiving srv. requests: ["
@@ -218,6 +701,16 @@ NodeShared::~NodeShared()
   // Tell the service thread to terminate.
   this->dataPtr->exit = true;
 
+  // Notify the statistics thread and join.
+  {
+    std::lock_guard<std::mutex> lk(this->dataPtr->statsMutex);
+    this->dataPtr->statsCondition.notify_all();
+  }
+  if (this->dataPtr->statsThread.joinable())
+    this->dataPtr->statsThread.join();
+  this->dataPtr->statsPublisher.reset();
+  this->dataPtr->statsNode.reset();
+
   // Notify the local pubthread and join.
   this->dataPtr->signalNewPub.notify_all();
   this->dataPtr->pubThread.join();
@@ -234,6 +727,8 @@ NodeShared::~NodeShared()
 //////////////////////////////////////////////////
 void NodeShared::RunReceptionTask()
 {
+  configureThread("reception");
+
   while (!this->dataPtr->exit)
   {
     // Poll socket for a reply, with timeout.
@@ -242,7 +737,11 @@ void NodeShared::RunReceptionTask()
       {static_cast<void*>(*this->dataPtr->subscriber), 0, ZMQ_POLLIN, 0},
       {static_cast<void*>(*this->dataPtr->control), 0, ZMQ_POLLIN, 0},
       {static_cast<void*>(*this->dataPtr->replier), 0, ZMQ_POLLIN, 0},
-      {static_cast<void*>(*this->dataPtr->responseReceiver), 0, ZMQ_POLLIN, 0}
+      {static_cast<void*>(*this->dataPtr->responseReceiver), 0, ZMQ_POLLIN, 0},
+      {static_cast<void*>(*this->dataPtr->prioritySubscriber), 0, ZMQ_POLLIN,
+        0},
+      {static_cast<void*>(*this->dataPtr->multicastSubscriber), 0, ZMQ_POLLIN,
+        0}
     };
     try
     {
@@ -254,9 +753,25 @@ void NodeShared::RunReceptionTask()
       continue;
     }
 
+    // Process every pending update of the high priority topics before the
+    // next update of the normal ones.
+    if (items[4].revents & ZMQ_POLLIN)
+    {
+      int events = 0;
+      size_t eventsSize = sizeof(events);
+      do
+      {
+        this->RecvMsgUpdate(*this->dataPtr->prioritySubscriber);
+        this->dataPtr->prioritySubscriber->getsockopt(ZMQ_EVENTS, &events,
+          &eventsSize);
+      } while (!this->dataPtr->exit && (events & ZMQ_POLLIN));
+    }
+
     //  If we got a reply, process it.
     if (items[0].revents & ZMQ_POLLIN)
       this->RecvMsgUpdate();
+    if (items[5].revents & ZMQ_POLLIN)
+      this->RecvMsgUpdate(*this->dataPtr->multicastSubscriber);
     if (items[1].revents & ZMQ_POLLIN)
       this->RecvControlUpdate();
     if (items[2].revents & ZMQ_POLLIN)
@@ -266,6 +781,103 @@ void NodeShared::RunReceptionTask()
   }
 }
 
+//////////////////////////////////////////////////
+void NodeShared::StartStatistics()
+{
+  if (!StatisticsEnabled() || this->dataPtr->statsStarted.exchange(true))
+    return;
+
+  // The node calls StartStatistics() again, which returns right away.
+  this->dataPtr->statsNode.reset(new Node());
+  this->dataPtr->statsPublisher.reset(new Node::Publisher(
+    this->dataPtr->statsNode->Advertise<msgs::Param_V>(kStatisticsTopic)));
+  if (!*this->dataPtr->statsPublisher)
+  {
+    std::cerr << "Error advertising the statistics topic ["
+              << kStatisticsTopic << "]" << std::endl;
+    return;
+  }
+
+  this->dataPtr->statsThread =
+    std::thread(&NodeShared::RunStatisticsTask, this);
+}
+
+//////////////////////////////////////////////////
+void NodeShared::RunStatisticsTask()
+{
+  configureThread("stats");
+
+  const auto period = StatisticsPeriod();
+  auto &pub = *this->dataPtr->statsPublisher;
+
+  auto lastTime = std::chrono::steady_clock::now();
+  while (!this->dataPtr->exit)
+  {
+    {
+      std::unique_lock<std::mutex> lk(this->dataPtr->statsMutex);
+      this->dataPtr->statsCondition.wait_for(lk, period,
+        [this]{return this->dataPtr->exit.load();});
+    }
+
+    if (this->dataPtr->exit)
+      break;
+
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsed =
+      std::chrono::duration<double>(now - lastTime).count();
+    lastTime = now;
+
+    msgs::Param_V msg;
+    const auto wallTime = std::chrono::system_clock::now().time_since_epoch();
+    const auto sec = std::chrono::duration_cast<std::chrono::seconds>(
+      wallTime);
+    msg.mutable_header()->mutable_stamp()->set_sec(sec.count());
+    msg.mutable_header()->mutable_stamp()->set_nsec(static_cast<int32_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        wallTime - sec).count()));
+
+    auto *process = msg.mutable_header()->add_data();
+    process->set_key("process");
+    process->add_value(this->pUuid);
+    auto *host = msg.mutable_header()->add_data();
+    host->set_key("host");
+    host->add_value(this->hostAddr);
+
+    // Publishers. Drop the ones that have been destroyed.
+    {
+      std::lock_guard<std::mutex> lk(this->dataPtr->statsMutex);
+      auto &stats = this->dataPtr->publisherStats;
+      stats.erase(std::remove_if(stats.begin(), stats.end(),
+        [](const NodeSharedPrivate::PublisherStatistics &_stats)
+        {
+          return _stats.counters.expired();
+        }), stats.end());
+
+      for (const auto &entry : stats)
+      {
+        auto counters = entry.counters.lock();
+        if (counters)
+        {
+          addStatistics(msg, "publisher", entry.publisher.Topic(),
+            entry.publisher.MsgTypeName(), entry.publisher.NUuid(),
+            *counters, elapsed);
+        }
+      }
+    }
+
+    // Subscribers.
+    {
+      std::lock_guard<std::recursive_mutex> lk(this->mutex);
+      addHandlerStatistics(msg, "subscriber",
+        this->localSubscribers.normal, elapsed);
+      addHandlerStatistics(msg, "raw_subscriber",
+        this->localSubscribers.raw, elapsed);
+    }
+
+    pub.Publish(msg);
+  }
+}
+
 //////////////////////////////////////////////////
 bool NodeShared::Publish(
     const std::string &_topic,
@@ -273,21 +885,75 @@ bool NodeShared::Publish(
     const size_t _dataSize, DeallocFunc *_ffn,
     const std::string &_msgType)
 {
+  return this->Publish(_topic, _data, _dataSize, _ffn, nullptr, _msgType);
+}
+
+//////////////////////////////////////////////////
+bool NodeShared::Publish(
+    const std::string &_topic,
+    char *_data,
+    const size_t _dataSize, DeallocFunc *_ffn,
+    void *_hint,
+    const std::string &_msgType,
+    const std::string *_sender,
+    const Priority_t _priority,
+    const bool _multicast)
+{
+  const bool highPriority = _priority == Priority_t::HIGH;
+  zmq::socket_t &socket = highPriority ?
+    *this->dataPtr->priorityPublisher : *this->dataPtr->publisher;
+  const std::string &sender = _sender ? *_sender :
+    (highPriority ? this->dataPtr->priorityAddress : this->myAddress);
+
   try
   {
-    // Create the messages.
+    std::lock_guard<std::recursive_mutex> lock(this->mutex);
+
+    // Multicast topics are also sent through TCP, for the subscribers that
+    // could not join the multicast group. A subscriber that receives both
+    // copies discards one by its sequence number. Both sockets share the
+    // data, released when both are done.
+    const bool multicast =
+      _multicast && !this->dataPtr->multicastAddress.empty();
+    if (multicast)
+    {
+      auto *shared = new SharedBuffer{_ffn, _hint, {2}};
+      _ffn = releaseSharedBuffer;
+      _hint = shared;
+    }
+
+    // Create the TCP message that references the data before sending
+    // anything. A message that has not been sent releases its reference when
+    // it is destroyed, so the data is released even if a send fails.
     // Note that we use zero copy for passing the message data (msg2).
+    zmq::message_t msg2(_data, _dataSize, _ffn, _hint);
+
+    if (multicast)
+    {
+      // The multicast message takes the second reference first, so that it
+      // is released if creating the other frames fails.
+      zmq::message_t multicastMsg2(_data, _dataSize, _ffn, _hint),
+                     msg0(_topic.data(), _topic.size()),
+                     msg1(sender.data(), sender.size()),
+                     msg3(_msgType.data(), _msgType.size());
+
+      zmq::socket_t &multicastSocket = *this->dataPtr->multicastPublisher;
+      multicastSocket.send(msg0, ZMQ_SNDMORE);
+      multicastSocket.send(msg1, ZMQ_SNDMORE);
+      multicastSocket.send(multicastMsg2, ZMQ_SNDMORE);
+      multicastSocket.send(msg3, 0);
+    }
+
+    // Create the remaining messages.
     zmq::message_t msg0(_topic.data(), _topic.size()),
-                   msg1(this->myAddress.data(), this->myAddress.size()),
-                   msg2(_data, _dataSize, _ffn, nullptr),
+                   msg1(sender.data(), sender.size()),
                    msg3(_msgType.data(), _msgType.size());
 
     // Send the messages
-    std::lock_guard<std::recursive_mutex> lock(this->mutex);
-    this->dataPtr->publisher->send(msg0, ZMQ_SNDMORE);
-    this->dataPtr->publisher->send(msg1, ZMQ_SNDMORE);
-    this->dataPtr->publisher->send(msg2, ZMQ_SNDMORE);
-    this->dataPtr->publisher->send(msg3, 0);
+    socket.send(msg0, ZMQ_SNDMORE);
+    socket.send(msg1, ZMQ_SNDMORE);
+    socket.send(msg2, ZMQ_SNDMORE);
+    socket.send(msg3, 0);
   }
   catch(const zmq::error_t& ze)
   {
@@ -300,35 +966,44 @@ bool NodeShared::Publish(
 
 //////////////////////////////////////////////////
 void NodeShared::RecvMsgUpdate()
+{
+  this->RecvMsgUpdate(*this->dataPtr->subscriber);
+}
+
+//////////////////////////////////////////////////
+void NodeShared::RecvMsgUpdate(zmq::socket_t &_socket)
 {
   zmq::message_t msg(0);
   std::string topic;
-  // std::string sender;
   std::string data;
   std::string msgType;
   HandlerInfo handlerInfo;
+  MessageInfo info;
+  uint64_t batchSize = 0;
 
   {
     std::lock_guard<std::recursive_mutex> lock(this->mutex);
 
     try
     {
-      if (!this->dataPtr->subscriber->recv(&msg, 0))
+      if (!_socket.recv(&msg, 0))
         return;
       topic = std::string(reinterpret_cast<char *>(msg.data()), msg.size());
 
-      // TODO(caguero): Use this as extra metadata for the subscriber.
-      if (!this->dataPtr->subscriber->recv(&msg, 0))
+      if (!_socket.recv(&msg, 0))
         return;
-      // sender = std::string(reinterpret_cast<char *>(msg.data()), msg.size());
+      parseSenderFrame(reinterpret_cast<char *>(msg.data()), msg.size(), info,
+        batchSize);
 
-      if (!this->dataPtr->subscriber->recv(&msg, 0))
+      if (!_socket.recv(&msg, 0))
         return;
       data = std::string(reinterpret_cast<char *>(msg.data()), msg.size());
+      info.SetSize(data.size());
 
-      if (!this->dataPtr->subscriber->recv(&msg, 0))
+      if (!_socket.recv(&msg, 0))
         return;
       msgType = std::string(reinterpret_cast<char *>(msg.data()), msg.size());
+      info.SetReceptionTime(std::chrono::steady_clock::now());
     }
     catch(const zmq::error_t &_error)
     {
@@ -336,12 +1011,38 @@ void NodeShared::RecvMsgUpdate()
       return;
     }
 
+    // Discard the copy of a multicast message received through TCP, or the
+    // other way around.
+    auto sequences = this->dataPtr->multicastSequences.find(topic);
+    if (sequences != this->dataPtr->multicastSequences.end() &&
+        !info.PublisherUuid().empty() &&
+        !sequences->second[info.PublisherUuid()].Insert(
+          info.SequenceNumber()))
+    {
+      return;
+    }
+
     handlerInfo = this->CheckHandlerInfo(topic);
+
+    auto topicInfo = this->dataPtr->topicInfos.find(topic);
+    if (topicInfo != this->dataPtr->topicInfos.end())
+    {
+      if (topicInfo->second.Type() != msgType)
+        topicInfo->second.SetType(msgType);
+      info.SetTopicAndType(topicInfo->second);
+    }
+    else
+    {
+      info.SetTopicAndPartition(topic);
+      info.SetType(msgType);
+    }
   }
 
-  MessageInfo info;
-  info.SetTopicAndPartition(topic);
-  info.SetType(msgType);
+  if (batchSize > 0)
+  {
+    this->TriggerBatchCallbacks(info, data.data(), data.size(), handlerInfo);
+    return;
+  }
   this->TriggerCallbacks(info, data, handlerInfo);
 }
 
@@ -353,10 +1054,10 @@ NodeShared::HandlerInfo NodeShared::CheckHandlerInfo(
 
   std::lock_guard<std::recursive_mutex> lk(this->mutex);
 
-  info.haveLocal = this->localSubscribers.normal.Handlers(
+  info.haveLocal = this->localSubscribers.normal.TopicHandlers(
         _topic, info.localHandlers);
 
-  info.haveRaw = this->localSubscribers.raw.Handlers(
+  info.haveRaw = this->localSubscribers.raw.TopicHandlers(
         _topic, info.rawHandlers);
 
   return info;
@@ -371,10 +1072,10 @@ NodeShared::SubscriberInfo NodeShared::CheckSubscriberInfo(
 
   std::lock_guard<std::recursive_mutex> lk(this->mutex);
 
-  info.haveLocal = this->localSubscribers.normal.Handlers(
+  info.haveLocal = this->localSubscribers.normal.TopicHandlers(
         _topic, info.localHandlers);
 
-  info.haveRaw = this->localSubscribers.raw.Handlers(
+  info.haveRaw = this->localSubscribers.raw.TopicHandlers(
         _topic, info.rawHandlers);
 
   info.haveRemote = this->remoteSubscribers.HasTopic(
@@ -402,77 +1103,199 @@ void NodeShared::TriggerCallbacks(
     const MessageInfo &_info,
     const std::string &_msgData,
     const HandlerInfo &_handlerInfo)
+{
+  this->TriggerCallbacks(_info, _msgData.data(), _msgData.size(),
+      _handlerInfo);
+}
+
+//////////////////////////////////////////////////
+void NodeShared::TriggerCallbacks(
+    const MessageInfo &_info,
+    const char *_msgData,
+    const std::size_t _msgSize,
+    const HandlerInfo &_handlerInfo)
 {
   if (!_handlerInfo.haveLocal && !_handlerInfo.haveRaw)
     return;
 
   if (_handlerInfo.haveRaw)
   {
-    for (const auto &node : _handlerInfo.rawHandlers)
+    for (const auto &entry : *_handlerInfo.rawHandlers)
     {
-      for (const auto &handler : node.second)
+      const RawSubscriptionHandlerPtr &rawHandler = entry.handler;
+      if (rawHandler)
       {
-        const RawSubscriptionHandlerPtr &rawHandler = handler.second;
-        if (rawHandler)
+        if (rawHandler->AcceptsType(_info.TypeId(), _info.Type()))
         {
-          if (rawHandler->TypeName() == _info.Type() ||
-              rawHandler->TypeName() == kGenericMessageType)
-          {
-            rawHandler->RunRawCallback(_msgData.c_str(), _msgData.size(),
-                _info);
-          }
+          rawHandler->RunRawCallback(_msgData, _msgSize, _info);
         }
-        else
-          std::cerr << "Raw subscription handler is NULL" << std::endl;
       }
+      else
+        std::cerr << "Raw subscription handler is NULL" << std::endl;
     }
   }
 
   if (_handlerInfo.haveLocal)
   {
-    // This will be instantiated by the first suitable handler that we
-    // encounter. If there is no suitable handler, then we can avoid
-    // deserializing the message altogether.
+    bool heap;
+    ISubscriptionHandler *creator =
+      messageCreator(*_handlerInfo.localHandlers, _info, heap);
+    if (!creator)
+      return;
+
+    // The message is deserialized once and shared by all the handlers. It
+    // is only deserialized when a handler wants it, so the messages that
+    // the throttling drops for every handler are never parsed. The arena is
+    // declared first, so it is reset after the message is released.
+    DispatchArenaScope arenaScope;
+    google::protobuf::Arena *arena = heap ? nullptr : arenaScope.Arena();
     std::shared_ptr<ProtoMsg> msg;
 
-    for (const auto &node : _handlerInfo.localHandlers)
+    for (const auto &entry : *_handlerInfo.localHandlers)
     {
-      for (const auto &handler : node.second)
+      const ISubscriptionHandlerPtr &localHandler = entry.handler;
+      if (localHandler)
       {
-        const ISubscriptionHandlerPtr &localHandler = handler.second;
-        if (localHandler)
+        if (localHandler->AcceptsType(_info.TypeId(), _info.Type()) &&
+            !localHandler->DropIfThrottled(_info))
         {
-          if (localHandler->TypeName() == _info.Type() ||
-              localHandler->TypeName() == kGenericMessageType)
+          if (!msg)
           {
+            msg = creator->CreateMsg(_msgData, _msgSize, _info.Type(),
+              arena);
+
             if (!msg)
             {
-              // If the message has not been deserialized yet, do it now since
-              // we have allegedly found a subscriber which should be able to
-              // do it.
-              msg = localHandler->CreateMsg(_msgData, _info.Type());
-
-              if (!msg)
-              {
-                // If the message could not be created, then none of the
-                // handlers in this process will be able to create it, because
-                // protobuf has access to all message types that the current
-                // process is linked to. If CreateMsg(~,~) fails, then we may
-                // as well quit.
-                return;
-              }
+              if (localHandler->Counters())
+                localHandler->Counters()->AddDrop();
+
+              // If the message could not be created, then none of the
+              // handlers in this process will be able to create it, because
+              // protobuf has access to all message types that the current
+              // process is linked to. If CreateMsg(~,~) fails, then we may
+              // as well quit.
+              return;
             }
-
-            localHandler->RunLocalCallback(*msg, _info);
           }
+
+          localHandler->RunLocalCallback(*msg, _info);
         }
-        else
-          std::cerr << "Local subscription handler is NULL" << std::endl;
       }
+      else
+        std::cerr << "Local subscription handler is NULL" << std::endl;
     }
   }
 }
 
+//////////////////////////////////////////////////
+void NodeShared::TriggerBatchCallbacks(
+    const MessageInfo &_info,
+    const char *_batchData,
+    const std::size_t _batchSize,
+    const HandlerInfo &_handlerInfo)
+{
+  if (!_handlerInfo.haveLocal && !_handlerInfo.haveRaw)
+    return;
+
+  std::vector<BatchEntry> entries;
+  if (!parseBatch(_batchData, _batchSize, entries))
+  {
+    std::cerr << "NodeShared::TriggerBatchCallbacks(): Malformed batch on "
+              << "topic [" << _info.Topic() << "]" << std::endl;
+    return;
+  }
+
+  if (entries.empty())
+    return;
+
+  // The header has the sequence number of the first message of the batch.
+  const uint64_t firstSequence = _info.SequenceNumber();
+
+  if (_handlerInfo.haveRaw)
+  {
+    MessageInfo info(_info);
+    for (const auto &entry : *_handlerInfo.rawHandlers)
+    {
+      const RawSubscriptionHandlerPtr &rawHandler = entry.handler;
+      if (!rawHandler)
+      {
+        std::cerr << "Raw subscription handler is NULL" << std::endl;
+        continue;
+      }
+
+      if (!rawHandler->AcceptsType(_info.TypeId(), _info.Type()))
+        continue;
+
+      for (const BatchEntry &batchEntry : entries)
+      {
+        info.SetSequenceNumber(firstSequence + batchEntry.index);
+        info.SetSize(batchEntry.size);
+        rawHandler->RunRawCallback(batchEntry.data, batchEntry.size, info);
+      }
+    }
+  }
+
+  if (!_handlerInfo.haveLocal)
+    return;
+
+  bool heap;
+  ISubscriptionHandler *creator =
+    messageCreator(*_handlerInfo.localHandlers, _info, heap);
+  if (!creator)
+    return;
+
+  // The messages are deserialized once, when a handler wants them, and
+  // shared by all the handlers. The messages of a batch are received at the
+  // same time, so the throttling drops all of them or lets the first one
+  // through.
+  DispatchArenaScope arenaScope;
+  google::protobuf::Arena *arena = heap ? nullptr : arenaScope.Arena();
+  std::vector<std::shared_ptr<ProtoMsg>> msgs;
+  std::vector<std::pair<const ProtoMsg *, uint64_t>> batch;
+
+  for (const auto &entry : *_handlerInfo.localHandlers)
+  {
+    const ISubscriptionHandlerPtr &localHandler = entry.handler;
+    if (!localHandler)
+    {
+      std::cerr << "Local subscription handler is NULL" << std::endl;
+      continue;
+    }
+
+    if (!localHandler->AcceptsType(_info.TypeId(), _info.Type()) ||
+        localHandler->DropIfThrottled(_info, entries.size()))
+    {
+      continue;
+    }
+
+    if (msgs.empty())
+    {
+      msgs.reserve(entries.size());
+      batch.reserve(entries.size());
+      for (const BatchEntry &batchEntry : entries)
+      {
+        auto msg = creator->CreateMsg(batchEntry.data, batchEntry.size,
+          _info.Type(), arena);
+        if (!msg)
+        {
+          if (localHandler->Counters())
+            localHandler->Counters()->AddDrop(entries.size());
+
+          // See TriggerCallbacks(): no other handler would be able to
+          // create it.
+          return;
+        }
+
+        msgs.push_back(msg);
+        batch.push_back(
+          std::make_pair(msg.get(), firstSequence + batchEntry.index));
+      }
+    }
+
+    localHandler->RunLocalBatchCallback(batch, _info);
+  }
+}
+
 //////////////////////////////////////////////////
 void NodeShared::RecvControlUpdate()
 {
@@ -516,17 +1339,60 @@ void NodeShared::RecvControlUpdate()
 
   if (std::stoi(data) == ignition::msgs::Discovery::NEW_CONNECTION)
   {
+    // The subscriber may ask for a maximum rate and a filter with
+    // "<code>:<rate>:<filter>". A rate of 0 means unthrottled. The code is
+    // followed by kBatchSupport if the subscriber accepts batches.
+    AdvertiseMessageOptions opts;
+    MessageFilter filter;
+    const auto separator = data.find(':');
+    const bool acceptsBatches =
+      data.substr(0, separator).find(kBatchSupport) != std::string::npos;
+    if (separator != std::string::npos)
+    {
+      try
+      {
+        const uint64_t msgsPerSec = std::stoull(data.substr(separator + 1));
+        if (msgsPerSec > 0)
+          opts.SetMsgsPerSec(msgsPerSec);
+      }
+      catch(const std::exception &)
+      {
+        std::cerr << "NodeShared::RecvControlUpdate() error: Invalid rate ["
+                  << data << "]" << std::endl;
+      }
+
+      // An invalid filter is reported by MessageFilter and ignored, so the
+      // subscriber receives every message.
+      const auto filterSeparator = data.find(':', separator + 1);
+      if (filterSeparator != std::string::npos)
+      {
+        filter = MessageFilter(data.substr(filterSeparator + 1));
+        if (!filter.Valid())
+          filter = MessageFilter();
+      }
+    }
+
     if (this->verbose)
     {
       std::cout << "Registering a new remote connection" << std::endl;
       std::cout << "\tProc UUID: [" << procUuid << "]" << std::endl;
       std::cout << "\tNode UUID: [" << nodeUuid << "]" << std::endl;
+      if (opts.Throttled())
+        std::cout << "\tRate: " << opts.MsgsPerSec() << " msgs/sec\n";
+      if (!filter.Empty())
+        std::cout << "\tFilter: [" << filter.Expression() << "]\n";
     }
 
-    // Register that we have another remote subscriber.
+    // Register that we have another remote subscriber. A node that was
+    // already registered may be asking for a different rate.
+    this->remoteSubscribers.DelPublisherByNode(topic, procUuid, nodeUuid);
     MessagePublisher remoteNode(topic, "", "", procUuid, nodeUuid, type,
-      AdvertiseMessageOptions());
+      opts);
     this->remoteSubscribers.AddPublisher(remoteNode);
+    this->dataPtr->SetRemoteFilter(topic, procUuid, nodeUuid, filter);
+    this->dataPtr->SetRemoteBatchSupport(topic, procUuid, nodeUuid,
+      acceptsBatches);
+    this->dataPtr->NotifySubscribersChanged();
   }
   else if (std::stoi(data) == ignition::msgs::Discovery::END_CONNECTION)
   {
@@ -539,6 +1405,10 @@ void NodeShared::RecvControlUpdate()
 
     // Delete a remote subscriber.
     this->remoteSubscribers.DelPublisherByNode(topic, procUuid, nodeUuid);
+    this->dataPtr->SetRemoteFilter(topic, procUuid, nodeUuid,
+      MessageFilter());
+    this->dataPtr->SetRemoteBatchSupport(topic, procUuid, nodeUuid, false);
+    this->dataPtr->NotifySubscribersChanged();
   }
 }
 
@@ -941,17 +1811,38 @@ void NodeShared::OnNewConnection(const MessagePublisher &_pub)
       // Handle security
       this->dataPtr->SecurityOnNewConnection();
 
-      // I am not connected to the process.
+      // High priority topics have their own socket, served first.
+      zmq::socket_t &subscriber =
+        _pub.Options().Priority() == Priority_t::HIGH ?
+        *this->dataPtr->prioritySubscriber : *this->dataPtr->subscriber;
+
+      int queueVal = 0;
+      subscriber.setsockopt(ZMQ_RCVHWM, &queueVal, sizeof(queueVal));
+
+      // I am not connected to the process. The connections are indexed by
+      // the TCP address, even if the data arrives through IPC.
+      std::string endpoint = dataAddress(_pub, this->hostAddr);
       if (!this->connections.HasPublisher(addr))
-        this->dataPtr->subscriber->connect(addr.c_str());
+        subscriber.connect(endpoint.c_str());
 
-      // Add a new filter for the topic.
-      this->dataPtr->subscriber->setsockopt(ZMQ_SUBSCRIBE,
+      // Add a new filter for the topic. Multicast topics are received from
+      // the multicast group instead, unless the publisher is on this host,
+      // since multicast messages are not looped back.
+      if (!_pub.MulticastAddr().empty() && !sameHost(addr, this->hostAddr) &&
+          this->dataPtr->JoinMulticast(_pub.MulticastAddr(), this->hostAddr))
+      {
+        endpoint = _pub.MulticastAddr();
+        this->dataPtr->multicastSubscriber->setsockopt(ZMQ_SUBSCRIBE,
           topic.data(), topic.size());
 
-      int queueVal = 0;
-      this->dataPtr->subscriber->setsockopt(ZMQ_RCVHWM,
-          &queueVal, sizeof(queueVal));
+        // The publisher also sends the topic through TCP, and we may be
+        // subscribed to it there too because of another publisher.
+        this->dataPtr->multicastSequences[topic];
+      }
+      else
+      {
+        subscriber.setsockopt(ZMQ_SUBSCRIBE, topic.data(), topic.size());
+      }
 
       // Register the new connection with the publisher.
       this->connections.AddPublisher(_pub);
@@ -962,7 +1853,7 @@ void NodeShared::OnNewConnection(const MessagePublisher &_pub)
 
       if (this->verbose)
       {
-        std::cout << "\t* Connected to [" << addr << "] for data\n";
+        std::cout << "\t* Connected to [" << endpoint << "] for data\n";
         std::cout << "\t* Connected to [" << ctrl << "] for control\n";
       }
 
@@ -994,8 +1885,24 @@ void NodeShared::OnNewConnection(const MessagePublisher &_pub)
         memcpy(msg.data(), type.data(), type.size());
         socket.send(msg, ZMQ_SNDMORE);
 
+        // If all the subscribers of the node are throttled, tell the
+        // publisher the rate that we need, so it does not send us the
+        // messages that we would discard. Older publishers only read the
+        // number before the ':'.
+        // The same goes for the filters on the content of the messages,
+        // which are appended after the rate. Publishers only send batches
+        // to the nodes that add kBatchSupport after the code.
         std::string data =
-          std::to_string(ignition::msgs::Discovery::NEW_CONNECTION);
+          std::to_string(ignition::msgs::Discovery::NEW_CONNECTION) +
+          kBatchSupport;
+        const uint64_t msgsPerSec = this->localSubscribers.NodeMsgsPerSec(
+          topic, _pub.MsgTypeName(), nodeUuid);
+        const std::string filter = this->localSubscribers.NodeFilter(
+          topic, _pub.MsgTypeName(), nodeUuid);
+        if (msgsPerSec > 0 || !filter.empty())
+          data += ":" + std::to_string(msgsPerSec);
+        if (!filter.empty())
+          data += ":" + filter;
         msg.rebuild(data.size());
         memcpy(msg.data(), data.data(), data.size());
         socket.send(msg, 0);
@@ -1027,6 +1934,9 @@ void NodeShared::OnNewDisconnection(const MessagePublisher &_pub)
   if (topic != "" && nUuid != "")
   {
     this->remoteSubscribers.DelPublisherByNode(topic, procUuid, nUuid);
+    this->dataPtr->SetRemoteFilter(topic, procUuid, nUuid, MessageFilter());
+    this->dataPtr->SetRemoteBatchSupport(topic, procUuid, nUuid, false);
+    this->dataPtr->NotifySubscribersChanged();
 
     MessagePublisher connection;
     if (!this->connections.Publisher(topic, procUuid, nUuid, connection))
@@ -1038,6 +1948,9 @@ void NodeShared::OnNewDisconnection(const MessagePublisher &_pub)
   else
   {
     this->remoteSubscribers.DelPublishersByProc(procUuid);
+    this->dataPtr->DelRemoteFiltersByProc(procUuid);
+    this->dataPtr->DelRemoteBatchSupportByProc(procUuid);
+    this->dataPtr->NotifySubscribersChanged();
 
     MsgAddresses_M info;
     if (!this->connections.Publishers(topic, info))
@@ -1126,7 +2039,9 @@ bool NodeShared::InitializeSockets()
     this->dataPtr->publisher->setsockopt(ZMQ_LINGER,
         &lingerVal, sizeof(lingerVal));
 
-    int queueVal = 0;
+    // Each remote subscriber has its own queue, so a slow subscriber does
+    // not make the others lose messages.
+    int queueVal = sendHighWaterMark();
     this->dataPtr->publisher->setsockopt(ZMQ_SNDHWM,
         &queueVal, sizeof(queueVal));
 
@@ -1136,6 +2051,34 @@ bool NodeShared::InitializeSockets()
         &bindEndPoint, &size);
     this->myAddress = bindEndPoint;
 
+    // Publisher socket for the high priority topics, so their messages do
+    // not wait in the same queues as the messages of the normal ones.
+    this->dataPtr->priorityPublisher->setsockopt(ZMQ_LINGER,
+        &lingerVal, sizeof(lingerVal));
+    this->dataPtr->priorityPublisher->setsockopt(ZMQ_SNDHWM,
+        &queueVal, sizeof(queueVal));
+    int tos = 0;
+    if (priorityTos(tos))
+    {
+      this->dataPtr->priorityPublisher->setsockopt(ZMQ_TOS,
+          &tos, sizeof(tos));
+#ifdef ZMQ_PRIORITY
+      int priority = kPrioritySocketPriority;
+      this->dataPtr->priorityPublisher->setsockopt(ZMQ_PRIORITY,
+          &priority, sizeof(priority));
+#endif
+    }
+    this->dataPtr->priorityPublisher->bind(anyTcpEp.c_str());
+    size = sizeof(bindEndPoint);
+    this->dataPtr->priorityPublisher->getsockopt(ZMQ_LAST_ENDPOINT,
+        &bindEndPoint, &size);
+    this->dataPtr->priorityAddress = bindEndPoint;
+
+    // Subscribers on the same host connect to the publishers through IPC.
+    bindIpc(*this->dataPtr->publisher, this->dataPtr->ipcAddress);
+    bindIpc(*this->dataPtr->priorityPublisher,
+      this->dataPtr->priorityIpcAddress);
+
     // Control socket listening in a random port.
     this->dataPtr->control->bind(anyTcpEp.c_str());
     this->dataPtr->control->getsockopt(ZMQ_LAST_ENDPOINT, &bindEndPoint, &size);
@@ -1226,23 +2169,110 @@ static void AppendNodeUuids(const HandlerStorage<HandlerT> &_handlerStorage,
                             const std::string &_msgTypeName,
                             std::vector<std::string> &_uuids)
 {
-  using HandlerTPtr = std::shared_ptr<HandlerT>;
-  std::map<std::string, std::map<std::string, HandlerTPtr>> handlers;
+  typename HandlerStorage<HandlerT>::EntriesPtr handlers;
+  if (!_handlerStorage.TopicHandlers(_fullyQualifiedTopic, handlers))
+    return;
+
+  const NameId typeId = NameTable::Find(_msgTypeName);
+  for (const auto &entry : *handlers)
+  {
+    if (entry.handler->AcceptsType(typeId, _msgTypeName))
+      _uuids.push_back(entry.handler->NodeUuid());
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Update the rate wanted by a node with the handlers of a storage.
+/// \param[in] _handlerStorage The storage.
+/// \param[in] _fullyQualifiedTopic Fully-qualified topic name.
+/// \param[in] _msgTypeName Name of the message type.
+/// \param[in] _nUuid UUID of the node.
+/// \param[in, out] _msgsPerSec Highest rate found, or 0 if a handler is not
+/// throttled.
+/// \param[in, out] _found Whether a handler has been found.
+template <typename HandlerT>
+static void UpdateNodeMsgsPerSec(const HandlerStorage<HandlerT> &_handlerStorage,
+                                 const std::string &_fullyQualifiedTopic,
+                                 const std::string &_msgTypeName,
+                                 const std::string &_nUuid,
+                                 uint64_t &_msgsPerSec,
+                                 bool &_found)
+{
+  typename HandlerStorage<HandlerT>::EntriesPtr handlers;
+  if (!_handlerStorage.TopicHandlers(_fullyQualifiedTopic, handlers))
+    return;
+
+  const NameId typeId = NameTable::Find(_msgTypeName);
+  for (const auto &entry : *handlers)
+  {
+    const std::shared_ptr<HandlerT> &handler = entry.handler;
+    if (entry.nUuid != _nUuid || !handler->AcceptsType(typeId, _msgTypeName))
+      continue;
+
+    const SubscribeOptions &opts = handler->Options();
+    if (!opts.Throttled())
+      _msgsPerSec = 0;
+    else if (!_found || _msgsPerSec != 0)
+      _msgsPerSec = std::max(_msgsPerSec, opts.MsgsPerSec());
+    _found = true;
+  }
+}
+
+//////////////////////////////////////////////////
+uint64_t NodeShared::HandlerWrapper::NodeMsgsPerSec(
+    const std::string &_fullyQualifiedTopic,
+    const std::string &_msgTypeName,
+    const std::string &_nUuid) const
+{
+  uint64_t msgsPerSec = 0;
+  bool found = false;
+  UpdateNodeMsgsPerSec(this->normal, _fullyQualifiedTopic, _msgTypeName,
+    _nUuid, msgsPerSec, found);
+  UpdateNodeMsgsPerSec(this->raw, _fullyQualifiedTopic, _msgTypeName,
+    _nUuid, msgsPerSec, found);
+  return msgsPerSec;
+}
+
+//////////////////////////////////////////////////
+std::string NodeShared::HandlerWrapper::NodeFilter(
+    const std::string &_fullyQualifiedTopic,
+    const std::string &_msgTypeName,
+    const std::string &_nUuid) const
+{
+  const NameId typeId = NameTable::Find(_msgTypeName);
 
-  _handlerStorage.Handlers(_fullyQualifiedTopic, handlers);
-  for (const auto &collection : handlers)
+  // Raw subscribers ignore the filters, so they want every message.
+  HandlerStorage<RawSubscriptionHandler>::EntriesPtr raw;
+  this->raw.TopicHandlers(_fullyQualifiedTopic, raw);
+  for (const auto &entry : *raw)
   {
-    for (const auto &collectionEntry : collection.second)
+    if (entry.nUuid == _nUuid &&
+        entry.handler->AcceptsType(typeId, _msgTypeName))
     {
-      const HandlerTPtr &handler = collectionEntry.second;
-      const std::string &handlerMsgType = handler->TypeName();
-      if (handlerMsgType == _msgTypeName
-          || handlerMsgType == kGenericMessageType)
-      {
-        _uuids.push_back(handler->NodeUuid());
-      }
+      return "";
     }
   }
+
+  HandlerStorage<ISubscriptionHandler>::EntriesPtr normal;
+  this->normal.TopicHandlers(_fullyQualifiedTopic, normal);
+
+  std::string filter;
+  for (const auto &entry : *normal)
+  {
+    const ISubscriptionHandlerPtr &handler = entry.handler;
+    if (entry.nUuid != _nUuid || !handler->AcceptsType(typeId, _msgTypeName))
+      continue;
+
+    if (handler->Filter().Empty())
+      return "";
+
+    // Each filter is a list of terms joined with "||", so joining them
+    // with "||" is also a valid filter.
+    if (!filter.empty())
+      filter += " || ";
+    filter += handler->Filter().Expression();
+  }
+  return filter;
 }
 
 //////////////////////////////////////////////////
@@ -1285,6 +2315,10 @@ void NodeSharedPrivate::SecurityOnNewConnection()
   {
     this->subscriber->setsockopt(ZMQ_PLAIN_USERNAME, user.c_str(), user.size());
     this->subscriber->setsockopt(ZMQ_PLAIN_PASSWORD, pass.c_str(), pass.size());
+    this->prioritySubscriber->setsockopt(ZMQ_PLAIN_USERNAME, user.c_str(),
+        user.size());
+    this->prioritySubscriber->setsockopt(ZMQ_PLAIN_PASSWORD, pass.c_str(),
+        pass.size());
   }
 }
 
@@ -1302,11 +2336,15 @@ void NodeSharedPrivate::SecurityInit()
 
     int asPlainSecurityServer = static_cast<int>(
         ZmqPlainSecurityServerOptions::ZMQ_PLAIN_SECURITY_SERVER_ENABLED);
-    this->publisher->setsockopt(ZMQ_PLAIN_SERVER,
-        &asPlainSecurityServer, sizeof(asPlainSecurityServer));
+    for (auto *socket : {this->publisher.get(),
+                         this->priorityPublisher.get()})
+    {
+      socket->setsockopt(ZMQ_PLAIN_SERVER,
+          &asPlainSecurityServer, sizeof(asPlainSecurityServer));
 
-    this->publisher->setsockopt(ZMQ_ZAP_DOMAIN, kIgnAuthDomain,
-        std::strlen(kIgnAuthDomain));
+      socket->setsockopt(ZMQ_ZAP_DOMAIN, kIgnAuthDomain,
+          std::strlen(kIgnAuthDomain));
+    }
   }
 }
 
@@ -1315,6 +2353,8 @@ void NodeSharedPrivate::SecurityInit()
 // This function is designed to be run in a thread.
 void NodeSharedPrivate::AccessControlHandler()
 {
+  configureThread("auth");
+
   zmq::socket_t *sock = new zmq::socket_t(*this->context, ZMQ_REP);
 
   try
@@ -1443,9 +2483,133 @@ void NodeSharedPrivate::AccessControlHandler()
   sock->close();
 }
 
+//////////////////////////////////////////////////
+std::string NodeSharedPrivate::EnableMulticast(const std::string &_hostAddr,
+  const std::string &_pUuid)
+{
+  std::lock_guard<std::mutex> lk(this->multicastMutex);
+  if (this->multicastEnabled)
+    return this->multicastAddress;
+  this->multicastEnabled = true;
+
+  // PGM has no handshake, so the messages could not be authenticated.
+  std::string user, pass;
+  if (userPass(user, pass))
+  {
+    std::cerr << "Multicast topics are sent through TCP when "
+              << "authentication is enabled" << std::endl;
+    return this->multicastAddress;
+  }
+
+  std::string group = kDefaultMulticastGroup;
+  env("IGN_TRANSPORT_MULTICAST_GROUP", group);
+  const int port = kMulticastBasePort +
+    static_cast<int>(std::hash<std::string>()(_pUuid) % kMulticastPorts);
+  const std::string address = group + ":" + std::to_string(port);
+
+  try
+  {
+    int lingerVal = 0;
+    this->multicastPublisher->setsockopt(ZMQ_LINGER,
+        &lingerVal, sizeof(lingerVal));
+    setMulticastOptions(*this->multicastPublisher);
+    this->multicastPublisher->connect(
+      ("epgm://" + _hostAddr + ";" + address).c_str());
+    this->multicastAddress = address;
+  }
+  catch(const zmq::error_t &_error)
+  {
+    std::cerr << "Unable to send through multicast [" << address << "]: "
+              << _error.what() << ". Multicast topics are sent through TCP."
+              << std::endl;
+  }
+  return this->multicastAddress;
+}
+
+//////////////////////////////////////////////////
+bool NodeSharedPrivate::JoinMulticast(const std::string &_address,
+  const std::string &_hostAddr)
+{
+  std::lock_guard<std::mutex> lk(this->multicastMutex);
+  auto it = this->multicastGroups.find(_address);
+  if (it != this->multicastGroups.end())
+    return it->second;
+
+  bool joined = false;
+  try
+  {
+    setMulticastOptions(*this->multicastSubscriber);
+    this->multicastSubscriber->connect(
+      ("epgm://" + _hostAddr + ";" + _address).c_str());
+    joined = true;
+  }
+  catch(const zmq::error_t &_error)
+  {
+    std::cerr << "Unable to receive from multicast [" << _address << "]: "
+              << _error.what() << ". Falling back to TCP." << std::endl;
+  }
+  this->multicastGroups[_address] = joined;
+  return joined;
+}
+
+//////////////////////////////////////////////////
+zmq::context_t *NodeSharedPrivate::CreateContext()
+{
+  auto *ctx = new zmq::context_t(ioThreads());
+
+  // The I/O threads start with the first socket, so their affinity and
+  // scheduling policy must be set now.
+  std::string value;
+  if (env("IGN_TRANSPORT_IO_CPUS", value))
+  {
+    std::vector<int> cpus;
+    if (!parseCpuList(value, cpus))
+    {
+      std::cerr << "Invalid IGN_TRANSPORT_IO_CPUS value [" << value
+                << "]. Expected a list of CPUs, e.g. 0,2-3." << std::endl;
+    }
+#ifdef ZMQ_THREAD_AFFINITY_CPU_ADD
+    for (const auto cpu : cpus)
+    {
+      zmq_ctx_set(static_cast<void *>(*ctx), ZMQ_THREAD_AFFINITY_CPU_ADD,
+        cpu);
+    }
+#endif
+  }
+
+#ifndef _WIN32
+  if (env("IGN_TRANSPORT_IO_SCHED", value))
+  {
+    ThreadSchedule schedule;
+    if (!parseSchedule(value, schedule) || schedPolicy(schedule) < 0)
+    {
+      std::cerr << "Invalid IGN_TRANSPORT_IO_SCHED value [" << value
+                << "]. Expected other, batch, idle, fifo:<priority> or "
+                << "rr:<priority>." << std::endl;
+    }
+#ifdef ZMQ_THREAD_SCHED_POLICY
+    else
+    {
+      zmq_ctx_set(static_cast<void *>(*ctx), ZMQ_THREAD_SCHED_POLICY,
+        schedPolicy(schedule));
+      if (schedule.priority > 0)
+      {
+        zmq_ctx_set(static_cast<void *>(*ctx), ZMQ_THREAD_PRIORITY,
+          schedule.priority);
+      }
+    }
+#endif
+  }
+#endif
+
+  return ctx;
+}
+
 /////////////////////////////////////////////////
 void NodeSharedPrivate::PublishThread()
 {
+  configureThread("publish");
+
   // Loop until exits
   while (!this->exit)
   {
@@ -1475,6 +2639,16 @@ void NodeSharedPrivate::PublishThread()
       this->pubQueue.pop();
     }
 
+    msgDetails->info.SetReceptionTime(std::chrono::steady_clock::now());
+
+    if (!msgDetails->batchCopies.empty())
+    {
+      this->PublishBatch(*msgDetails);
+      if (msgDetails->counters)
+        msgDetails->counters->AddQueued(-1);
+      continue;
+    }
+
     // Send the message to all the local handlers.
     for (auto &handler : msgDetails->localHandlers)
     {
@@ -1507,5 +2681,58 @@ void NodeSharedPrivate::PublishThread()
           << std::endl;
       }
     }
+
+    if (msgDetails->counters)
+      msgDetails->counters->AddQueued(-1);
+  }
+}
+
+/////////////////////////////////////////////////
+void NodeSharedPrivate::PublishBatch(const PublishMsgDetails &_details)
+{
+  const uint64_t firstSequence = _details.info.SequenceNumber();
+
+  std::vector<std::pair<const ProtoMsg *, uint64_t>> batch;
+  batch.reserve(_details.batchCopies.size());
+  for (const auto &msg : _details.batchCopies)
+    batch.push_back(std::make_pair(msg.get(), firstSequence + batch.size()));
+
+  for (auto &handler : _details.localHandlers)
+  {
+    try
+    {
+      handler->RunLocalBatchCallback(batch, _details.info);
+    }
+    catch (...)
+    {
+      std::cerr << "Exception occurred in a local batch callback "
+        << "on topic [" << _details.info.Topic() << "]" << std::endl;
+    }
+  }
+
+  if (_details.rawHandlers.empty())
+    return;
+
+  std::vector<BatchEntry> entries;
+  if (!parseBatch(_details.sharedBuffer.get(), _details.msgSize, entries))
+    return;
+
+  MessageInfo info(_details.info);
+  for (auto &handler : _details.rawHandlers)
+  {
+    for (const BatchEntry &entry : entries)
+    {
+      try
+      {
+        info.SetSequenceNumber(firstSequence + entry.index);
+        info.SetSize(entry.size);
+        handler->RunRawCallback(entry.data, entry.size, info);
+      }
+      catch (...)
+      {
+        std::cerr << "Exception occured in a local raw callback "
+          << "on topic [" << info.Topic() << "]" << std::endl;
+      }
+    }
   }
 }
@@ -27,11 +27,25 @@
 #endif
 
 #include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "ignition/transport/Discovery.hh"
+#include "ignition/transport/MessageFilter.hh"
+#include "ignition/transport/MessageInfo.hh"
+#include "ignition/transport/Node.hh"
+
+#include "SequenceWindowPrivate.hh"
+#include "StatisticsPrivate.hh"
 
 namespace ignition
 {
@@ -45,9 +59,13 @@ namespace ignition
     {
       // Constructor
       public: NodeSharedPrivate() :
-                context(new zmq::context_t(1)),
+                context(CreateContext()),
                 publisher(new zmq::socket_t(*context, ZMQ_PUB)),
                 subscriber(new zmq::socket_t(*context, ZMQ_SUB)),
+                priorityPublisher(new zmq::socket_t(*context, ZMQ_PUB)),
+                prioritySubscriber(new zmq::socket_t(*context, ZMQ_SUB)),
+                multicastPublisher(new zmq::socket_t(*context, ZMQ_PUB)),
+                multicastSubscriber(new zmq::socket_t(*context, ZMQ_SUB)),
                 control(new zmq::socket_t(*context, ZMQ_DEALER)),
                 requester(new zmq::socket_t(*context, ZMQ_ROUTER)),
                 responseReceiver(new zmq::socket_t(*context, ZMQ_ROUTER)),
@@ -55,6 +73,28 @@ namespace ignition
       {
       }
 
+      /// \brief Create the 0MQ context, with the number of I/O threads and
+      /// their configuration set in the environment.
+      /// \return The new context.
+      public: static zmq::context_t *CreateContext();
+
+      /// \brief Connect the multicast publisher socket to the multicast
+      /// group, the first time it is called.
+      /// \param[in] _hostAddr Address of the interface to use.
+      /// \param[in] _pUuid Process UUID, which selects the port.
+      /// \return The multicast group and port or an empty string if
+      /// multicast is not available, e.g. if ZeroMQ has no PGM support.
+      public: std::string EnableMulticast(const std::string &_hostAddr,
+                                          const std::string &_pUuid);
+
+      /// \brief Connect the multicast subscriber socket to a multicast
+      /// group, if not connected yet.
+      /// \param[in] _address The multicast group and port.
+      /// \param[in] _hostAddr Address of the interface to use.
+      /// \return True if the socket is connected to the group.
+      public: bool JoinMulticast(const std::string &_address,
+                                 const std::string &_hostAddr);
+
       /// \brief Initialize security
       public: void SecurityInit();
 
@@ -83,6 +123,19 @@ namespace ignition
       /// \brief ZMQ socket to receive topic updates.
       public: std::unique_ptr<zmq::socket_t> subscriber;
 
+      /// \brief ZMQ socket to send updates of high priority topics.
+      public: std::unique_ptr<zmq::socket_t> priorityPublisher;
+
+      /// \brief ZMQ socket to receive updates of high priority topics.
+      public: std::unique_ptr<zmq::socket_t> prioritySubscriber;
+
+      /// \brief ZMQ socket to send the multicast topics. It is connected to
+      /// the multicast group when the first multicast topic is advertised.
+      public: std::unique_ptr<zmq::socket_t> multicastPublisher;
+
+      /// \brief ZMQ socket to receive the multicast topics.
+      public: std::unique_ptr<zmq::socket_t> multicastSubscriber;
+
       /// \brief ZMQ socket to receive control updates (new connections, ...).
       public: std::unique_ptr<zmq::socket_t> control;
 
@@ -112,6 +165,45 @@ namespace ignition
       /////// Other private member variables     ///////
       //////////////////////////////////////////////////
 
+      /// \brief Address of priorityPublisher.
+      public: std::string priorityAddress;
+
+      /// \brief IPC address of publisher, used by the subscribers running on
+      /// the same host. Empty if the socket could not be bound.
+      public: std::string ipcAddress;
+
+      /// \brief IPC address of priorityPublisher.
+      public: std::string priorityIpcAddress;
+
+      /// \brief Protects the multicast members.
+      public: std::mutex multicastMutex;
+
+      /// \brief Whether EnableMulticast() has been called.
+      public: bool multicastEnabled = false;
+
+      /// \brief Multicast group and port of multicastPublisher, or an empty
+      /// string if multicast is not available.
+      public: std::string multicastAddress;
+
+      /// \brief Multicast groups and ports joined by multicastSubscriber,
+      /// with the result of the attempt.
+      public: std::map<std::string, bool> multicastGroups;
+
+      /// \brief Sequence numbers received from the publishers of the topics
+      /// received through multicast. These topics are also sent through TCP,
+      /// so a message can arrive twice. The key is the fully-qualified topic
+      /// name and the value is a map whose key is the publisher UUID.
+      /// Protected by NodeShared::mutex.
+      public: std::map<std::string, std::map<std::string, SequenceWindow>>
+        multicastSequences;
+
+      /// \brief Topic, partition and type of the messages received on each
+      /// subscribed topic. The topic is set when it is subscribed and the
+      /// type when it changes, and the MessageInfo of every message received
+      /// shares them. The key is the fully-qualified topic name.
+      /// Protected by NodeShared::mutex.
+      public: std::unordered_map<std::string, MessageInfo> topicInfos;
+
       /// \brief When true, the reception thread will finish.
       public: std::atomic<bool> exit = false;
 
@@ -146,12 +238,22 @@ namespace ignition
                 /// \brief Msg copy for the local handlers.
                 public: std::unique_ptr<ProtoMsg> msgCopy = nullptr;
 
+                /// \brief Msg copies for the local handlers when a batch of
+                /// messages is published. Then msgCopy is null, sharedBuffer
+                /// has the serialized batch and the sequence number of info
+                /// is the one of the first message.
+                public: std::vector<std::unique_ptr<ProtoMsg>> batchCopies;
+
                 /// \brief Message size.
                 // cppcheck-suppress unusedStructMember
                 public: std::size_t msgSize = 0;
 
                 /// \brief Information about the topic and type.
                 public: MessageInfo info;
+
+                /// \brief Statistics of the publisher, or nullptr if the
+                /// statistics are disabled.
+                public: std::shared_ptr<EndpointCounters> counters;
               };
 
       /// \brief Publish thread used to process the pubQueue.
@@ -169,6 +271,210 @@ namespace ignition
 
       /// \brief Handles local publication of messages on the pubQueue.
       public: void PublishThread();
+
+      /// \brief Deliver a batch of messages taken from the pubQueue.
+      /// \param[in] _details The batch.
+      public: void PublishBatch(const PublishMsgDetails &_details);
+
+      ////////////////////////////////////////////////////////////////
+      /////// The following is for the statistics published on   ///////
+      /////// kStatisticsTopic when IGN_TRANSPORT_STATS is set.   ///////
+      ////////////////////////////////////////////////////////////////
+
+      /// \brief Statistics of an advertised topic.
+      public: struct PublisherStatistics
+              {
+                /// \brief The publisher.
+                public: MessagePublisher publisher;
+
+                /// \brief Counters of the publisher. They are owned by the
+                /// Node::Publisher, so this expires when it is destroyed.
+                public: std::weak_ptr<EndpointCounters> counters;
+              };
+
+      /// \brief Register the counters of a publisher.
+      /// \param[in] _publisher The publisher.
+      /// \param[in] _counters Counters of the publisher.
+      public: void AddPublisherStatistics(const MessagePublisher &_publisher,
+                  const std::shared_ptr<EndpointCounters> &_counters)
+      {
+        std::lock_guard<std::mutex> lk(this->statsMutex);
+        this->publisherStats.push_back({_publisher, _counters});
+      }
+
+      /// \brief Whether StartStatistics() has already been called.
+      public: std::atomic<bool> statsStarted{false};
+
+      /// \brief Node that owns statsPublisher.
+      public: std::unique_ptr<Node> statsNode;
+
+      /// \brief Publisher of the statistics, advertised by StartStatistics().
+      /// It is a pointer because a Node::Publisher needs NodeShared::Instance()
+      /// when it is constructed.
+      public: std::unique_ptr<Node::Publisher> statsPublisher;
+
+      /// \brief Thread that publishes the statistics periodically.
+      public: std::thread statsThread;
+
+      /// \brief Protects publisherStats and is used with statsCondition.
+      public: std::mutex statsMutex;
+
+      /// \brief Used to wake up the statistics thread on exit.
+      public: std::condition_variable statsCondition;
+
+      /// \brief Counters of all the publishers of this process.
+      public: std::vector<PublisherStatistics> publisherStats;
+
+      ////////////////////////////////////////////////////////////////
+      /////// The following is for Publisher::WaitForSubscribers ///////
+      ////////////////////////////////////////////////////////////////
+
+      /// \brief Wake up the threads waiting for subscribers. Call it every
+      /// time a local or remote subscriber is added or removed.
+      public: void NotifySubscribersChanged()
+      {
+        {
+          std::lock_guard<std::mutex> lk(this->subscribersMutex);
+          ++this->subscribersGeneration;
+        }
+        this->subscribersCondition.notify_all();
+      }
+
+      /// \brief Used with subscribersCondition. Never lock NodeShared::mutex
+      /// while holding it, because NotifySubscribersChanged() is called with
+      /// NodeShared::mutex locked.
+      public: std::mutex subscribersMutex;
+
+      /// \brief Notified when the subscribers change.
+      public: std::condition_variable subscribersCondition;
+
+      /// \brief Incremented every time the subscribers change. It is only
+      /// written with subscribersMutex locked, but it can be read without it
+      /// to detect changes.
+      public: std::atomic<uint64_t> subscribersGeneration{0};
+
+      ////////////////////////////////////////////////////////////////
+      ///////// The following is for the filters of the messages /////////
+      ////////////////////////////////////////////////////////////////
+
+      /// \brief Set the filter of a remote subscriber. NodeShared::mutex
+      /// must be locked.
+      /// \param[in] _topic Fully-qualified topic name.
+      /// \param[in] _pUuid Process UUID of the subscriber.
+      /// \param[in] _nUuid Node UUID of the subscriber.
+      /// \param[in] _filter The filter. An empty filter removes the entry.
+      public: void SetRemoteFilter(const std::string &_topic,
+                                   const std::string &_pUuid,
+                                   const std::string &_nUuid,
+                                   const MessageFilter &_filter)
+      {
+        if (_filter.Empty())
+        {
+          auto topic = this->remoteFilters.find(_topic);
+          if (topic == this->remoteFilters.end())
+            return;
+
+          topic->second.erase(_nUuid);
+          if (topic->second.empty())
+            this->remoteFilters.erase(topic);
+          return;
+        }
+
+        this->remoteFilters[_topic][_nUuid] =
+          std::make_pair(_pUuid, _filter);
+      }
+
+      /// \brief Remove the filters of all the remote subscribers of a
+      /// process. NodeShared::mutex must be locked.
+      /// \param[in] _pUuid Process UUID.
+      public: void DelRemoteFiltersByProc(const std::string &_pUuid)
+      {
+        for (auto topic = this->remoteFilters.begin();
+             topic != this->remoteFilters.end();)
+        {
+          for (auto node = topic->second.begin();
+               node != topic->second.end();)
+          {
+            if (node->second.first == _pUuid)
+              node = topic->second.erase(node);
+            else
+              ++node;
+          }
+
+          if (topic->second.empty())
+            topic = this->remoteFilters.erase(topic);
+          else
+            ++topic;
+        }
+      }
+
+      /// \brief Filters of the remote subscribers that asked for one. The
+      /// key is the fully-qualified topic name and the value is a map whose
+      /// key is the node UUID and whose value is the process UUID and the
+      /// filter. Protected by NodeShared::mutex.
+      public: std::map<std::string, std::map<std::string,
+        std::pair<std::string, MessageFilter>>> remoteFilters;
+
+      ////////////////////////////////////////////////////////////////
+      ///////// The following is for the batches of messages   /////////
+      ////////////////////////////////////////////////////////////////
+
+      /// \brief Set whether a remote subscriber accepts batches of messages.
+      /// NodeShared::mutex must be locked.
+      /// \param[in] _topic Fully-qualified topic name.
+      /// \param[in] _pUuid Process UUID of the subscriber.
+      /// \param[in] _nUuid Node UUID of the subscriber.
+      /// \param[in] _accepts Whether the subscriber accepts batches.
+      public: void SetRemoteBatchSupport(const std::string &_topic,
+                                         const std::string &_pUuid,
+                                         const std::string &_nUuid,
+                                         const bool _accepts)
+      {
+        if (!_accepts)
+        {
+          auto topic = this->remoteBatchSupport.find(_topic);
+          if (topic == this->remoteBatchSupport.end())
+            return;
+
+          topic->second.erase(_nUuid);
+          if (topic->second.empty())
+            this->remoteBatchSupport.erase(topic);
+          return;
+        }
+
+        this->remoteBatchSupport[_topic][_nUuid] = _pUuid;
+      }
+
+      /// \brief Forget the remote subscribers of a process that accept
+      /// batches. NodeShared::mutex must be locked.
+      /// \param[in] _pUuid Process UUID.
+      public: void DelRemoteBatchSupportByProc(const std::string &_pUuid)
+      {
+        for (auto topic = this->remoteBatchSupport.begin();
+             topic != this->remoteBatchSupport.end();)
+        {
+          for (auto node = topic->second.begin();
+               node != topic->second.end();)
+          {
+            if (node->second == _pUuid)
+              node = topic->second.erase(node);
+            else
+              ++node;
+          }
+
+          if (topic->second.empty())
+            topic = this->remoteBatchSupport.erase(topic);
+          else
+            ++topic;
+        }
+      }
+
+      /// \brief Remote subscribers that accept batches. The key is the
+      /// fully-qualified topic name and the value is a map whose key is the
+      /// node UUID and whose value is the process UUID. Protected by
+      /// NodeShared::mutex.
+      public: std::map<std::string, std::map<std::string, std::string>>
+        remoteBatchSupport;
     };
     }
   }
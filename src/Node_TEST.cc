@@ -15,13 +15,16 @@
  *
 */
 
+#include <algorithm>
 #include <chrono>
 #include <csignal>
 #include <cstdlib>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 #include <ignition/msgs.hh>
 
 #include "gtest/gtest.h"
@@ -777,6 +780,166 @@ TEST(NodeTest, RawPubRawSubSameThreadMessageInfo)
   reset();
 }
 
+//////////////////////////////////////////////////
+TEST(NodeTest, RawPubZeroCopy)
+{
+  reset();
+
+  ignition::msgs::Int32 msg;
+  msg.set_data(data);
+
+  auto buffer = std::make_shared<std::string>(msg.SerializeAsString());
+
+  transport::Node node;
+  auto pub = node.Advertise<ignition::msgs::Int32>(g_topic);
+  EXPECT_TRUE(pub);
+
+  // Raw subscribers get the buffer of the publisher itself
+  const char *received = nullptr;
+  transport::RawCallback rawCb =
+    [&](const char *_data, const std::size_t _size,
+        const transport::MessageInfo &_info)
+    {
+      received = _data;
+      EXPECT_EQ(buffer->size(), _size);
+      EXPECT_EQ(msg.GetTypeName(), _info.Type());
+    };
+  EXPECT_TRUE(node.SubscribeRaw(g_topic, rawCb));
+  EXPECT_TRUE(node.Subscribe(g_topic, cbInfo));
+
+  // Wait some time before publishing.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  EXPECT_TRUE(pub.PublishRaw(buffer->data(), buffer->size(),
+      msg.GetTypeName(), buffer));
+
+  // Local subscribers run synchronously
+  EXPECT_EQ(buffer->data(), received);
+  EXPECT_TRUE(cbExecuted);
+
+  // Without remote subscribers nobody else holds the buffer
+  EXPECT_EQ(1, buffer.use_count());
+
+  reset();
+
+  // Without an owner, the data is copied for remote subscribers
+  received = nullptr;
+  EXPECT_TRUE(pub.PublishRaw(buffer->data(), buffer->size(),
+      msg.GetTypeName(), nullptr));
+  EXPECT_EQ(buffer->data(), received);
+  EXPECT_TRUE(cbExecuted);
+
+  reset();
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that WaitForSubscribers() wakes up when a subscriber
+/// appears and times out otherwise.
+TEST(NodeTest, PubWaitForSubscribers)
+{
+  transport::Node::Publisher invalidPub;
+  EXPECT_FALSE(invalidPub.WaitForSubscribers(1, 10));
+  EXPECT_FALSE(invalidPub.WaitForSubscribersAsync(1, 10).get());
+
+  transport::Node node;
+  auto pub = node.Advertise<ignition::msgs::Int32>(g_topic);
+  ASSERT_TRUE(pub);
+
+  EXPECT_TRUE(pub.WaitForSubscribers(0, 0));
+
+  // No subscribers.
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(pub.WaitForSubscribers(1, 100));
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(100));
+
+  // Subscribers with the wrong type do not count.
+  transport::Node subNode;
+  EXPECT_TRUE(subNode.Subscribe(g_topic, cbVector));
+  EXPECT_FALSE(pub.WaitForSubscribers(1, 10));
+
+  auto future = pub.WaitForSubscribersAsync(2, 5000);
+  std::thread subscriber([]
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      transport::Node otherNode;
+      EXPECT_TRUE(otherNode.Subscribe(g_topic, cb));
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    });
+
+  start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(pub.WaitForSubscribers(1, 5000));
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(500));
+
+  EXPECT_TRUE(subNode.Subscribe(g_topic, cbInfo));
+  EXPECT_TRUE(subNode.Subscribe(g_topic, genericCb));
+  EXPECT_TRUE(future.get());
+
+  // Two handlers of the same node count as one subscriber.
+  EXPECT_FALSE(pub.WaitForSubscribers(3, 10));
+
+  subscriber.join();
+
+  // The node of the thread is gone.
+  EXPECT_TRUE(pub.WaitForSubscribers(1, 10));
+  EXPECT_FALSE(pub.WaitForSubscribers(2, 10));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that every message carries the publication time, the
+/// publisher UUID and consecutive sequence numbers.
+TEST(NodeTest, PubSubMessageHeader)
+{
+  reset();
+
+  ignition::msgs::Int32 msg;
+  msg.set_data(data);
+
+  transport::Node node;
+  auto pub = node.Advertise<ignition::msgs::Int32>(g_topic);
+  EXPECT_TRUE(pub);
+  auto pub2 = node.Advertise<ignition::msgs::Int32>(g_topic_remap);
+  EXPECT_TRUE(pub2);
+
+  std::mutex mutex;
+  std::vector<uint64_t> sequence;
+  std::vector<std::string> uuids;
+  std::function<void(const ignition::msgs::Int32 &,
+                     const transport::MessageInfo &)> cb =
+    [&](const ignition::msgs::Int32 &, const transport::MessageInfo &_info)
+    {
+      EXPECT_LE(_info.PublicationTime(), std::chrono::steady_clock::now());
+      EXPECT_GT(_info.PublicationTime(), std::chrono::steady_clock::now() -
+        std::chrono::seconds(5));
+      std::lock_guard<std::mutex> lk(mutex);
+      sequence.push_back(_info.SequenceNumber());
+      uuids.push_back(_info.PublisherUuid());
+    };
+  EXPECT_TRUE(node.Subscribe(g_topic, cb));
+  EXPECT_TRUE(node.Subscribe(g_topic_remap, cb));
+
+  EXPECT_TRUE(pub.Publish(msg));
+  EXPECT_TRUE(pub.PublishRaw(msg.SerializeAsString(), msg.GetTypeName()));
+  EXPECT_TRUE(pub.Publish(msg));
+  EXPECT_TRUE(pub2.Publish(msg));
+
+  // Give some time to the subscribers.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::lock_guard<std::mutex> lk(mutex);
+  ASSERT_EQ(4u, sequence.size());
+  std::sort(sequence.begin(), sequence.end());
+  EXPECT_EQ(std::vector<uint64_t>({1u, 1u, 2u, 3u}), sequence);
+
+  // Two different publishers.
+  std::sort(uuids.begin(), uuids.end());
+  EXPECT_FALSE(uuids[0].empty());
+  EXPECT_EQ(2, std::unique(uuids.begin(), uuids.end()) - uuids.begin());
+
+  reset();
+}
+
 //////////////////////////////////////////////////
 TEST(NodeTest, PubRawSubSameThreadMessageInfo)
 {
@@ -1943,6 +2106,177 @@ TEST(NodeTest, SubThrottled)
   reset();
 }
 
+//////////////////////////////////////////////////
+/// \brief Check that a subscriber only receives the messages that match its
+/// filter, and that invalid filters are rejected.
+TEST(NodeTest, SubFiltered)
+{
+  transport::Node node;
+
+  auto pub = node.Advertise<ignition::msgs::Int32>(g_topic);
+  EXPECT_TRUE(pub);
+
+  std::mutex mutex;
+  std::vector<int> received;
+  std::function<void(const ignition::msgs::Int32 &)> filteredCb =
+    [&mutex, &received](const ignition::msgs::Int32 &_msg)
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      received.push_back(_msg.data());
+    };
+
+  ignition::transport::SubscribeOptions invalidOpts;
+  invalidOpts.SetFilter("data >");
+  EXPECT_FALSE(node.Subscribe(g_topic, filteredCb, invalidOpts));
+
+  ignition::transport::SubscribeOptions opts;
+  opts.SetFilter("data > 5 && data != 8");
+  EXPECT_TRUE(node.Subscribe(g_topic, filteredCb, opts));
+
+  ignition::msgs::Int32 msg;
+  for (auto i = 1; i <= 10; ++i)
+  {
+    msg.set_data(i);
+    EXPECT_TRUE(pub.Publish(msg));
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::lock_guard<std::mutex> lk(mutex);
+  EXPECT_EQ(std::vector<int>({6, 7, 9, 10}), received);
+}
+
+//////////////////////////////////////////////////
+/// \brief Publish batches of messages and receive them with batch, single
+/// message and raw subscribers.
+TEST(NodeTest, PubSubBatch)
+{
+  transport::Node node;
+
+  auto pub = node.Advertise<ignition::msgs::Int32>(g_topic);
+  EXPECT_TRUE(pub);
+
+  std::mutex mutex;
+  std::vector<std::vector<int>> batches;
+  std::vector<uint64_t> batchSequences;
+  std::vector<int> singles;
+  std::vector<uint64_t> singleSequences;
+  std::vector<int> raws;
+
+  transport::MsgBatchCallback<ignition::msgs::Int32> batchCb =
+    [&](const std::vector<const ignition::msgs::Int32 *> &_msgs,
+        const transport::MessageInfo &_info)
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      std::vector<int> batch;
+      for (const auto *msg : _msgs)
+        batch.push_back(msg->data());
+      batches.push_back(batch);
+      batchSequences.push_back(_info.SequenceNumber());
+    };
+  EXPECT_TRUE(node.SubscribeBatch(g_topic, batchCb));
+
+  std::function<void(const ignition::msgs::Int32 &,
+                     const transport::MessageInfo &)> singleCb =
+    [&](const ignition::msgs::Int32 &_msg,
+        const transport::MessageInfo &_info)
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      singles.push_back(_msg.data());
+      singleSequences.push_back(_info.SequenceNumber());
+    };
+  EXPECT_TRUE(node.Subscribe(g_topic, singleCb));
+
+  EXPECT_TRUE(node.SubscribeRaw(g_topic,
+    [&](const char *_data, const std::size_t _size,
+        const transport::MessageInfo &)
+    {
+      ignition::msgs::Int32 msg;
+      EXPECT_TRUE(msg.ParseFromArray(_data, static_cast<int>(_size)));
+      std::lock_guard<std::mutex> lk(mutex);
+      raws.push_back(msg.data());
+    }, ignition::msgs::Int32().GetTypeName()));
+
+  std::vector<ignition::msgs::Int32> msgs(3);
+  for (auto i = 0u; i < msgs.size(); ++i)
+    msgs[i].set_data(static_cast<int>(i) + 1);
+
+  ignition::msgs::Int32 msg;
+  msg.set_data(4);
+  EXPECT_TRUE(pub.PublishBatch(msgs));
+  EXPECT_TRUE(pub.Publish(msg));
+
+  // PublishRawBatch() calls the local subscribers synchronously, so wait
+  // for the previous messages first.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::vector<std::string> rawMsgs(2);
+  msg.set_data(5);
+  msg.SerializeToString(&rawMsgs[0]);
+  msg.set_data(6);
+  msg.SerializeToString(&rawMsgs[1]);
+  EXPECT_TRUE(pub.PublishRawBatch(rawMsgs, msg.GetTypeName()));
+
+  // Empty batches are ignored, and type mismatches are rejected.
+  EXPECT_TRUE(pub.PublishBatch(std::vector<ignition::msgs::Int32>()));
+  EXPECT_FALSE(pub.PublishBatch(std::vector<ignition::msgs::Vector3d>(1)));
+  EXPECT_FALSE(pub.PublishRawBatch(rawMsgs,
+    ignition::msgs::Vector3d().GetTypeName()));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::lock_guard<std::mutex> lk(mutex);
+  ASSERT_EQ(3u, batches.size());
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), batches[0]);
+  EXPECT_EQ(std::vector<int>({4}), batches[1]);
+  EXPECT_EQ(std::vector<int>({5, 6}), batches[2]);
+  EXPECT_EQ(std::vector<uint64_t>({1, 4, 5}), batchSequences);
+
+  EXPECT_EQ(std::vector<int>({1, 2, 3, 4, 5, 6}), singles);
+  EXPECT_EQ(std::vector<uint64_t>({1, 2, 3, 4, 5, 6}), singleSequences);
+  EXPECT_EQ(std::vector<int>({1, 2, 3, 4, 5, 6}), raws);
+}
+
+//////////////////////////////////////////////////
+/// \brief A throttled publisher counts a batch as a single publication, and
+/// the filter of a batch subscriber applies to every message.
+TEST(NodeTest, PubSubBatchThrottledFiltered)
+{
+  transport::Node node;
+
+  transport::AdvertiseMessageOptions advOpts;
+  advOpts.SetMsgsPerSec(1u);
+  auto pub = node.Advertise<ignition::msgs::Int32>(g_topic, advOpts);
+  EXPECT_TRUE(pub);
+
+  std::mutex mutex;
+  std::vector<int> received;
+  transport::MsgBatchCallback<ignition::msgs::Int32> batchCb =
+    [&](const std::vector<const ignition::msgs::Int32 *> &_msgs,
+        const transport::MessageInfo &)
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      for (const auto *msg : _msgs)
+        received.push_back(msg->data());
+    };
+
+  transport::SubscribeOptions opts;
+  opts.SetFilter("data != 2");
+  EXPECT_TRUE(node.SubscribeBatch(g_topic, batchCb, opts));
+
+  std::vector<ignition::msgs::Int32> msgs(3);
+  for (auto i = 0u; i < msgs.size(); ++i)
+    msgs[i].set_data(static_cast<int>(i) + 1);
+
+  EXPECT_TRUE(pub.PublishBatch(msgs));
+  EXPECT_TRUE(pub.PublishBatch(msgs));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::lock_guard<std::mutex> lk(mutex);
+  EXPECT_EQ(std::vector<int>({1, 3}), received);
+}
+
 //////////////////////////////////////////////////
 /// \brief This test creates one publisher and one subscriber. The publisher
 /// publishes at a throttled frequency .
@@ -29,6 +29,19 @@
 using namespace ignition;
 using namespace transport;
 
+/// \brief Key of the discovery header entry with the priority of a topic.
+static const char kPriorityKey[] = "priority";
+
+/// \brief Value of the priority entry for high priority topics.
+static const char kHighPriority[] = "high";
+
+/// \brief Key of the discovery header entry with the IPC address of a topic.
+static const char kIpcKey[] = "ipc";
+
+/// \brief Key of the discovery header entry with the multicast group and
+/// port of a topic.
+static const char kMulticastKey[] = "multicast";
+
 //////////////////////////////////////////////////
 Publisher::Publisher(const std::string &_topic, const std::string &_addr,
   const std::string &_pUuid, const std::string &_nUuid,
@@ -478,6 +491,30 @@ void MessagePublisher::SetCtrl(const std::string &_ctrl)
   this->ctrl = _ctrl;
 }
 
+//////////////////////////////////////////////////
+std::string MessagePublisher::IpcAddr() const
+{
+  return this->ipcAddr;
+}
+
+//////////////////////////////////////////////////
+void MessagePublisher::SetIpcAddr(const std::string &_ipcAddr)
+{
+  this->ipcAddr = _ipcAddr;
+}
+
+//////////////////////////////////////////////////
+std::string MessagePublisher::MulticastAddr() const
+{
+  return this->multicastAddr;
+}
+
+//////////////////////////////////////////////////
+void MessagePublisher::SetMulticastAddr(const std::string &_multicastAddr)
+{
+  this->multicastAddr = _multicastAddr;
+}
+
 //////////////////////////////////////////////////
 std::string MessagePublisher::MsgTypeName() const
 {
@@ -513,6 +550,30 @@ void MessagePublisher::FillDiscovery(msgs::Discovery &_msg) const
   pub->mutable_msg_pub()->set_msg_type(this->MsgTypeName());
   pub->mutable_msg_pub()->set_throttled(this->msgOpts.Throttled());
   pub->mutable_msg_pub()->set_msgs_per_sec(this->msgOpts.MsgsPerSec());
+
+  // The discovery message has no field for the priority, so it is sent in
+  // the header. Older versions ignore it and use the normal lane.
+  if (this->msgOpts.Priority() == Priority_t::HIGH)
+  {
+    auto *data = _msg.mutable_header()->add_data();
+    data->set_key(kPriorityKey);
+    data->add_value(kHighPriority);
+  }
+
+  // Same for the IPC address. Older versions always connect through TCP.
+  if (!this->ipcAddr.empty())
+  {
+    auto *data = _msg.mutable_header()->add_data();
+    data->set_key(kIpcKey);
+    data->add_value(this->ipcAddr);
+  }
+
+  if (!this->multicastAddr.empty())
+  {
+    auto *data = _msg.mutable_header()->add_data();
+    data->set_key(kMulticastKey);
+    data->add_value(this->multicastAddr);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -526,6 +587,27 @@ void MessagePublisher::SetFromDiscovery(const msgs::Discovery &_msg)
     this->msgOpts.SetMsgsPerSec(kUnthrottled);
   else
     this->msgOpts.SetMsgsPerSec(_msg.pub().msg_pub().msgs_per_sec());
+
+  this->msgOpts.SetPriority(Priority_t::NORMAL);
+  this->ipcAddr.clear();
+  this->multicastAddr.clear();
+  for (const auto &data : _msg.header().data())
+  {
+    if (data.key() == kPriorityKey && data.value_size() > 0 &&
+        data.value(0) == kHighPriority)
+    {
+      this->msgOpts.SetPriority(Priority_t::HIGH);
+    }
+    else if (data.key() == kIpcKey && data.value_size() > 0)
+    {
+      this->ipcAddr = data.value(0);
+    }
+    else if (data.key() == kMulticastKey && data.value_size() > 0)
+    {
+      this->multicastAddr = data.value(0);
+    }
+  }
+  this->msgOpts.SetMulticast(!this->multicastAddr.empty());
 }
 
 //////////////////////////////////////////////////
@@ -547,6 +629,8 @@ MessagePublisher &MessagePublisher::operator=(const MessagePublisher &_other)
 {
   Publisher::operator=(_other);
   this->SetCtrl(_other.Ctrl());
+  this->SetIpcAddr(_other.IpcAddr());
+  this->SetMulticastAddr(_other.MulticastAddr());
   this->SetMsgTypeName(_other.MsgTypeName());
   this->SetOptions(_other.Options());
   return *this;
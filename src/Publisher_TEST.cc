@@ -221,6 +221,49 @@ TEST(PublisherTest, MessagePublisherIO)
   EXPECT_EQ(publisher.NUuid(),       otherPublisher.NUuid());
   EXPECT_EQ(publisher.MsgTypeName(), otherPublisher.MsgTypeName());
   EXPECT_EQ(publisher.Options(),     otherPublisher.Options());
+
+  // The priority is sent in the header of the discovery message.
+  AdvertiseMessageOptions priorityOpts(g_msgOpts2);
+  priorityOpts.SetPriority(Priority_t::HIGH);
+  publisher.SetOptions(priorityOpts);
+
+  msgs::Discovery priorityMsg;
+  publisher.FillDiscovery(priorityMsg);
+  otherPublisher.SetFromDiscovery(priorityMsg);
+  EXPECT_EQ(Priority_t::HIGH, otherPublisher.Options().Priority());
+  EXPECT_EQ(publisher.Options(), otherPublisher.Options());
+
+  otherPublisher.SetFromDiscovery(msg);
+  EXPECT_EQ(Priority_t::NORMAL, otherPublisher.Options().Priority());
+
+  // The IPC address is also sent in the header.
+  EXPECT_TRUE(otherPublisher.IpcAddr().empty());
+  publisher.SetIpcAddr("ipc:///tmp/tmpAbC/socket");
+  msgs::Discovery ipcMsg;
+  publisher.FillDiscovery(ipcMsg);
+  otherPublisher.SetFromDiscovery(ipcMsg);
+  EXPECT_EQ("ipc:///tmp/tmpAbC/socket", otherPublisher.IpcAddr());
+  EXPECT_EQ(Priority_t::HIGH, otherPublisher.Options().Priority());
+
+  MessagePublisher copy(otherPublisher);
+  EXPECT_EQ(otherPublisher.IpcAddr(), copy.IpcAddr());
+
+  otherPublisher.SetFromDiscovery(msg);
+  EXPECT_TRUE(otherPublisher.IpcAddr().empty());
+
+  // The multicast address enables the multicast option.
+  EXPECT_TRUE(otherPublisher.MulticastAddr().empty());
+  EXPECT_FALSE(otherPublisher.Options().Multicast());
+  publisher.SetMulticastAddr("239.255.0.8:10401");
+  msgs::Discovery multicastMsg;
+  publisher.FillDiscovery(multicastMsg);
+  otherPublisher.SetFromDiscovery(multicastMsg);
+  EXPECT_EQ("239.255.0.8:10401", otherPublisher.MulticastAddr());
+  EXPECT_TRUE(otherPublisher.Options().Multicast());
+
+  otherPublisher.SetFromDiscovery(msg);
+  EXPECT_TRUE(otherPublisher.MulticastAddr().empty());
+  EXPECT_FALSE(otherPublisher.Options().Multicast());
 }
 
 //////////////////////////////////////////////////
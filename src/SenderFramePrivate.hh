@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGN_TRANSPORT_SENDERFRAMEPRIVATE_HH_
+#define IGN_TRANSPORT_SENDERFRAMEPRIVATE_HH_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ignition/transport/config.hh"
+#include "ignition/transport/MessageInfo.hh"
+
+namespace ignition
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_TRANSPORT_VERSION_NAMESPACE {
+    //
+    /// \brief The sender frame of a message contains the address of the
+    /// publisher, optionally followed by a '\0' and a header. Receivers that
+    /// do not know about the header discard the whole frame, so the header
+    /// does not change the number of frames of a message.
+    ///
+    /// The header starts with a version, which identifies its layout. The
+    /// version must change whenever the layout does, and receivers ignore
+    /// headers with a version they do not know. All the integers are 64 bit
+    /// unsigned integers in little endian order.
+    ///
+    /// Version 1: publication time, sequence number, publisher UUID.
+    /// Version 2: publication time, sequence number, downsampling period,
+    ///            publisher UUID.
+    /// Version 3: publication time, sequence number, downsampling period,
+    ///            number of messages of a batch, publisher UUID.
+    const char kMsgHeaderVersion1 = 1;
+
+    /// \brief See kMsgHeaderVersion1. Used for single messages.
+    const char kMsgHeaderVersion2 = 2;
+
+    /// \brief See kMsgHeaderVersion1. Used for batches.
+    const char kMsgHeaderVersion3 = 3;
+
+    //////////////////////////////////////////////////
+    /// \brief Get the size of the fixed part of a header, i.e. everything
+    /// but the publisher UUID.
+    /// \param[in] _version Version of the header.
+    /// \return The size, or 0 if the version is not known.
+    inline std::size_t msgHeaderSize(const char _version)
+    {
+      switch (_version)
+      {
+        case kMsgHeaderVersion1:
+          return 1 + 8 + 8;
+        case kMsgHeaderVersion2:
+          return 1 + 8 + 8 + 8;
+        case kMsgHeaderVersion3:
+          return 1 + 8 + 8 + 8 + 8;
+        default:
+          return 0;
+      }
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Write a 64 bit unsigned integer in little endian order.
+    /// \param[out] _buffer Buffer with room for 8 bytes.
+    /// \param[in] _value The integer.
+    inline void writeUint64(char *_buffer, uint64_t _value)
+    {
+      for (int i = 0; i < 8; ++i)
+      {
+        _buffer[i] = static_cast<char>(_value & 0xff);
+        _value >>= 8;
+      }
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Read a 64 bit unsigned integer in little endian order.
+    /// \param[in] _data Buffer with at least 8 bytes.
+    /// \return The integer.
+    inline uint64_t readUint64(const char *_data)
+    {
+      uint64_t value = 0;
+      for (int i = 7; i >= 0; --i)
+        value = (value << 8) | static_cast<unsigned char>(_data[i]);
+      return value;
+    }
+
+    /// \brief The sender frame of the messages of a publisher. The address,
+    /// the version and the publisher UUID do not change, so the frame is
+    /// built once and only the integers of the header are rewritten before
+    /// sending a message. The caller must serialize Update() and the send
+    /// of the frame.
+    class SenderFrame
+    {
+      /// \brief Constructor.
+      /// \param[in] _address Address of the socket that sends the messages.
+      /// \param[in] _uuid UUID of the publisher.
+      /// \param[in] _batch Whether the frame is for batches of messages
+      /// (version 3) or for single messages (version 2).
+      public: SenderFrame(const std::string &_address,
+                          const std::string &_uuid,
+                          const bool _batch = false)
+      {
+        const char version = _batch ? kMsgHeaderVersion3 : kMsgHeaderVersion2;
+        const std::size_t headerSize = msgHeaderSize(version);
+
+        this->frame.reserve(_address.size() + 1 + headerSize + _uuid.size());
+        this->frame += _address;
+        this->frame.push_back('\0');
+        this->headerOffset = this->frame.size();
+        this->frame.push_back(version);
+        this->frame.append(headerSize - 1, '\0');
+        this->frame += _uuid;
+      }
+
+      /// \brief Set the header of the next message.
+      /// \param[in] _header Publication time and sequence number of the
+      /// message, and downsampling period of the publisher.
+      /// \param[in] _batchSize Number of messages of the batch. Ignored if
+      /// the frame is not for batches.
+      public: void Update(const MessageInfo &_header,
+                          const uint64_t _batchSize = 0)
+      {
+        char *header = &this->frame[this->headerOffset];
+        writeUint64(header + 1, static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+            _header.PublicationTime().time_since_epoch()).count()));
+        writeUint64(header + 9, _header.SequenceNumber());
+        writeUint64(header + 17, static_cast<uint64_t>(
+          _header.DownsamplingPeriod().count()));
+        if (header[0] == kMsgHeaderVersion3)
+          writeUint64(header + 25, _batchSize);
+      }
+
+      /// \brief Get the frame.
+      /// \return The frame.
+      public: const std::string &Data() const
+      {
+        return this->frame;
+      }
+
+      /// \brief The frame.
+      private: std::string frame;
+
+      /// \brief Position of the header in the frame.
+      private: std::size_t headerOffset = 0;
+    };
+
+    //////////////////////////////////////////////////
+    /// \brief Read the header of a sender frame, if any.
+    /// \param[in] _data The sender frame.
+    /// \param[in] _size Size of the sender frame.
+    /// \param[out] _info Gets the publication time, the sequence number, the
+    /// downsampling period and the publisher UUID of the header.
+    /// \param[out] _batchSize Number of messages of the batch, or 0 if it is
+    /// a single message or the frame has no header.
+    inline void parseSenderFrame(const char *_data, const std::size_t _size,
+                                 MessageInfo &_info, uint64_t &_batchSize)
+    {
+      _batchSize = 0;
+
+      const char *end = _data + _size;
+      const char *header = std::find(_data, end, '\0');
+      if (header == end)
+        return;
+
+      ++header;
+      if (header == end)
+        return;
+
+      const std::size_t headerSize = msgHeaderSize(header[0]);
+      if (headerSize == 0 ||
+          static_cast<std::size_t>(end - header) < headerSize)
+      {
+        return;
+      }
+
+      _info.SetPublicationTime(std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::nanoseconds(
+            static_cast<int64_t>(readUint64(header + 1))))));
+      _info.SetSequenceNumber(readUint64(header + 9));
+      if (header[0] != kMsgHeaderVersion1)
+      {
+        _info.SetDownsamplingPeriod(std::chrono::nanoseconds(
+          static_cast<int64_t>(readUint64(header + 17))));
+      }
+      if (header[0] == kMsgHeaderVersion3)
+        _batchSize = readUint64(header + 25);
+      _info.SetPublisherUuid(
+        std::string(header + headerSize, end - header - headerSize));
+    }
+    }
+  }
+}
+#endif
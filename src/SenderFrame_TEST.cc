@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "ignition/transport/MessageInfo.hh"
+
+#include "SenderFramePrivate.hh"
+
+using namespace ignition;
+using namespace transport;
+
+static const std::string kAddress = "tcp://127.0.0.1:1234";
+static const std::string kUuid = "c5fb1d5a-9bd1-4d5c-b1d5-3b7c1a3e5d42";
+
+//////////////////////////////////////////////////
+/// \brief Create a header with known values.
+MessageInfo testHeader()
+{
+  MessageInfo header;
+  header.SetPublicationTime(std::chrono::steady_clock::time_point(
+    std::chrono::seconds(12)));
+  header.SetSequenceNumber(34u);
+  header.SetDownsamplingPeriod(std::chrono::milliseconds(56));
+  return header;
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a version 1 header, as sent by older publishers.
+std::string version1Frame()
+{
+  std::string frame = kAddress;
+  frame.push_back('\0');
+  frame.push_back(kMsgHeaderVersion1);
+  char value[8];
+  writeUint64(value, 12000000000u);
+  frame.append(value, 8);
+  writeUint64(value, 34u);
+  frame.append(value, 8);
+  return frame + kUuid;
+}
+
+//////////////////////////////////////////////////
+/// \brief A single message is sent with a version 2 header.
+TEST(SenderFrameTest, SingleMessage)
+{
+  SenderFrame frame(kAddress, kUuid);
+  frame.Update(testHeader());
+  EXPECT_EQ(kAddress.size() + 1 + msgHeaderSize(kMsgHeaderVersion2) +
+    kUuid.size(), frame.Data().size());
+  EXPECT_EQ(kMsgHeaderVersion2, frame.Data()[kAddress.size() + 1]);
+
+  MessageInfo info;
+  uint64_t batchSize = 1u;
+  parseSenderFrame(frame.Data().data(), frame.Data().size(), info,
+    batchSize);
+  EXPECT_EQ(testHeader().PublicationTime(), info.PublicationTime());
+  EXPECT_EQ(34u, info.SequenceNumber());
+  EXPECT_EQ(std::chrono::milliseconds(56), info.DownsamplingPeriod());
+  EXPECT_EQ(kUuid, info.PublisherUuid());
+  EXPECT_EQ(0u, batchSize);
+
+  // The frame is reused for the next message.
+  MessageInfo next = testHeader();
+  next.SetSequenceNumber(35u);
+  frame.Update(next);
+  parseSenderFrame(frame.Data().data(), frame.Data().size(), info,
+    batchSize);
+  EXPECT_EQ(35u, info.SequenceNumber());
+  EXPECT_EQ(kUuid, info.PublisherUuid());
+}
+
+//////////////////////////////////////////////////
+/// \brief A batch is sent with a version 3 header.
+TEST(SenderFrameTest, Batch)
+{
+  SenderFrame frame(kAddress, kUuid, true);
+  frame.Update(testHeader(), 7u);
+  EXPECT_EQ(kMsgHeaderVersion3, frame.Data()[kAddress.size() + 1]);
+
+  MessageInfo info;
+  uint64_t batchSize = 0u;
+  parseSenderFrame(frame.Data().data(), frame.Data().size(), info,
+    batchSize);
+  EXPECT_EQ(34u, info.SequenceNumber());
+  EXPECT_EQ(std::chrono::milliseconds(56), info.DownsamplingPeriod());
+  EXPECT_EQ(kUuid, info.PublisherUuid());
+  EXPECT_EQ(7u, batchSize);
+}
+
+//////////////////////////////////////////////////
+/// \brief Version 1 headers are still understood.
+TEST(SenderFrameTest, Version1)
+{
+  const std::string frame = version1Frame();
+
+  MessageInfo info;
+  uint64_t batchSize = 1u;
+  parseSenderFrame(frame.data(), frame.size(), info, batchSize);
+  EXPECT_EQ(testHeader().PublicationTime(), info.PublicationTime());
+  EXPECT_EQ(34u, info.SequenceNumber());
+  EXPECT_EQ(std::chrono::nanoseconds(0), info.DownsamplingPeriod());
+  EXPECT_EQ(kUuid, info.PublisherUuid());
+  EXPECT_EQ(0u, batchSize);
+}
+
+//////////////////////////////////////////////////
+/// \brief Frames without a header, with an unknown version or truncated are
+/// ignored.
+TEST(SenderFrameTest, Ignored)
+{
+  std::string unknown = version1Frame();
+  unknown[kAddress.size() + 1] = 42;
+
+  std::string truncated = kAddress;
+  truncated.push_back('\0');
+  truncated.push_back(kMsgHeaderVersion2);
+  truncated.append(8, '\1');
+
+  for (const std::string &frame : {kAddress, unknown, truncated})
+  {
+    MessageInfo info;
+    uint64_t batchSize = 1u;
+    parseSenderFrame(frame.data(), frame.size(), info, batchSize);
+    EXPECT_EQ(0u, info.SequenceNumber());
+    EXPECT_TRUE(info.PublisherUuid().empty());
+    EXPECT_EQ(0u, batchSize);
+  }
+}
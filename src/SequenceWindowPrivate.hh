@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGN_TRANSPORT_SEQUENCEWINDOWPRIVATE_HH_
+#define IGN_TRANSPORT_SEQUENCEWINDOWPRIVATE_HH_
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+#include "ignition/transport/config.hh"
+
+namespace ignition
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_TRANSPORT_VERSION_NAMESPACE {
+    //
+    /// \brief Remembers the sequence numbers received recently from a
+    /// publisher, to discard the messages received twice. This happens with
+    /// the multicast topics, which are also sent through TCP and can reach a
+    /// subscriber through both.
+    class SequenceWindow
+    {
+      /// \brief Number of sequence numbers remembered, counting back from
+      /// the highest one received.
+      public: static const std::size_t kSize = 1024;
+
+      /// \brief Record a sequence number.
+      /// \param[in] _seq The sequence number.
+      /// \return False if it was already received, or if it is too old to
+      /// tell, in which case the message must be discarded.
+      public: bool Insert(const uint64_t _seq)
+      {
+        if (this->empty || _seq > this->highest)
+        {
+          const uint64_t shift = this->empty ? kSize : _seq - this->highest;
+          if (shift >= kSize)
+            this->seen.reset();
+          else
+            this->seen <<= static_cast<std::size_t>(shift);
+
+          this->seen.set(0);
+          this->highest = _seq;
+          this->empty = false;
+          return true;
+        }
+
+        const uint64_t age = this->highest - _seq;
+        if (age >= kSize || this->seen.test(static_cast<std::size_t>(age)))
+          return false;
+
+        this->seen.set(static_cast<std::size_t>(age));
+        return true;
+      }
+
+      /// \brief Whether no sequence number has been received yet.
+      private: bool empty = true;
+
+      /// \brief Highest sequence number received.
+      private: uint64_t highest = 0;
+
+      /// \brief Bit i is set if highest - i has been received.
+      private: std::bitset<kSize> seen;
+    };
+    }
+  }
+}
+#endif
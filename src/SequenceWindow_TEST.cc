@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gtest/gtest.h"
+
+#include "SequenceWindowPrivate.hh"
+
+using namespace ignition;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Every sequence number is accepted once, in any order.
+TEST(SequenceWindowTest, Duplicates)
+{
+  SequenceWindow window;
+  EXPECT_TRUE(window.Insert(5u));
+  EXPECT_FALSE(window.Insert(5u));
+
+  EXPECT_TRUE(window.Insert(7u));
+  EXPECT_TRUE(window.Insert(6u));
+  EXPECT_FALSE(window.Insert(6u));
+  EXPECT_FALSE(window.Insert(7u));
+
+  // A sequence number lower than the first one received is accepted while
+  // it fits in the window.
+  EXPECT_TRUE(window.Insert(1u));
+  EXPECT_FALSE(window.Insert(1u));
+}
+
+//////////////////////////////////////////////////
+/// \brief Sequence numbers older than the window are discarded.
+TEST(SequenceWindowTest, Window)
+{
+  SequenceWindow window;
+  EXPECT_TRUE(window.Insert(1u));
+  EXPECT_TRUE(window.Insert(SequenceWindow::kSize));
+  EXPECT_FALSE(window.Insert(1u));
+  EXPECT_FALSE(window.Insert(SequenceWindow::kSize));
+
+  EXPECT_TRUE(window.Insert(2u));
+  EXPECT_FALSE(window.Insert(2u));
+
+  // A jump larger than the window forgets everything before it.
+  EXPECT_TRUE(window.Insert(10u * SequenceWindow::kSize));
+  EXPECT_TRUE(window.Insert(10u * SequenceWindow::kSize - 1u));
+  EXPECT_FALSE(window.Insert(2u));
+}
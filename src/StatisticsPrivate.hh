@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGN_TRANSPORT_STATISTICSPRIVATE_HH_
+#define IGN_TRANSPORT_STATISTICSPRIVATE_HH_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "ignition/transport/config.hh"
+#include "ignition/transport/Helpers.hh"
+
+namespace ignition
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_TRANSPORT_VERSION_NAMESPACE {
+    //
+    /// \brief Topic where every process publishes its statistics when
+    /// IGN_TRANSPORT_STATS is set.
+    const char kStatisticsTopic[] = "/ign/transport/stats";
+
+    /// \brief Default period between two publications of the statistics.
+    const std::chrono::milliseconds kDefaultStatisticsPeriod{1000};
+
+    /// \brief Check whether the statistics are enabled. They are enabled
+    /// when the IGN_TRANSPORT_STATS environment variable is set to 1. The
+    /// variable is read once per process.
+    /// \return True if the statistics are enabled.
+    inline bool StatisticsEnabled()
+    {
+      static const bool enabled = []
+      {
+        std::string ignStats;
+        return env("IGN_TRANSPORT_STATS", ignStats) && ignStats == "1";
+      }();
+      return enabled;
+    }
+
+    /// \brief Get the period between two publications of the statistics,
+    /// read from the IGN_TRANSPORT_STATS_PERIOD environment variable
+    /// (milliseconds).
+    /// \return The period, or kDefaultStatisticsPeriod if the variable is
+    /// not set or is not valid.
+    inline std::chrono::milliseconds StatisticsPeriod()
+    {
+      std::string ignStatsPeriod;
+      if (!env("IGN_TRANSPORT_STATS_PERIOD", ignStatsPeriod))
+        return kDefaultStatisticsPeriod;
+
+      try
+      {
+        const int64_t period = std::stoll(ignStatsPeriod);
+        if (period > 0)
+          return std::chrono::milliseconds(period);
+      }
+      catch (...)
+      {
+      }
+
+      std::cerr << "Invalid IGN_TRANSPORT_STATS_PERIOD value ["
+                << ignStatsPeriod << "]. Using the default period of "
+                << kDefaultStatisticsPeriod.count() << " ms." << std::endl;
+      return kDefaultStatisticsPeriod;
+    }
+
+    /// \brief Counters of a publisher or a subscription handler.
+    ///
+    /// The counters are updated on the publication and reception paths, so
+    /// they are relaxed atomics: every endpoint has its own counters, which
+    /// are usually written by a single thread, and readers only need an
+    /// eventually consistent snapshot.
+    class EndpointCounters
+    {
+      /// \brief Count a message or a batch of messages.
+      /// \param[in] _bytes Size of the serialized messages.
+      /// \param[in] _count Number of messages.
+      public: void AddMessage(const std::size_t _bytes,
+                              const uint64_t _count = 1)
+      {
+        this->messages.fetch_add(_count, std::memory_order_relaxed);
+        this->bytes.fetch_add(_bytes, std::memory_order_relaxed);
+      }
+
+      /// \brief Count messages that were discarded, e.g. by throttling or
+      /// because they could not be sent.
+      /// \param[in] _count Number of messages.
+      public: void AddDrop(const uint64_t _count = 1)
+      {
+        this->drops.fetch_add(_count, std::memory_order_relaxed);
+      }
+
+      /// \brief Update the number of messages waiting in a queue.
+      /// \param[in] _delta Number of messages added (positive) or removed
+      /// (negative).
+      public: void AddQueued(const int64_t _delta)
+      {
+        this->queued.fetch_add(_delta, std::memory_order_relaxed);
+      }
+
+      /// \brief Accumulate the time spent in a callback.
+      /// \param[in] _elapsed Duration of the callback.
+      public: void AddCallbackTime(const std::chrono::nanoseconds &_elapsed)
+      {
+        const uint64_t ns = static_cast<uint64_t>(_elapsed.count());
+        this->callbackNs.fetch_add(ns, std::memory_order_relaxed);
+
+        uint64_t max = this->maxCallbackNs.load(std::memory_order_relaxed);
+        while (ns > max && !this->maxCallbackNs.compare_exchange_weak(
+                 max, ns, std::memory_order_relaxed))
+        {
+        }
+      }
+
+      /// \brief Number of messages.
+      public: std::atomic<uint64_t> messages{0};
+
+      /// \brief Number of serialized bytes.
+      public: std::atomic<uint64_t> bytes{0};
+
+      /// \brief Number of messages discarded.
+      public: std::atomic<uint64_t> drops{0};
+
+      /// \brief Number of messages waiting in a queue.
+      public: std::atomic<int64_t> queued{0};
+
+      /// \brief Accumulated time spent in callbacks (ns).
+      public: std::atomic<uint64_t> callbackNs{0};
+
+      /// \brief Longest callback (ns).
+      public: std::atomic<uint64_t> maxCallbackNs{0};
+
+      /// \brief Number of messages at the previous publication of the
+      /// statistics. Only used by the statistics thread.
+      public: uint64_t lastMessages = 0;
+
+      /// \brief Number of bytes at the previous publication of the
+      /// statistics. Only used by the statistics thread.
+      public: uint64_t lastBytes = 0;
+    };
+
+    /// \brief Measures the duration of a callback and records it, together
+    /// with the message, on destruction. It does nothing if the counters are
+    /// null, which is the case when the statistics are disabled.
+    class CallbackTimer
+    {
+      /// \brief Constructor.
+      /// \param[in] _counters Counters to update, or nullptr.
+      /// \param[in] _bytes Size of the serialized messages.
+      /// \param[in] _count Number of messages passed to the callback.
+      public: CallbackTimer(EndpointCounters *_counters,
+                            const std::size_t _bytes,
+                            const uint64_t _count = 1)
+        : counters(_counters),
+          bytes(_bytes),
+          count(_count)
+      {
+        if (this->counters)
+          this->start = std::chrono::steady_clock::now();
+      }
+
+      /// \brief Destructor.
+      public: ~CallbackTimer()
+      {
+        if (!this->counters)
+          return;
+
+        this->counters->AddMessage(this->bytes, this->count);
+        this->counters->AddCallbackTime(
+          std::chrono::steady_clock::now() - this->start);
+      }
+
+      /// \brief Counters to update.
+      private: EndpointCounters *counters;
+
+      /// \brief Size of the serialized messages.
+      private: std::size_t bytes;
+
+      /// \brief Number of messages.
+      private: uint64_t count;
+
+      /// \brief Time at which the callback started.
+      private: std::chrono::steady_clock::time_point start;
+    };
+    }
+  }
+}
+#endif
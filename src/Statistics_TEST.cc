@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <ignition/msgs.hh>
+
+#include "gtest/gtest.h"
+#include "ignition/transport/MessageInfo.hh"
+#include "ignition/transport/Node.hh"
+#include "ignition/transport/SubscriptionHandler.hh"
+#include "ignition/transport/test_config.h"
+
+#include "StatisticsPrivate.hh"
+
+using namespace ignition;
+
+static std::string partition; // NOLINT(*)
+static const std::string g_topic = "/foo"; // NOLINT(*)
+
+//////////////////////////////////////////////////
+/// \brief Get a numeric value of a statistics entry.
+double value(const msgs::Param &_param, const std::string &_key)
+{
+  auto it = _param.params().find(_key);
+  return it == _param.params().end() ? -1.0 : it->second.double_value();
+}
+
+//////////////////////////////////////////////////
+/// \brief Get a string value of a statistics entry.
+std::string text(const msgs::Param &_param, const std::string &_key)
+{
+  auto it = _param.params().find(_key);
+  return it == _param.params().end() ? "" : it->second.string_value();
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the counters updated on the publication and reception paths.
+TEST(StatisticsTest, EndpointCounters)
+{
+  transport::EndpointCounters counters;
+  counters.AddMessage(10);
+  counters.AddMessage(20);
+  counters.AddDrop();
+  counters.AddQueued(2);
+  counters.AddQueued(-1);
+  counters.AddCallbackTime(std::chrono::nanoseconds(30));
+  counters.AddCallbackTime(std::chrono::nanoseconds(10));
+
+  EXPECT_EQ(2u, counters.messages.load());
+  EXPECT_EQ(30u, counters.bytes.load());
+  EXPECT_EQ(1u, counters.drops.load());
+  EXPECT_EQ(1, counters.queued.load());
+  EXPECT_EQ(40u, counters.callbackNs.load());
+  EXPECT_EQ(30u, counters.maxCallbackNs.load());
+
+  {
+    transport::CallbackTimer timer(&counters, 5);
+  }
+  EXPECT_EQ(3u, counters.messages.load());
+  EXPECT_EQ(35u, counters.bytes.load());
+
+  // A null timer does nothing.
+  transport::CallbackTimer timer(nullptr, 5);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the period read from IGN_TRANSPORT_STATS_PERIOD.
+TEST(StatisticsTest, Period)
+{
+  setenv("IGN_TRANSPORT_STATS_PERIOD", "250", 1);
+  EXPECT_EQ(std::chrono::milliseconds(250), transport::StatisticsPeriod());
+
+  setenv("IGN_TRANSPORT_STATS_PERIOD", "-3", 1);
+  EXPECT_EQ(transport::kDefaultStatisticsPeriod,
+            transport::StatisticsPeriod());
+
+  setenv("IGN_TRANSPORT_STATS_PERIOD", "fast", 1);
+  EXPECT_EQ(transport::kDefaultStatisticsPeriod,
+            transport::StatisticsPeriod());
+
+  setenv("IGN_TRANSPORT_STATS_PERIOD", "100", 1);
+  EXPECT_TRUE(transport::StatisticsEnabled());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the handlers only count the messages passed to the
+/// user callback, and not the ones skipped by the filter or the throttling.
+TEST(StatisticsTest, HandlerCountsDeliveredMessages)
+{
+  msgs::Int32 msg;
+  transport::MessageInfo info;
+  info.SetSize(2);
+  int counter = 0;
+
+  transport::SubscribeOptions opts;
+  opts.SetFilter("data == 1");
+  transport::SubscriptionHandler<msgs::Int32> filtered("nUuid", opts);
+  filtered.SetCallback(
+    [&counter](const msgs::Int32 &, const transport::MessageInfo &)
+    {
+      ++counter;
+    });
+  ASSERT_NE(nullptr, filtered.Counters());
+
+  msg.set_data(2);
+  EXPECT_TRUE(filtered.RunLocalCallback(msg, info));
+  msg.set_data(1);
+  EXPECT_TRUE(filtered.RunLocalCallback(msg, info));
+  EXPECT_EQ(1, counter);
+  EXPECT_EQ(1u, filtered.Counters()->messages.load());
+  EXPECT_EQ(2u, filtered.Counters()->bytes.load());
+
+  transport::SubscribeOptions throttledOpts;
+  throttledOpts.SetMsgsPerSec(1u);
+  transport::RawSubscriptionHandler throttled(
+    "nUuid", msg.GetTypeName(), throttledOpts);
+  throttled.SetCallback(
+    [&counter](const char *, const size_t, const transport::MessageInfo &)
+    {
+      ++counter;
+    });
+  ASSERT_NE(nullptr, throttled.Counters());
+
+  const std::string data = msg.SerializeAsString();
+  EXPECT_TRUE(throttled.RunRawCallback(data.data(), data.size(), info));
+  EXPECT_TRUE(throttled.RunRawCallback(data.data(), data.size(), info));
+  EXPECT_EQ(2, counter);
+  EXPECT_EQ(1u, throttled.Counters()->messages.load());
+  EXPECT_EQ(1u, throttled.Counters()->drops.load());
+}
+
+//////////////////////////////////////////////////
+/// \brief Publish messages to a typed and a raw subscriber and check that
+/// the statistics published on the statistics topic account for them.
+TEST(StatisticsTest, PublishedStatistics)
+{
+  const int kNumMsgs = 10;
+  msgs::Int32 msg;
+  msg.set_data(5);
+
+  transport::Node node;
+  auto pub = node.Advertise<msgs::Int32>(g_topic);
+  ASSERT_TRUE(pub);
+
+  std::function<void(const msgs::Int32 &)> cb = [](const msgs::Int32 &)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  };
+  ASSERT_TRUE(node.Subscribe(g_topic, cb));
+
+  std::function<void(const char *, const size_t,
+                     const transport::MessageInfo &)> rawCb =
+    [](const char *, const size_t, const transport::MessageInfo &)
+    {
+    };
+  ASSERT_TRUE(node.SubscribeRaw(g_topic, rawCb, msg.GetTypeName()));
+
+  for (int i = 0; i < kNumMsgs; ++i)
+    EXPECT_TRUE(pub.Publish(msg));
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::map<std::string, msgs::Param> stats;
+  std::function<void(const msgs::Param_V &)> statsCb =
+    [&](const msgs::Param_V &_msg)
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      for (const auto &param : _msg.param())
+      {
+        if (text(param, "topic") == g_topic &&
+            value(param, "messages") == kNumMsgs)
+        {
+          stats[text(param, "role")] = param;
+        }
+      }
+      condition.notify_all();
+    };
+  ASSERT_TRUE(node.Subscribe(transport::kStatisticsTopic, statsCb));
+
+  std::unique_lock<std::mutex> lk(mutex);
+  EXPECT_TRUE(condition.wait_for(lk, std::chrono::seconds(5),
+    [&]{return stats.size() == 3u;}));
+
+  ASSERT_EQ(1u, stats.count("publisher"));
+  const msgs::Param &pubStats = stats["publisher"];
+  EXPECT_EQ("/" + partition, text(pubStats, "partition"));
+  EXPECT_EQ(msg.GetTypeName(), text(pubStats, "type"));
+  EXPECT_DOUBLE_EQ(kNumMsgs * msg.ByteSizeLong(), value(pubStats, "bytes"));
+  EXPECT_DOUBLE_EQ(0.0, value(pubStats, "drops"));
+  EXPECT_DOUBLE_EQ(0.0, value(pubStats, "queue_depth"));
+
+  ASSERT_EQ(1u, stats.count("subscriber"));
+  const msgs::Param &subStats = stats["subscriber"];
+  EXPECT_DOUBLE_EQ(kNumMsgs * msg.ByteSizeLong(), value(subStats, "bytes"));
+  EXPECT_GE(value(subStats, "callback_time_ns"), kNumMsgs * 1e6);
+  EXPECT_GE(value(subStats, "max_callback_time_ns"), 1e6);
+
+  ASSERT_EQ(1u, stats.count("raw_subscriber"));
+  EXPECT_DOUBLE_EQ(kNumMsgs * msg.ByteSizeLong(),
+    value(stats["raw_subscriber"], "bytes"));
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  // Get a random partition name.
+  partition = testing::getRandomNumber();
+
+  // Set the partition name for this process.
+  setenv("IGN_PARTITION", partition.c_str(), 1);
+
+  // Enable the statistics. This must happen before creating any node.
+  setenv("IGN_TRANSPORT_STATS", "1", 1);
+  setenv("IGN_TRANSPORT_STATS_PERIOD", "100", 1);
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,7 @@
 */
 
 #include <cstdint>
+#include <string>
 
 #include "ignition/transport/Helpers.hh"
 #include "ignition/transport/SubscribeOptions.hh"
@@ -36,6 +37,8 @@ SubscribeOptions::SubscribeOptions(const SubscribeOptions &_otherSubscribeOpts)
   : dataPtr(new SubscribeOptionsPrivate())
 {
   this->SetMsgsPerSec(_otherSubscribeOpts.MsgsPerSec());
+  this->SetFilter(_otherSubscribeOpts.Filter());
+  this->SetHeapMessages(_otherSubscribeOpts.HeapMessages());
 }
 
 //////////////////////////////////////////////////
@@ -60,3 +63,27 @@ void SubscribeOptions::SetMsgsPerSec(const uint64_t _newMsgsPerSec)
 {
   this->dataPtr->msgsPerSec = _newMsgsPerSec;
 }
+
+//////////////////////////////////////////////////
+void SubscribeOptions::SetFilter(const std::string &_filter)
+{
+  this->dataPtr->filter = _filter;
+}
+
+//////////////////////////////////////////////////
+const std::string &SubscribeOptions::Filter() const
+{
+  return this->dataPtr->filter;
+}
+
+//////////////////////////////////////////////////
+void SubscribeOptions::SetHeapMessages(const bool _heap)
+{
+  this->dataPtr->heapMessages = _heap;
+}
+
+//////////////////////////////////////////////////
+bool SubscribeOptions::HeapMessages() const
+{
+  return this->dataPtr->heapMessages;
+}
@@ -19,6 +19,7 @@
 #define IGN_TRANSPORT_SUBSCRIBEOPTIONSPRIVATE_HH_
 
 #include <cstdint>
+#include <string>
 
 #include "ignition/transport/Helpers.hh"
 
@@ -41,6 +42,12 @@ namespace ignition
 
       /// \brief Default message subscription rate.
       public: uint64_t msgsPerSec = kUnthrottled;
+
+      /// \brief Filter on the content of the messages.
+      public: std::string filter;
+
+      /// \brief Whether the messages are allocated on the heap.
+      public: bool heapMessages = false;
     };
     }
   }
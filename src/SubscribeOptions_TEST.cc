@@ -29,9 +29,13 @@ TEST(SubscribeOptionsTest, copyConstructor)
 {
   SubscribeOptions opts1;
   opts1.SetMsgsPerSec(2u);
+  opts1.SetFilter("data > 3");
+  opts1.SetHeapMessages(true);
   EXPECT_EQ(opts1.MsgsPerSec(), 2u);
   SubscribeOptions opts2(opts1);
   EXPECT_EQ(opts2.MsgsPerSec(), opts1.MsgsPerSec());
+  EXPECT_EQ(opts2.Filter(), opts1.Filter());
+  EXPECT_TRUE(opts2.HeapMessages());
 }
 
 //////////////////////////////////////////////////
@@ -43,6 +47,16 @@ TEST(SubscribeOptionsTest, accessors)
   EXPECT_EQ(opts.MsgsPerSec(), kUnthrottled);
   opts.SetMsgsPerSec(3u);
   EXPECT_EQ(opts.MsgsPerSec(), 3u);
+
+  // Filter.
+  EXPECT_TRUE(opts.Filter().empty());
+  opts.SetFilter("data > 3");
+  EXPECT_EQ(opts.Filter(), "data > 3");
+
+  // HeapMessages.
+  EXPECT_FALSE(opts.HeapMessages());
+  opts.SetHeapMessages(true);
+  EXPECT_TRUE(opts.HeapMessages());
 }
 
 //////////////////////////////////////////////////
@@ -17,6 +17,8 @@
 
 #include "ignition/transport/SubscriptionHandler.hh"
 
+#include "StatisticsPrivate.hh"
+
 namespace ignition
 {
   namespace transport
@@ -28,6 +30,7 @@ namespace ignition
         const std::string &_nUuid,
         const SubscribeOptions &_opts)
       : opts(_opts),
+        filter(_opts.Filter()),
         periodNs(0.0),
         hUuid(Uuid().ToString()),
         lastCbTimestamp(std::chrono::seconds{0}),
@@ -35,6 +38,29 @@ namespace ignition
     {
       if (this->opts.Throttled())
         this->periodNs = 1e9 / this->opts.MsgsPerSec();
+
+      if (StatisticsEnabled())
+        this->counters = std::make_shared<EndpointCounters>();
+    }
+
+    /////////////////////////////////////////////////
+    NameId SubscriptionHandlerBase::TypeId() const
+    {
+      return this->typeId;
+    }
+
+    /////////////////////////////////////////////////
+    bool SubscriptionHandlerBase::AcceptsType(const NameId _typeId,
+                                              const std::string &_typeName)
+    {
+      if (this->typeId == kGenericMessageTypeId)
+        return true;
+
+      if (this->typeId != kNoNameId && _typeId != kNoNameId)
+        return this->typeId == _typeId;
+
+      const std::string typeName = this->TypeName();
+      return typeName == kGenericMessageType || typeName == _typeName;
     }
 
     /////////////////////////////////////////////////
@@ -50,19 +76,50 @@ namespace ignition
     }
 
     /////////////////////////////////////////////////
-    bool SubscriptionHandlerBase::UpdateThrottling()
+    EndpointCounters *SubscriptionHandlerBase::Counters() const
     {
-      if (!this->opts.Throttled())
-        return true;
+      return this->counters.get();
+    }
 
-      Timestamp now = std::chrono::steady_clock::now();
+    /////////////////////////////////////////////////
+    const SubscribeOptions &SubscriptionHandlerBase::Options() const
+    {
+      return this->opts;
+    }
+
+    /////////////////////////////////////////////////
+    const MessageFilter &SubscriptionHandlerBase::Filter() const
+    {
+      return this->filter;
+    }
 
+    /////////////////////////////////////////////////
+    bool SubscriptionHandlerBase::ThrottlingAllows(const Timestamp &_now,
+        const MessageInfo &_info) const
+    {
       // Elapsed time since the last callback execution.
-      auto elapsed = now - this->lastCbTimestamp;
+      auto elapsed = _now - this->lastCbTimestamp;
+
+      // The publisher sends a message about every downsampling period, so a
+      // message that arrives a bit early is still the one for this period.
+      const double toleranceNs =
+        static_cast<double>(_info.DownsamplingPeriod().count()) / 2.0;
+
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        elapsed).count() >= this->periodNs - toleranceNs;
+    }
+
+    /////////////////////////////////////////////////
+    bool SubscriptionHandlerBase::UpdateThrottling(const MessageInfo &_info)
+    {
+      if (!this->opts.Throttled())
+        return true;
 
-      if (std::chrono::duration_cast<std::chrono::nanoseconds>(
-            elapsed).count() < this->periodNs)
+      Timestamp now = std::chrono::steady_clock::now();
+      if (!this->ThrottlingAllows(now, _info))
       {
+        if (this->counters)
+          this->counters->AddDrop();
         return false;
       }
 
@@ -71,6 +128,39 @@ namespace ignition
       return true;
     }
 
+    /////////////////////////////////////////////////
+    std::size_t SubscriptionHandlerBase::SerializedSize(const ProtoMsg &_msg)
+    {
+#if GOOGLE_PROTOBUF_VERSION < 3001000
+      return static_cast<std::size_t>(_msg.ByteSize());
+#else
+      return static_cast<std::size_t>(_msg.ByteSizeLong());
+#endif
+    }
+
+    /////////////////////////////////////////////////
+    void SubscriptionHandlerBase::CountCallback(const std::size_t _bytes,
+        const uint64_t _count, const std::chrono::nanoseconds &_elapsed)
+    {
+      this->counters->AddMessage(_bytes, _count);
+      this->counters->AddCallbackTime(_elapsed);
+    }
+
+    /////////////////////////////////////////////////
+    bool SubscriptionHandlerBase::DropIfThrottled(const MessageInfo &_info,
+                                                  const uint64_t _count)
+    {
+      if (!this->opts.Throttled() || !this->filter.Empty())
+        return false;
+
+      if (this->ThrottlingAllows(std::chrono::steady_clock::now(), _info))
+        return false;
+
+      if (this->counters)
+        this->counters->AddDrop(_count);
+      return true;
+    }
+
     /////////////////////////////////////////////////
     ISubscriptionHandler::ISubscriptionHandler(
         const std::string &_nUuid,
@@ -80,6 +170,26 @@ namespace ignition
       // Do nothing
     }
 
+    /////////////////////////////////////////////////
+    bool ISubscriptionHandler::RunLocalBatchCallback(
+        const std::vector<std::pair<const ProtoMsg *, uint64_t>> &_msgs,
+        const MessageInfo &_info)
+    {
+      MessageInfo info(_info);
+      bool result = true;
+      for (const auto &msg : _msgs)
+      {
+        info.SetSequenceNumber(msg.second);
+
+        // The size of the batch would be counted for every message.
+        if (this->Counters())
+          info.SetSize(SerializedSize(*msg.first));
+
+        result = this->RunLocalCallback(*msg.first, info) && result;
+      }
+      return result;
+    }
+
     /////////////////////////////////////////////////
     class RawSubscriptionHandler::Implementation
     {
@@ -102,7 +212,7 @@ namespace ignition
       : SubscriptionHandlerBase(_nUuid, _opts),
         pimpl(new Implementation(_msgType))
     {
-      // Do nothing
+      this->typeId = NameTable::Intern(_msgType);
     }
 
     /////////////////////////////////////////////////
@@ -131,10 +241,11 @@ namespace ignition
       }
 
       // Check if we need to throttle
-      if (!this->UpdateThrottling())
+      if (!this->UpdateThrottling(_info))
         return true;
 
       // Trigger the callback
+      CallbackTimer timer(this->Counters(), _size);
       this->pimpl->callback(_msgData, _size, _info);
       return true;
     }
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <ignition/msgs/int32.pb.h>
+#include <ignition/msgs/vector3d.pb.h>
+#include <google/protobuf/arena.h>
+
+#include <string>
+
+#include "ignition/transport/MessageInfo.hh"
+#include "ignition/transport/SubscribeOptions.hh"
+#include "ignition/transport/SubscriptionHandler.hh"
+#include "gtest/gtest.h"
+
+using namespace ignition;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Check that DropIfThrottled() drops the messages that the
+/// throttling would discard, without updating the throttling.
+TEST(SubscriptionHandlerTest, DropIfThrottled)
+{
+  MessageInfo info;
+  msgs::Int32 msg;
+  int counter = 0;
+
+  SubscriptionHandler<msgs::Int32> notThrottled("nUuid");
+  EXPECT_FALSE(notThrottled.DropIfThrottled(info));
+
+  SubscribeOptions opts;
+  opts.SetMsgsPerSec(1u);
+  SubscriptionHandler<msgs::Int32> throttled("nUuid", opts);
+  throttled.SetCallback(
+    [&counter](const msgs::Int32 &, const MessageInfo &) {++counter;});
+
+  // The first message goes through, and DropIfThrottled() does not update
+  // the throttling.
+  EXPECT_FALSE(throttled.DropIfThrottled(info));
+  EXPECT_FALSE(throttled.DropIfThrottled(info));
+  EXPECT_TRUE(throttled.RunLocalCallback(msg, info));
+  EXPECT_EQ(1, counter);
+
+  // The next message arrives too early.
+  EXPECT_TRUE(throttled.DropIfThrottled(info));
+  EXPECT_TRUE(throttled.RunLocalCallback(msg, info));
+  EXPECT_EQ(1, counter);
+
+  // The handlers with a filter need the message to decide.
+  opts.SetFilter("data > 0");
+  SubscriptionHandler<msgs::Int32> filtered("nUuid", opts);
+  filtered.SetCallback(
+    [&counter](const msgs::Int32 &, const MessageInfo &) {++counter;});
+  msg.set_data(1);
+  EXPECT_TRUE(filtered.RunLocalCallback(msg, info));
+  EXPECT_EQ(2, counter);
+  EXPECT_FALSE(filtered.DropIfThrottled(info));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that a generic handler creates messages of several types.
+TEST(SubscriptionHandlerTest, GenericCreateMsg)
+{
+  msgs::Int32 int32;
+  int32.set_data(5);
+  msgs::Vector3d vector;
+  vector.set_x(2.0);
+
+  std::string int32Data;
+  std::string vectorData;
+  ASSERT_TRUE(int32.SerializeToString(&int32Data));
+  ASSERT_TRUE(vector.SerializeToString(&vectorData));
+
+  SubscriptionHandler<ProtoMsg> handler("nUuid");
+  for (int i = 0; i < 2; ++i)
+  {
+    auto msg = handler.CreateMsg(int32Data, int32.GetTypeName());
+    ASSERT_NE(nullptr, msg);
+    EXPECT_EQ(int32.GetTypeName(), msg->GetTypeName());
+    EXPECT_EQ(5, static_cast<msgs::Int32 *>(msg.get())->data());
+
+    msg = handler.CreateMsg(vectorData, vector.GetTypeName());
+    ASSERT_NE(nullptr, msg);
+    EXPECT_EQ(vector.GetTypeName(), msg->GetTypeName());
+    EXPECT_DOUBLE_EQ(2.0, static_cast<msgs::Vector3d *>(msg.get())->x());
+  }
+
+  EXPECT_EQ(nullptr, handler.CreateMsg(int32Data, "unknown.Type"));
+  EXPECT_NE(nullptr, handler.CreateMsg(int32Data, int32.GetTypeName()));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the handlers create the messages in an arena.
+TEST(SubscriptionHandlerTest, ArenaCreateMsg)
+{
+  msgs::Int32 int32;
+  int32.set_data(7);
+  std::string data;
+  ASSERT_TRUE(int32.SerializeToString(&data));
+
+  google::protobuf::Arena arena;
+  SubscriptionHandler<msgs::Int32> typed("nUuid");
+  SubscriptionHandler<ProtoMsg> generic("nUuid");
+  for (const ISubscriptionHandler *handler :
+       {static_cast<const ISubscriptionHandler *>(&typed),
+        static_cast<const ISubscriptionHandler *>(&generic)})
+  {
+    auto msg = handler->CreateMsg(data.data(), data.size(),
+      int32.GetTypeName(), &arena);
+    ASSERT_NE(nullptr, msg);
+    EXPECT_EQ(&arena, msg->GetArena());
+    EXPECT_EQ(7, static_cast<msgs::Int32 *>(msg.get())->data());
+
+    msg = handler->CreateMsg(data.data(), data.size(), int32.GetTypeName(),
+      nullptr);
+    ASSERT_NE(nullptr, msg);
+    EXPECT_EQ(nullptr, msg->GetArena());
+    EXPECT_EQ(7, static_cast<msgs::Int32 *>(msg.get())->data());
+  }
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGN_TRANSPORT_THREADCONFIGPRIVATE_HH_
+#define IGN_TRANSPORT_THREADCONFIGPRIVATE_HH_
+
+#ifndef _WIN32
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include "ignition/transport/config.hh"
+#include "ignition/transport/Helpers.hh"
+
+namespace ignition
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_TRANSPORT_VERSION_NAMESPACE {
+    //
+    /// \brief Scheduling policy of a thread.
+    struct ThreadSchedule
+    {
+      /// \brief Name of the policy: other, batch, idle, fifo or rr.
+      std::string policy;
+
+      /// \brief Static priority. Only used by the fifo and rr policies.
+      int priority = 0;
+    };
+
+    //////////////////////////////////////////////////
+    /// \brief Get the prefix of the environment variables that configure the
+    /// threads with a given role, e.g. IGN_TRANSPORT_RECEPTION.
+    /// \param[in] _role Role of the threads, e.g. "reception".
+    /// \return The prefix.
+    inline std::string threadEnvPrefix(const std::string &_role)
+    {
+      std::string prefix = "IGN_TRANSPORT_" + _role;
+      std::transform(prefix.begin(), prefix.end(), prefix.begin(),
+        [](unsigned char _c) {return static_cast<char>(std::toupper(_c));});
+      return prefix;
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Parse a list of CPUs, e.g. "0,2-3".
+    /// \param[in] _list The list.
+    /// \param[out] _cpus The CPUs of the list.
+    /// \return False if the list is malformed or empty.
+    inline bool parseCpuList(const std::string &_list, std::vector<int> &_cpus)
+    {
+      auto toCpu = [](const std::string &_str, int &_cpu)
+      {
+        if (_str.empty() || _str.size() > 4 ||
+            !std::all_of(_str.begin(), _str.end(),
+              [](unsigned char _c) {return std::isdigit(_c);}))
+        {
+          return false;
+        }
+        _cpu = std::stoi(_str);
+        return true;
+      };
+
+      _cpus.clear();
+      for (const auto &range : split(_list, ','))
+      {
+        const auto dash = range.find('-');
+        int first = 0;
+        int last = 0;
+        if (dash == std::string::npos)
+        {
+          if (!toCpu(range, first))
+            return false;
+          last = first;
+        }
+        else if (!toCpu(range.substr(0, dash), first) ||
+                 !toCpu(range.substr(dash + 1), last) || last < first)
+        {
+          return false;
+        }
+
+        for (int cpu = first; cpu <= last; ++cpu)
+          _cpus.push_back(cpu);
+      }
+      return !_cpus.empty();
+    }
+
+    //////////////////////////////////////////////////
+    /// \brief Parse a scheduling policy, e.g. "fifo:50" or "batch". The
+    /// fifo and rr policies require a priority between 1 and 99, the others
+    /// do not accept one.
+    /// \param[in] _spec The policy.
+    /// \param[out] _schedule The parsed policy.
+    /// \return False if the policy is not valid.
+    inline bool parseSchedule(const std::string &_spec,
+                              ThreadSchedule &_schedule)
+    {
+      const auto colon = _spec.find(':');
+      _schedule.policy = _spec.substr(0, colon);
+      _schedule.priority = 0;
+
+      const bool realTime =
+        _schedule.policy == "fifo" || _schedule.policy == "rr";
+      if (!realTime)
+      {
+        return colon == std::string::npos &&
+          (_schedule.policy == "other" || _schedule.policy == "batch" ||
+           _schedule.policy == "idle");
+      }
+
+      const std::string priority =
+        colon == std::string::npos ? "" : _spec.substr(colon + 1);
+      if (priority.empty() || priority.size() > 2 ||
+          !std::all_of(priority.begin(), priority.end(),
+            [](unsigned char _c) {return std::isdigit(_c);}))
+      {
+        return false;
+      }
+      _schedule.priority = std::stoi(priority);
+      return _schedule.priority >= 1;
+    }
+
+#ifndef _WIN32
+    //////////////////////////////////////////////////
+    /// \brief Get the POSIX constant of a scheduling policy.
+    /// \param[in] _schedule The policy, as returned by parseSchedule().
+    /// \return The constant, e.g. SCHED_FIFO, or -1 if the policy is not
+    /// available on this platform.
+    inline int schedPolicy(const ThreadSchedule &_schedule)
+    {
+      if (_schedule.policy == "fifo")
+        return SCHED_FIFO;
+      if (_schedule.policy == "rr")
+        return SCHED_RR;
+      if (_schedule.policy == "other")
+        return SCHED_OTHER;
+#ifdef SCHED_BATCH
+      if (_schedule.policy == "batch")
+        return SCHED_BATCH;
+#endif
+#ifdef SCHED_IDLE
+      if (_schedule.policy == "idle")
+        return SCHED_IDLE;
+#endif
+      return -1;
+    }
+#endif
+    }
+  }
+}
+#endif
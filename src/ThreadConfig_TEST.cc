@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ignition/transport/Helpers.hh"
+
+#include "ThreadConfigPrivate.hh"
+
+using namespace ignition;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Check the prefix of the environment variables.
+TEST(ThreadConfigTest, EnvPrefix)
+{
+  EXPECT_EQ("IGN_TRANSPORT_RECEPTION", threadEnvPrefix("reception"));
+  EXPECT_EQ("IGN_TRANSPORT_IO", threadEnvPrefix("io"));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the lists of CPUs.
+TEST(ThreadConfigTest, CpuList)
+{
+  std::vector<int> cpus;
+  EXPECT_TRUE(parseCpuList("3", cpus));
+  EXPECT_EQ(std::vector<int>({3}), cpus);
+
+  EXPECT_TRUE(parseCpuList("0,2-4,7", cpus));
+  EXPECT_EQ(std::vector<int>({0, 2, 3, 4, 7}), cpus);
+
+  for (const char *list : {"", ",", "a", "1,", "-1", "3-1", "1-", "1-2-3",
+         "99999"})
+  {
+    EXPECT_FALSE(parseCpuList(list, cpus)) << list;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the scheduling policies.
+TEST(ThreadConfigTest, Schedule)
+{
+  ThreadSchedule schedule;
+  EXPECT_TRUE(parseSchedule("fifo:50", schedule));
+  EXPECT_EQ("fifo", schedule.policy);
+  EXPECT_EQ(50, schedule.priority);
+
+  EXPECT_TRUE(parseSchedule("rr:1", schedule));
+  EXPECT_EQ("rr", schedule.policy);
+  EXPECT_EQ(1, schedule.priority);
+
+  EXPECT_TRUE(parseSchedule("batch", schedule));
+  EXPECT_EQ("batch", schedule.policy);
+  EXPECT_EQ(0, schedule.priority);
+
+  for (const char *spec : {"", "fifo", "fifo:", "fifo:0", "fifo:100",
+         "rr:x", "other:3", "realtime"})
+  {
+    EXPECT_FALSE(parseSchedule(spec, schedule)) << spec;
+  }
+
+#ifndef _WIN32
+  EXPECT_TRUE(parseSchedule("other", schedule));
+  EXPECT_EQ(SCHED_OTHER, schedPolicy(schedule));
+#endif
+}
+
+#ifdef __linux__
+//////////////////////////////////////////////////
+/// \brief The internal threads are named after their role.
+TEST(ThreadConfigTest, Name)
+{
+  std::string name;
+  std::thread thread([&name]
+  {
+    configureThread("reception");
+    char buffer[16];
+    if (pthread_getname_np(pthread_self(), buffer, sizeof(buffer)) == 0)
+      name = buffer;
+  });
+  thread.join();
+  EXPECT_EQ("ign-reception", name);
+}
+#endif
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,9 +16,17 @@
 */
 
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
 #include <functional>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifdef _MSC_VER
@@ -34,6 +42,8 @@
 #include "ignition/transport/Helpers.hh"
 #include "ignition/transport/Node.hh"
 
+#include "StatisticsPrivate.hh"
+
 #ifdef _MSC_VER
 # pragma warning(disable: 4503)
 #endif
@@ -41,6 +51,12 @@
 using namespace ignition;
 using namespace transport;
 
+/// \brief Time given to a remote subscriber for its subscription to reach
+/// the publisher socket. A subscriber announces itself through a control
+/// message that may arrive before its subscription, and the publisher socket
+/// drops the messages until then.
+const std::chrono::milliseconds kSubscriptionSettleTime{100};
+
 //////////////////////////////////////////////////
 extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicList()
 {
@@ -168,9 +184,11 @@ extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicPub(const char *_topic,
     // Publish the message
     if (pub)
     {
-      // \todo(anyone) Change this sleep to a WaitForSubscribers() call.
-      // See issue #47.
-      std::this_thread::sleep_for(std::chrono::milliseconds(800));
+      // Publish as soon as somebody listens, or after 800 ms anyway. The
+      // wait returns when the subscriber announces itself, so leave time
+      // for its subscription to arrive too.
+      if (pub.WaitForSubscribers(1, 800))
+        std::this_thread::sleep_for(kSubscriptionSettleTime);
       pub.Publish(*msg);
     }
     else
@@ -250,14 +268,78 @@ extern "C" void IGNITION_TRANSPORT_VISIBLE cmdServiceReq(const char *_service,
 }
 
 //////////////////////////////////////////////////
-extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicEcho(const char *_topic,
-  const double _duration, int _count)
+// Helper to block an echo command until _duration seconds have passed,
+// until _count messages have been received or, if both are <= 0, until
+// the process is interrupted. _received is protected by _mutex and
+// _condition is notified every time it changes.
+void waitForEcho(const double _duration, const int _count,
+  std::mutex &_mutex, std::condition_variable &_condition,
+  const int &_received)
+{
+  if (_duration >= 0)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(
+      static_cast<int64_t>(_duration * 1000)));
+    return;
+  }
+
+  // Wait forever if _count <= 0. Otherwise wait for a specific number of
+  // messages.
+  if (_count <= 0)
+  {
+    ignition::transport::waitForShutdown();
+  }
+  else
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [&]{return _received >= _count;});
+  }
+}
+
+//////////////////////////////////////////////////
+// Helper to check the topic passed to an echo command.
+bool validEchoTopic(const char *_topic)
 {
   if (!_topic || std::string(_topic).empty())
   {
     std::cerr << "Invalid topic. Topic must not be empty.\n";
-    return;
+    return false;
   }
+  return true;
+}
+
+//////////////////////////////////////////////////
+// Helper to deserialize a message of any type known by this process.
+std::unique_ptr<ProtoMsg> createMsg(const char *_data, const size_t _size,
+  const std::string &_type)
+{
+  std::unique_ptr<ProtoMsg> msg;
+
+  const google::protobuf::Descriptor *desc =
+    google::protobuf::DescriptorPool::generated_pool()
+      ->FindMessageTypeByName(_type);
+  if (desc)
+  {
+    msg.reset(google::protobuf::MessageFactory::generated_factory()
+      ->GetPrototype(desc)->New());
+  }
+  else
+  {
+    msg = ignition::msgs::Factory::New(_type);
+  }
+
+  if (!msg || !msg->ParseFromArray(_data, static_cast<int>(_size)))
+    return nullptr;
+
+  return msg;
+}
+
+//////////////////////////////////////////////////
+extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicEcho(const char *_topic,
+  const double _duration, int _count)
+{
+  if (!validEchoTopic(_topic))
+    return;
 
   std::mutex mutex;
   std::condition_variable condition;
@@ -275,27 +357,299 @@ extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicEcho(const char *_topic,
   if (!node.Subscribe(_topic, cb))
     return;
 
-  if (_duration >= 0)
+  waitForEcho(_duration, _count, mutex, condition, count);
+}
+
+//////////////////////////////////////////////////
+extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicEchoSampled(
+  const char *_topic, const double _duration, int _count, int _sample)
+{
+  if (!validEchoTopic(_topic))
+    return;
+
+  if (_sample <= 0)
   {
-    std::this_thread::sleep_for(std::chrono::milliseconds(
-      static_cast<int64_t>(_duration * 1000)));
+    std::cerr << "Invalid sample [" << _sample << "]. It must be greater "
+              << "than 0.\n";
     return;
   }
 
-  // Wait forever if _count <= 0. Otherwise wait for a specific number of
-  // messages.
-  if (_count <= 0)
+  std::mutex mutex;
+  std::condition_variable condition;
+  int count = 0;
+  int64_t received = 0;
+
+  // Only the sampled messages are deserialized.
+  RawCallback cb = [&](const char *_data, const size_t _size,
+                       const MessageInfo &_info)
   {
-    ignition::transport::waitForShutdown();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (received++ % _sample != 0)
+      return;
+
+    auto msg = createMsg(_data, _size, _info.Type());
+    if (msg)
+      std::cout << msg->DebugString() << std::endl;
+    else
+      std::cerr << "Unable to deserialize a message of type ["
+                << _info.Type() << "]\n";
+    ++count;
+    condition.notify_one();
+  };
+
+  Node node;
+  if (!node.SubscribeRaw(_topic, cb))
+    return;
+
+  waitForEcho(_duration, _count, mutex, condition, count);
+}
+
+//////////////////////////////////////////////////
+extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicEchoRaw(
+  const char *_topic, const double _duration, int _count, const char *_file)
+{
+  if (!validEchoTopic(_topic))
+    return;
+
+  std::ofstream file;
+  if (_file && std::string(_file) != "" && std::string(_file) != "-")
+  {
+    file.open(_file, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+      std::cerr << "Unable to open [" << _file << "] for writing.\n";
+      return;
+    }
   }
-  else
+  std::ostream &out = file.is_open() ? file : std::cout;
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  int count = 0;
+
+  // Every message is written as its size (4 bytes, little endian) followed
+  // by the serialized message.
+  RawCallback cb = [&](const char *_data, const size_t _size,
+                       const MessageInfo &)
+  {
+    char size[4];
+    for (int i = 0; i < 4; ++i)
+      size[i] = static_cast<char>((_size >> (8 * i)) & 0xff);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    out.write(size, sizeof(size));
+    out.write(_data, static_cast<std::streamsize>(_size));
+    ++count;
+    condition.notify_one();
+  };
+
+  {
+    Node node;
+    if (!node.SubscribeRaw(_topic, cb))
+      return;
+
+    waitForEcho(_duration, _count, mutex, condition, count);
+  }
+
+  out.flush();
+}
+
+//////////////////////////////////////////////////
+extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicHz(const char *_topic,
+  const double _duration, int _count)
+{
+  if (!validEchoTopic(_topic))
+    return;
+
+  using Clock = std::chrono::steady_clock;
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  int count = 0;
+
+  // Statistics of the current window.
+  Clock::time_point windowStart;
+  uint64_t msgs = 0;
+  uint64_t bytes = 0;
+  size_t minSize = 0;
+  size_t maxSize = 0;
+  uint64_t lost = 0;
+
+  // Last sequence number received from every publisher.
+  std::map<std::string, uint64_t> sequences;
+
+  auto print = [&](const Clock::time_point &_now)
   {
-    while (count < _count)
+    const double elapsed =
+      std::chrono::duration<double>(_now - windowStart).count();
+    if (msgs == 0 || elapsed <= 0)
+      return;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "rate: " << msgs / elapsed << " Hz"
+              << "  bandwidth: " << bytes / elapsed / 1024.0 << " KiB/s"
+              << "  size: " << minSize << "/"
+              << static_cast<double>(bytes) / msgs << "/" << maxSize
+              << " B (min/mean/max)"
+              << "  msgs: " << msgs
+              << "  lost: " << lost << std::endl;
+
+    windowStart = _now;
+    msgs = 0;
+    bytes = 0;
+    lost = 0;
+  };
+
+  // Nothing is deserialized, only the sizes and the times are used.
+  RawCallback cb = [&](const char *, const size_t _size,
+                       const MessageInfo &_info)
+  {
+    const auto now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (msgs == 0 && count == 0)
+      windowStart = now;
+
+    if (msgs == 0 || _size < minSize)
+      minSize = _size;
+    if (msgs == 0 || _size > maxSize)
+      maxSize = _size;
+    ++msgs;
+    bytes += _size;
+
+    // Messages lost in transit leave gaps in the sequence numbers, unless
+    // the publisher is downsampling them for throttled subscribers.
+    if (!_info.PublisherUuid().empty())
     {
-      std::unique_lock<std::mutex> lock(mutex);
-      condition.wait(lock, [&]{return count >= _count;});
+      uint64_t &last = sequences[_info.PublisherUuid()];
+      if (last != 0 && _info.SequenceNumber() > last + 1 &&
+          _info.DownsamplingPeriod().count() == 0)
+        lost += _info.SequenceNumber() - last - 1;
+      last = _info.SequenceNumber();
     }
+
+    if (now - windowStart >= std::chrono::seconds(1))
+      print(now);
+
+    ++count;
+    condition.notify_one();
+  };
+
+  {
+    Node node;
+    if (!node.SubscribeRaw(_topic, cb))
+      return;
+
+    waitForEcho(_duration, _count, mutex, condition, count);
   }
+
+  // Print the last window.
+  std::lock_guard<std::mutex> lock(mutex);
+  print(Clock::now());
+}
+
+//////////////////////////////////////////////////
+// Helper to get a numeric value of a statistics entry.
+double statValue(const msgs::Param &_param, const std::string &_key)
+{
+  auto it = _param.params().find(_key);
+  return it == _param.params().end() ? 0.0 : it->second.double_value();
+}
+
+//////////////////////////////////////////////////
+// Helper to get a string value of a statistics entry.
+std::string statString(const msgs::Param &_param, const std::string &_key)
+{
+  auto it = _param.params().find(_key);
+  return it == _param.params().end() ? "" : it->second.string_value();
+}
+
+//////////////////////////////////////////////////
+// Helper to print the statistics of one process.
+void printStats(const msgs::Param_V &_msg, const std::string &_topic)
+{
+  std::string process;
+  std::string host;
+  for (const auto &data : _msg.header().data())
+  {
+    if (data.key() == "process" && data.value_size() > 0)
+      process = data.value(0);
+    else if (data.key() == "host" && data.value_size() > 0)
+      host = data.value(0);
+  }
+
+  bool first = true;
+  for (const auto &param : _msg.param())
+  {
+    const std::string topic = statString(param, "topic");
+    if (!_topic.empty() && topic != _topic)
+      continue;
+
+    if (first)
+    {
+      std::cout << "Process [" << process << "] on [" << host << "]\n"
+                << std::left
+                << "  " << std::setw(15) << "Role"
+                << std::setw(30) << "Topic"
+                << std::right
+                << std::setw(10) << "Msgs/s"
+                << std::setw(12) << "KiB/s"
+                << std::setw(12) << "Messages"
+                << std::setw(8) << "Drops"
+                << std::setw(8) << "Queue"
+                << std::setw(12) << "Mean cb us"
+                << std::setw(12) << "Max cb us" << "\n";
+      first = false;
+    }
+
+    const double messages = statValue(param, "messages");
+    const double meanCbUs = messages > 0 ?
+      statValue(param, "callback_time_ns") / messages / 1e3 : 0.0;
+
+    std::cout << std::left
+              << "  " << std::setw(15) << statString(param, "role")
+              << std::setw(30) << topic
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << statValue(param, "msgs_per_sec")
+              << std::setw(12) << statValue(param, "bytes_per_sec") / 1024.0
+              << std::setprecision(0)
+              << std::setw(12) << messages
+              << std::setw(8) << statValue(param, "drops")
+              << std::setw(8) << statValue(param, "queue_depth")
+              << std::setprecision(1)
+              << std::setw(12) << meanCbUs
+              << std::setw(12)
+              << statValue(param, "max_callback_time_ns") / 1e3 << "\n";
+  }
+
+  if (!first)
+    std::cout << std::endl;
+}
+
+//////////////////////////////////////////////////
+extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicStats(const char *_topic,
+  const double _duration, int _count)
+{
+  const std::string topic = _topic ? _topic : "";
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  int count = 0;
+
+  std::function<void(const msgs::Param_V&)> cb =
+    [&](const msgs::Param_V &_msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    printStats(_msg, topic);
+    ++count;
+    condition.notify_one();
+  };
+
+  Node node;
+  if (!node.Subscribe(kStatisticsTopic, cb))
+    return;
+
+  waitForEcho(_duration, _count, mutex, condition, count);
 }
 
 //////////////////////////////////////////////////
@@ -75,6 +75,60 @@ extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicEcho(const char *_topic,
                                                         const double _duration,
                                                         int _count);
 
+/// \brief External hook to execute 'ign topic -e --sample' from the command
+/// line. Only one of every _sample messages is deserialized and printed, so
+/// it can keep up with high rate topics.
+/// \param[in] _topic Topic name.
+/// \param[in] _duration Duration (seconds) to run. A value <= 0 indicates
+/// no time limit. The _duration parameter overrides the _count parameter.
+/// \param[in] _count Number of messages to print and then stop. A value <= 0
+/// indicates no limit. The _duration parameter overrides the _count
+/// parameter.
+/// \param[in] _sample Print one of every _sample messages received.
+extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicEchoSampled(
+  const char *_topic, const double _duration, int _count, int _sample);
+
+/// \brief External hook to execute 'ign topic -e --raw' from the command
+/// line. Every message is written without deserializing it, as its size
+/// (4 bytes, little endian) followed by the serialized data.
+/// \param[in] _topic Topic name.
+/// \param[in] _duration Duration (seconds) to run. A value <= 0 indicates
+/// no time limit. The _duration parameter overrides the _count parameter.
+/// \param[in] _count Number of messages to write and then stop. A value <= 0
+/// indicates no limit. The _duration parameter overrides the _count
+/// parameter.
+/// \param[in] _file Path of the output file. Null, empty or "-" to write to
+/// the standard output.
+extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicEchoRaw(
+  const char *_topic, const double _duration, int _count, const char *_file);
+
+/// \brief External hook to execute 'ign topic -e --hz' from the command
+/// line. It prints the rate, bandwidth, message sizes and lost messages of a
+/// topic about once per second, without deserializing the messages.
+/// \param[in] _topic Topic name.
+/// \param[in] _duration Duration (seconds) to run. A value <= 0 indicates
+/// no time limit. The _duration parameter overrides the _count parameter.
+/// \param[in] _count Number of messages to measure and then stop. A value
+/// <= 0 indicates no limit. The _duration parameter overrides the _count
+/// parameter.
+extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicHz(const char *_topic,
+                                                      const double _duration,
+                                                      int _count);
+
+/// \brief External hook to execute 'ign topic --stats' from the command
+/// line. It prints the statistics published on /ign/transport/stats by the
+/// processes that run with IGN_TRANSPORT_STATS=1.
+/// \param[in] _topic Only print the statistics of this topic. Null or empty
+/// to print the statistics of all the topics.
+/// \param[in] _duration Duration (seconds) to run. A value <= 0 indicates
+/// no time limit. The _duration parameter overrides the _count parameter.
+/// \param[in] _count Number of statistics messages to print and then stop.
+/// A value <= 0 indicates no limit. The _duration parameter overrides the
+/// _count parameter.
+extern "C" void IGNITION_TRANSPORT_VISIBLE cmdTopicStats(const char *_topic,
+                                                         const double _duration,
+                                                         int _count);
+
 /// \brief External hook to read the library version.
 /// \return C-string representing the version. Ex.: 0.1.2
 extern "C" const char IGNITION_TRANSPORT_VISIBLE *ignitionVersion();
@@ -15,9 +15,14 @@
  *
 */
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <vector>
 #include <ignition/msgs.hh>
 
 #include "gtest/gtest.h"
@@ -241,6 +246,162 @@ TEST(ignTest, cmdTopicEcho)
   restoreIO();
 }
 
+//////////////////////////////////////////////////
+/// \brief Publish Int32 messages on g_topic from another thread while a
+/// command runs.
+class BackgroundPublisher
+{
+  /// \brief Constructor. Starts publishing.
+  /// \param[in] _period Time between two messages.
+  public: explicit BackgroundPublisher(
+    const std::chrono::milliseconds &_period)
+  {
+    this->pub = this->node.Advertise<ignition::msgs::Int32>(g_topic);
+    EXPECT_TRUE(this->pub);
+    this->thread = std::thread([this, _period]
+    {
+      // Start at 1, a 0 would not be printed by DebugString().
+      ignition::msgs::Int32 msg;
+      int data = 1;
+      while (!this->done)
+      {
+        msg.set_data(data++);
+        this->pub.Publish(msg);
+        std::this_thread::sleep_for(_period);
+      }
+    });
+  }
+
+  /// \brief Destructor. Stops publishing.
+  public: ~BackgroundPublisher()
+  {
+    this->done = true;
+    this->thread.join();
+  }
+
+  /// \brief Node used to advertise the topic.
+  private: transport::Node node;
+
+  /// \brief Publisher of g_topic.
+  private: transport::Node::Publisher pub;
+
+  /// \brief Thread publishing the messages.
+  private: std::thread thread;
+
+  /// \brief Set to stop publishing.
+  private: std::atomic<bool> done{false};
+};
+
+//////////////////////////////////////////////////
+/// \brief Check cmdTopicEchoSampled running the advertiser on the same
+/// process.
+TEST(ignTest, cmdTopicEchoSampled)
+{
+  std::stringstream  stdOutBuffer;
+  std::stringstream  stdErrBuffer;
+  redirectIO(stdOutBuffer, stdErrBuffer);
+
+  cmdTopicEchoSampled(nullptr, 1.0, 0, 2);
+  EXPECT_EQ(stdErrBuffer.str(), "Invalid topic. Topic must not be empty.\n");
+  clearIOStreams(stdOutBuffer, stdErrBuffer);
+
+  cmdTopicEchoSampled(g_topic.c_str(), 1.0, 0, 0);
+  EXPECT_EQ(stdErrBuffer.str(),
+    "Invalid sample [0]. It must be greater than 0.\n");
+  clearIOStreams(stdOutBuffer, stdErrBuffer);
+
+  {
+    BackgroundPublisher publisher(std::chrono::milliseconds(5));
+    cmdTopicEchoSampled(g_topic.c_str(), -1.0, 3, 4);
+  }
+
+  // One of every four messages is printed, starting by the first one that
+  // was received.
+  std::vector<int> values;
+  std::string line;
+  while (std::getline(stdOutBuffer, line))
+  {
+    if (line.find("data: ") == 0)
+      values.push_back(std::stoi(line.substr(6)));
+  }
+  restoreIO();
+
+  ASSERT_EQ(3u, values.size());
+  EXPECT_EQ(values[0] + 4, values[1]);
+  EXPECT_EQ(values[1] + 4, values[2]);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check cmdTopicEchoRaw running the advertiser on the same process.
+TEST(ignTest, cmdTopicEchoRaw)
+{
+  std::stringstream  stdOutBuffer;
+  std::stringstream  stdErrBuffer;
+  redirectIO(stdOutBuffer, stdErrBuffer);
+
+  {
+    BackgroundPublisher publisher(std::chrono::milliseconds(5));
+    cmdTopicEchoRaw(g_topic.c_str(), -1.0, 5, nullptr);
+  }
+  restoreIO();
+
+  // Read the length prefixed messages.
+  const std::string out = stdOutBuffer.str();
+  size_t pos = 0;
+  int msgs = 0;
+  int lastData = -1;
+  while (pos + 4 <= out.size())
+  {
+    uint32_t size = 0;
+    for (int i = 3; i >= 0; --i)
+      size = (size << 8) | static_cast<unsigned char>(out[pos + i]);
+    pos += 4;
+    ASSERT_LE(pos + size, out.size());
+
+    ignition::msgs::Int32 msg;
+    EXPECT_TRUE(msg.ParseFromArray(out.data() + pos, static_cast<int>(size)));
+    if (lastData >= 0)
+    {
+      EXPECT_EQ(lastData + 1, msg.data());
+    }
+    lastData = msg.data();
+    pos += size;
+    ++msgs;
+  }
+  EXPECT_EQ(out.size(), pos);
+  EXPECT_EQ(5, msgs);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check cmdTopicHz running the advertiser on the same process.
+TEST(ignTest, cmdTopicHz)
+{
+  std::stringstream  stdOutBuffer;
+  std::stringstream  stdErrBuffer;
+  redirectIO(stdOutBuffer, stdErrBuffer);
+
+  {
+    BackgroundPublisher publisher(std::chrono::milliseconds(10));
+    cmdTopicHz(g_topic.c_str(), 2.5, 0);
+  }
+  restoreIO();
+
+  // At least two full windows and the last partial one.
+  std::vector<double> rates;
+  std::string line;
+  while (std::getline(stdOutBuffer, line))
+  {
+    EXPECT_NE(std::string::npos, line.find("lost: 0")) << line;
+    ASSERT_EQ(0u, line.find("rate: ")) << line;
+    rates.push_back(std::stod(line.substr(6)));
+  }
+  ASSERT_GE(rates.size(), 2u);
+
+  // The publisher sends less than 100 messages per second.
+  EXPECT_GT(rates[0], 10.0);
+  EXPECT_LE(rates[0], 101.0);
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
@@ -15,8 +15,13 @@
  *
 */
 
+#include <atomic>
 #include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <ignition/msgs.hh>
 
 #include "gtest/gtest.h"
@@ -135,6 +140,43 @@ TEST(twoProcPubSub, PubSubTwoProcsThreeNodes)
   testing::waitAndCleanupFork(pi);
 }
 
+//////////////////////////////////////////////////
+/// \brief Check that WaitForSubscribers() returns as soon as the nodes of
+/// another process subscribe.
+TEST(twoProcPubSub, PubWaitForSubscribers)
+{
+  transport::Node node;
+  auto pub = node.Advertise<ignition::msgs::Vector3d>(g_topic);
+  EXPECT_TRUE(pub);
+
+  // No subscribers yet.
+  EXPECT_FALSE(pub.WaitForSubscribers(1, 10));
+
+  std::string subscriberPath = testing::portablePathUnion(
+     IGN_TRANSPORT_TEST_DIR,
+     "INTEGRATION_twoProcsPubSubSubscriber_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(subscriberPath.c_str(),
+    partition.c_str());
+
+  // The subscriber process has two nodes.
+  EXPECT_TRUE(pub.WaitForSubscribers(2, 5000));
+  EXPECT_TRUE(pub.HasConnections());
+
+  // Keep publishing until the subscriber process exits.
+  ignition::msgs::Vector3d msg;
+  msg.set_x(1.0);
+  msg.set_y(2.0);
+  msg.set_z(3.0);
+  for (auto i = 0; i < 10; ++i)
+  {
+    EXPECT_TRUE(pub.Publish(msg));
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  }
+
+  testing::waitAndCleanupFork(pi);
+}
+
 //////////////////////////////////////////////////
 /// \brief This is the same as the last test, but we use PublishRaw(~) instead
 /// of Publish(~).
@@ -177,6 +219,50 @@ TEST(twoProcPubSub, RawPubSubTwoProcsThreeNodes)
   testing::waitAndCleanupFork(pi);
 }
 
+//////////////////////////////////////////////////
+/// \brief Same as the last test, but publishing a buffer owned by the caller
+/// without copying it.
+TEST(twoProcPubSub, RawPubSubZeroCopyTwoProcsThreeNodes)
+{
+  transport::Node node;
+  auto pub = node.Advertise<ignition::msgs::Vector3d>(g_topic);
+  EXPECT_TRUE(pub);
+
+  std::string subscriberPath = testing::portablePathUnion(
+     IGN_TRANSPORT_TEST_DIR,
+     "INTEGRATION_twoProcsPubSubSubscriber_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(subscriberPath.c_str(),
+    partition.c_str());
+
+  ignition::msgs::Vector3d msg;
+  msg.set_x(1.0);
+  msg.set_y(2.0);
+  msg.set_z(3.0);
+  auto buffer = std::make_shared<const std::string>(msg.SerializeAsString());
+
+  unsigned int retries = 0u;
+
+  while (!pub.HasConnections() && retries++ < 5u)
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  // Now, we should have subscribers.
+  EXPECT_LT(retries, 5u);
+
+  // Publish messages for a few seconds
+  for (auto i = 0; i < 10; ++i)
+  {
+    EXPECT_TRUE(pub.PublishRaw(buffer->data(), buffer->size(),
+        msg.GetTypeName(), buffer));
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  }
+
+  testing::waitAndCleanupFork(pi);
+
+  // ZeroMQ released the buffer once it was sent.
+  EXPECT_EQ(1, buffer.use_count());
+}
+
 //////////////////////////////////////////////////
 /// \brief Check that a message is not received if the callback does not use
 /// the advertised types.
@@ -390,6 +476,269 @@ TEST(twoProcPubSub, SubThrottled)
   testing::waitAndCleanupFork(pi);
 }
 
+//////////////////////////////////////////////////
+/// \brief When the only remote subscriber is throttled, the publisher should
+/// only send the messages that it is going to accept.
+TEST(twoProcPubSub, SubThrottledDownsampled)
+{
+  std::string publisherPath = testing::portablePathUnion(
+     IGN_TRANSPORT_TEST_DIR, "INTEGRATION_pub_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(publisherPath.c_str(),
+    partition.c_str());
+
+  std::mutex mutex;
+  std::vector<uint64_t> sequence;
+  std::function<void(const ignition::msgs::Int32 &,
+                     const transport::MessageInfo &)> cb =
+    [&](const ignition::msgs::Int32 &, const transport::MessageInfo &_info)
+    {
+      EXPECT_EQ(std::chrono::milliseconds(500), _info.DownsamplingPeriod());
+      std::lock_guard<std::mutex> lk(mutex);
+      sequence.push_back(_info.SequenceNumber());
+    };
+
+  transport::Node node;
+  ignition::transport::SubscribeOptions opts;
+  opts.SetMsgsPerSec(2u);
+  EXPECT_TRUE(node.Subscribe(g_topic, cb, opts));
+
+  testing::waitAndCleanupFork(pi);
+
+  // The publisher sends 15 messages at 10 Hz, but we only get one every
+  // 500 ms, so there are gaps in the sequence numbers.
+  std::lock_guard<std::mutex> lk(mutex);
+  ASSERT_GE(sequence.size(), 2u);
+  EXPECT_LE(sequence.size(), 4u);
+  for (size_t i = 1; i < sequence.size(); ++i)
+    EXPECT_GE(sequence[i] - sequence[i - 1], 4u);
+}
+
+//////////////////////////////////////////////////
+/// \brief A subscriber with a filter in another process should only receive
+/// the messages that match it.
+TEST(twoProcPubSub, SubFiltered)
+{
+  std::string publisherPath = testing::portablePathUnion(
+     IGN_TRANSPORT_TEST_DIR, "INTEGRATION_pub_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(publisherPath.c_str(),
+    partition.c_str());
+
+  reset();
+
+  // The publisher always sends 1.
+  transport::Node node;
+  ignition::transport::SubscribeOptions opts;
+  opts.SetFilter("data == 1");
+  EXPECT_TRUE(node.Subscribe(g_topic, cb, opts));
+
+  transport::Node filteredNode;
+  int filteredCounter = 0;
+  std::function<void(const ignition::msgs::Int32 &)> filteredCb =
+    [&filteredCounter](const ignition::msgs::Int32 &)
+    {
+      ++filteredCounter;
+    };
+  ignition::transport::SubscribeOptions filteredOpts;
+  filteredOpts.SetFilter("data == 2");
+  EXPECT_TRUE(filteredNode.Subscribe(g_topic, filteredCb, filteredOpts));
+
+  testing::waitAndCleanupFork(pi);
+
+  EXPECT_GT(counter, 0);
+  EXPECT_EQ(0, filteredCounter);
+
+  reset();
+}
+
+//////////////////////////////////////////////////
+/// \brief Two throttled subscribers with different filters in another
+/// process. The publisher sends both entities at every step, so neither
+/// subscriber should starve the other one.
+TEST(twoProcPubSub, SubFilteredThrottled)
+{
+  std::string publisherPath = testing::portablePathUnion(
+     IGN_TRANSPORT_TEST_DIR, "INTEGRATION_filteredPub_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(publisherPath.c_str(),
+    partition.c_str());
+
+  std::atomic<int> firstCounter{0};
+  std::function<void(const ignition::msgs::Int32 &)> firstCb =
+    [&firstCounter](const ignition::msgs::Int32 &_msg)
+    {
+      EXPECT_EQ(1, _msg.data());
+      ++firstCounter;
+    };
+
+  std::atomic<int> secondCounter{0};
+  std::function<void(const ignition::msgs::Int32 &)> secondCb =
+    [&secondCounter](const ignition::msgs::Int32 &_msg)
+    {
+      EXPECT_EQ(2, _msg.data());
+      ++secondCounter;
+    };
+
+  transport::Node firstNode;
+  ignition::transport::SubscribeOptions firstOpts;
+  firstOpts.SetFilter("data == 1");
+  firstOpts.SetMsgsPerSec(5u);
+  EXPECT_TRUE(firstNode.Subscribe(g_topic, firstCb, firstOpts));
+
+  transport::Node secondNode;
+  ignition::transport::SubscribeOptions secondOpts;
+  secondOpts.SetFilter("data == 2");
+  secondOpts.SetMsgsPerSec(5u);
+  EXPECT_TRUE(secondNode.Subscribe(g_topic, secondCb, secondOpts));
+
+  testing::waitAndCleanupFork(pi);
+
+  // The publisher sends 15 steps at 10 Hz and each subscriber accepts one
+  // message every 200 ms.
+  EXPECT_GE(firstCounter, 2);
+  EXPECT_LE(firstCounter, 9);
+  EXPECT_GE(secondCounter, 2);
+  EXPECT_LE(secondCounter, 9);
+}
+
+//////////////////////////////////////////////////
+/// \brief Receive batches from another process, with batch, single message
+/// and raw subscribers. The filter of a subscriber is applied by the
+/// publisher to every message of a batch.
+TEST(twoProcPubSub, PubSubBatch)
+{
+  std::string publisherPath = testing::portablePathUnion(
+     IGN_TRANSPORT_TEST_DIR, "INTEGRATION_batchPub_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(publisherPath.c_str(),
+    partition.c_str());
+
+  std::mutex mutex;
+  std::vector<std::vector<int>> batches;
+  transport::MsgBatchCallback<ignition::msgs::Int32> batchCb =
+    [&](const std::vector<const ignition::msgs::Int32 *> &_msgs,
+        const transport::MessageInfo &_info)
+    {
+      EXPECT_FALSE(_info.IntraProcess());
+      EXPECT_EQ(1u, _info.SequenceNumber() % 3);
+
+      std::lock_guard<std::mutex> lk(mutex);
+      std::vector<int> batch;
+      for (const auto *msg : _msgs)
+        batch.push_back(msg->data());
+      batches.push_back(batch);
+    };
+
+  transport::Node node;
+  EXPECT_TRUE(node.SubscribeBatch(g_topic, batchCb));
+
+  std::vector<uint64_t> sequence;
+  std::function<void(const ignition::msgs::Int32 &,
+                     const transport::MessageInfo &)> filteredCb =
+    [&](const ignition::msgs::Int32 &_msg,
+        const transport::MessageInfo &_info)
+    {
+      EXPECT_NE(2, _msg.data());
+      std::lock_guard<std::mutex> lk(mutex);
+      sequence.push_back(_info.SequenceNumber());
+    };
+
+  transport::Node filteredNode;
+  transport::SubscribeOptions opts;
+  opts.SetFilter("data != 2");
+  EXPECT_TRUE(filteredNode.Subscribe(g_topic, filteredCb, opts));
+
+  testing::waitAndCleanupFork(pi);
+
+  std::lock_guard<std::mutex> lk(mutex);
+  ASSERT_FALSE(batches.empty());
+  for (const auto &batch : batches)
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), batch);
+
+  // The messages keep the sequence number that they had in their batch.
+  ASSERT_FALSE(sequence.empty());
+  for (const uint64_t seq : sequence)
+    EXPECT_NE(2u, seq % 3);
+}
+
+//////////////////////////////////////////////////
+/// \brief Receive a high priority topic and a normal one from another
+/// process. They are sent through different sockets.
+TEST(twoProcPubSub, PubSubPriority)
+{
+  std::string publisherPath = testing::portablePathUnion(
+     IGN_TRANSPORT_TEST_DIR, "INTEGRATION_priorityPub_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(publisherPath.c_str(),
+    partition.c_str());
+
+  reset();
+
+  std::atomic<int> bulkCounter{0};
+  std::function<void(const ignition::msgs::Int32 &)> bulkCb =
+    [&bulkCounter](const ignition::msgs::Int32 &)
+    {
+      ++bulkCounter;
+    };
+
+  transport::Node node;
+  EXPECT_TRUE(node.Subscribe(g_topic, cb));
+  EXPECT_TRUE(node.Subscribe("/bulk", bulkCb));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  // The discovered publishers have their priority and different addresses.
+  std::vector<transport::MessagePublisher> publishers;
+  ASSERT_TRUE(node.TopicInfo(g_topic, publishers));
+  ASSERT_EQ(1u, publishers.size());
+  EXPECT_EQ(transport::Priority_t::HIGH, publishers[0].Options().Priority());
+
+  std::vector<transport::MessagePublisher> bulkPublishers;
+  ASSERT_TRUE(node.TopicInfo("/bulk", bulkPublishers));
+  ASSERT_EQ(1u, bulkPublishers.size());
+  EXPECT_EQ(transport::Priority_t::NORMAL,
+    bulkPublishers[0].Options().Priority());
+  EXPECT_NE(publishers[0].Addr(), bulkPublishers[0].Addr());
+
+#ifndef _WIN32
+  // Both lanes are also reachable through IPC, since we share the host.
+  EXPECT_EQ(0u, publishers[0].IpcAddr().find("ipc://"));
+  EXPECT_EQ(0u, bulkPublishers[0].IpcAddr().find("ipc://"));
+  EXPECT_NE(publishers[0].IpcAddr(), bulkPublishers[0].IpcAddr());
+#endif
+
+  testing::waitAndCleanupFork(pi);
+
+  EXPECT_GT(counter, 0);
+  EXPECT_GT(bulkCounter, 0);
+
+  reset();
+}
+
+//////////////////////////////////////////////////
+/// \brief Receive a multicast topic from another process. Multicast
+/// messages are not looped back, so they arrive through unicast.
+TEST(twoProcPubSub, PubSubMulticast)
+{
+  std::string publisherPath = testing::portablePathUnion(
+     IGN_TRANSPORT_TEST_DIR, "INTEGRATION_multicastPub_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(publisherPath.c_str(),
+    partition.c_str());
+
+  reset();
+
+  transport::Node node;
+  EXPECT_TRUE(node.Subscribe(g_topic, cb));
+
+  testing::waitAndCleanupFork(pi);
+
+  EXPECT_GT(counter, 0);
+
+  reset();
+}
+
 //////////////////////////////////////////////////
 /// \brief This test creates one publisher and one subscriber on different
 /// processes. The publisher publishes at a throttled frequency.
@@ -446,6 +795,58 @@ TEST(twoProcPubSub, PubSubMessageInfo)
   testing::waitAndCleanupFork(pi);
 }
 
+//////////////////////////////////////////////////
+/// \brief Check that messages received from another process carry the
+/// publication time, the sequence number and the publisher UUID.
+TEST(twoProcPubSub, PubSubMessageHeader)
+{
+  std::string publisherPath = testing::portablePathUnion(
+     IGN_TRANSPORT_TEST_DIR, "INTEGRATION_twoProcsPublisher_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(publisherPath.c_str(),
+    partition.c_str());
+
+  std::mutex mutex;
+  std::vector<uint64_t> sequence;
+  std::string uuid;
+  std::function<void(const ignition::msgs::Vector3d &,
+                     const transport::MessageInfo &)> cb =
+    [&](const ignition::msgs::Vector3d &, const transport::MessageInfo &_info)
+    {
+      EXPECT_FALSE(_info.IntraProcess());
+
+      // Both processes run on this host, so they share the steady clock.
+      auto latency = std::chrono::steady_clock::now() -
+        _info.PublicationTime();
+      EXPECT_GE(latency.count(), 0);
+      EXPECT_LT(latency, std::chrono::seconds(1));
+
+      std::lock_guard<std::mutex> lk(mutex);
+      sequence.push_back(_info.SequenceNumber());
+      EXPECT_FALSE(_info.PublisherUuid().empty());
+      if (!uuid.empty())
+      {
+        EXPECT_EQ(uuid, _info.PublisherUuid());
+      }
+      uuid = _info.PublisherUuid();
+    };
+
+  transport::Node node;
+  EXPECT_TRUE(node.Subscribe(g_topic, cb));
+
+  testing::waitAndCleanupFork(pi);
+
+  // The publisher sends two messages. Depending on how fast the discovery
+  // is, we might miss the first one.
+  std::lock_guard<std::mutex> lk(mutex);
+  ASSERT_FALSE(sequence.empty());
+  EXPECT_EQ(2u, sequence.back());
+  if (sequence.size() == 2u)
+  {
+    EXPECT_EQ(1u, sequence.front());
+  }
+}
+
 //////////////////////////////////////////////////
 /// \brief This test spawns two nodes on different processes. One of the nodes
 /// advertises a topic and the other uses TopicList() for getting the list of
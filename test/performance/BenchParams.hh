@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_TRANSPORT_TEST_PERFORMANCE_BENCHPARAMS_HH_
+#define IGNITION_TRANSPORT_TEST_PERFORMANCE_BENCHPARAMS_HH_
+
+#include <ignition/msgs/bytes.pb.h>
+#include <ignition/transport/test_config.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace ignition
+{
+  namespace transport
+  {
+    namespace bench
+    {
+      /// \brief Topic where the benchmarks publish the messages that the
+      /// PERFORMANCE_echo_aux process sends back.
+      const std::string kPingTopic = "/bench/ping";  // NOLINT(*)
+
+      /// \brief Topic where PERFORMANCE_echo_aux republishes every message
+      /// received on kPingTopic.
+      const std::string kPongTopic = "/bench/pong";  // NOLINT(*)
+
+      /// \brief Service offered by PERFORMANCE_echo_aux. The response is a
+      /// copy of the request.
+      const std::string kEchoService = "/bench/echo";  // NOLINT(*)
+
+      /// \brief Prefix of the topics advertised by PERFORMANCE_topics_aux.
+      /// The topic names are the prefix followed by an index.
+      const std::string kTopicPrefix = "/bench/topic_";  // NOLINT(*)
+
+      /// \brief Environment variable with the number of topics that
+      /// PERFORMANCE_topics_aux should advertise. Environment variables are
+      /// inherited by the forked process, so this lets us keep using
+      /// testing::forkAndRun().
+      const char kNumTopicsEnv[] = "IGN_TRANSPORT_BENCH_TOPICS";
+
+      /// \brief Message type used by all the benchmarks.
+      using BenchMsgType = ignition::msgs::Bytes;
+
+      /// \brief Smallest message size used by the benchmarks, in bytes.
+      const int64_t kMinMsgSize = 16;
+
+      /// \brief Largest message size used by the benchmarks, in bytes.
+      const int64_t kMaxMsgSize = 16 << 20;
+
+      /// \brief Maximum time to wait for a message or a response before a
+      /// benchmark is reported as failed.
+      const std::chrono::seconds kTimeout(10);
+
+      //////////////////////////////////////////////////
+      /// \brief Create a message with a payload of the given size.
+      /// \param[in] _size Number of payload bytes.
+      /// \return The message.
+      inline BenchMsgType Payload(const int64_t _size)
+      {
+        BenchMsgType msg;
+        msg.mutable_data()->assign(static_cast<std::size_t>(_size), 'x');
+        return msg;
+      }
+
+      //////////////////////////////////////////////////
+      /// \brief Thread-safe counter of received messages that can be waited
+      /// on from the benchmark thread.
+      class Counter
+      {
+        /// \brief Count one more message and wake up the waiting thread.
+        public: void Increment()
+        {
+          {
+            std::lock_guard<std::mutex> lk(this->mutex);
+            ++this->count;
+          }
+          this->cv.notify_one();
+        }
+
+        /// \brief Get the number of messages counted so far.
+        /// \return The number of messages.
+        public: uint64_t Count()
+        {
+          std::lock_guard<std::mutex> lk(this->mutex);
+          return this->count;
+        }
+
+        /// \brief Block until the counter reaches a value.
+        /// \param[in] _target Value to wait for.
+        /// \param[in] _timeout Maximum time to wait.
+        /// \return True if the value was reached or false on timeout.
+        public: bool WaitFor(const uint64_t _target,
+            const std::chrono::nanoseconds &_timeout = kTimeout)
+        {
+          std::unique_lock<std::mutex> lk(this->mutex);
+          return this->cv.wait_for(lk, _timeout,
+              [this, _target]{return this->count >= _target;});
+        }
+
+        /// \brief Protects count.
+        private: std::mutex mutex;
+
+        /// \brief Signaled every time the counter is incremented.
+        private: std::condition_variable cv;
+
+        /// \brief Number of messages counted.
+        private: uint64_t count = 0;
+      };
+
+      //////////////////////////////////////////////////
+      /// \brief Runs one of the auxiliary benchmark processes in its own
+      /// partition, and terminates it on destruction.
+      class AuxProcess
+      {
+        /// \brief Constructor. Starts the process.
+        /// \param[in] _name Name of the auxiliary executable, which must be
+        /// in the same directory as the benchmark.
+        public: explicit AuxProcess(const std::string &_name)
+          : partition(testing::getRandomNumber())
+        {
+          const std::string path = testing::portablePathUnion(
+            IGN_TRANSPORT_TEST_DIR, _name);
+          this->handle = testing::forkAndRun(path.c_str(),
+            this->partition.c_str());
+        }
+
+        /// \brief Destructor. Terminates the process.
+        public: ~AuxProcess()
+        {
+          testing::killFork(this->handle);
+          testing::waitAndCleanupFork(this->handle);
+        }
+
+        /// \brief Get the echo process shared by all the benchmarks of this
+        /// executable. It is started the first time this is called, so that
+        /// benchmarks filtered out with --benchmark_filter do not pay for
+        /// it.
+        /// \return The PERFORMANCE_echo_aux process.
+        public: static AuxProcess &Echo()
+        {
+          static AuxProcess echo("PERFORMANCE_echo_aux");
+          return echo;
+        }
+
+        /// \brief Partition used by the process.
+        public: const std::string partition;
+
+        /// \brief Handle of the process.
+        private: testing::forkHandlerType handle;
+      };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+/// \file discovery.cc
+/// \brief Discovery benchmarks. Each iteration starts PERFORMANCE_topics_aux
+/// in a new partition and measures the time until the first message is
+/// received from it. This includes the start of the process, which is what a
+/// user observes when launching a publisher.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <string>
+
+#include "ignition/transport/Node.hh"
+#include "ignition/transport/NodeOptions.hh"
+#include "ignition/transport/test_config.h"
+
+#include "BenchParams.hh"
+
+using namespace ignition;
+using namespace ignition::transport::bench;
+
+//////////////////////////////////////////////////
+/// \brief Time from the start of a process that advertises N topics until a
+/// subscriber of the last topic receives its first message. range(0) is the
+/// number of topics.
+static void BM_TimeToFirstMessage(benchmark::State &_state)
+{
+  const int64_t numTopics = _state.range(0);
+  setenv(kNumTopicsEnv, std::to_string(numTopics).c_str(), 1);
+
+  for (auto _ : _state)
+  {
+    Counter counter;
+    std::function<void(const BenchMsgType &)> cb =
+      [&counter](const BenchMsgType &)
+      {
+        counter.Increment();
+      };
+
+    // Subscribe before starting the publisher, so the time measured is the
+    // time needed to discover it and connect to it.
+    transport::NodeOptions opts;
+    const std::string partition = testing::getRandomNumber();
+    opts.SetPartition(partition);
+    transport::Node node(opts);
+    if (!node.Subscribe(kTopicPrefix + std::to_string(numTopics - 1), cb))
+    {
+      _state.SkipWithError("Unable to subscribe");
+      break;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::string path = testing::portablePathUnion(
+      IGN_TRANSPORT_TEST_DIR, "PERFORMANCE_topics_aux");
+    testing::forkHandlerType pi =
+      testing::forkAndRun(path.c_str(), partition.c_str());
+
+    const bool received = counter.WaitFor(1);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    testing::killFork(pi);
+    testing::waitAndCleanupFork(pi);
+
+    if (!received)
+    {
+      _state.SkipWithError("Timeout waiting for the first message");
+      break;
+    }
+
+    _state.SetIterationTime(
+      std::chrono::duration<double>(elapsed).count());
+  }
+}
+BENCHMARK(BM_TimeToFirstMessage)
+  ->ArgName("topics")
+  ->RangeMultiplier(10)->Range(1, 1000)
+  ->Iterations(5)
+  ->UseManualTime()
+  ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <ignition/msgs.hh>
+
+#include "ignition/transport/Node.hh"
+#include "ignition/transport/test_config.h"
+
+#include "BenchParams.hh"
+
+using namespace ignition;
+
+//////////////////////////////////////////////////
+/// \brief Provide a service that returns a copy of the request.
+bool srvEcho(const transport::bench::BenchMsgType &_req,
+             transport::bench::BenchMsgType &_rep)
+{
+  _rep = _req;
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Echo every message received on kPingTopic to kPongTopic and offer
+/// the kEchoService service until the process is terminated. The messages are
+/// forwarded without deserializing them, so that the benchmarks measure the
+/// transport and not this process.
+int main(int argc, char **argv)
+{
+  if (argc != 2)
+  {
+    std::cerr << "Partition name has not be passed as argument" << std::endl;
+    return -1;
+  }
+
+  // Set the partition name for this process.
+  setenv("IGN_PARTITION", argv[1], 1);
+
+  const std::string msgType =
+      transport::bench::BenchMsgType().GetTypeName();
+
+  transport::Node node;
+  auto pub = node.Advertise(transport::bench::kPongTopic, msgType);
+  if (!pub)
+  {
+    std::cerr << "Error advertising " << transport::bench::kPongTopic
+              << std::endl;
+    return -1;
+  }
+
+  std::function<void(const char *, const size_t,
+                     const transport::MessageInfo &)> cb =
+    [&pub, &msgType](const char *_data, const size_t _size,
+                     const transport::MessageInfo &)
+    {
+      pub.PublishRaw(_data, _size, msgType, nullptr);
+    };
+
+  if (!node.SubscribeRaw(transport::bench::kPingTopic, cb, msgType))
+  {
+    std::cerr << "Error subscribing to " << transport::bench::kPingTopic
+              << std::endl;
+    return -1;
+  }
+
+  if (!node.Advertise(transport::bench::kEchoService, srvEcho))
+  {
+    std::cerr << "Error advertising " << transport::bench::kEchoService
+              << std::endl;
+    return -1;
+  }
+
+  transport::waitForShutdown();
+  return 0;
+}
@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+/// \file pubsub.cc
+/// \brief Publish/subscribe benchmarks. Intra-process benchmarks run within
+/// this process, inter-process benchmarks exchange messages with
+/// PERFORMANCE_echo_aux, which echoes every message back.
+///
+/// Sizes range from kMinMsgSize to kMaxMsgSize. Run with
+/// --benchmark_out=<file> --benchmark_out_format=json to get a
+/// machine-readable report, or build the `run_benchmarks` target.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ignition/transport/Node.hh"
+#include "ignition/transport/NodeOptions.hh"
+#include "ignition/transport/test_config.h"
+
+#include "BenchParams.hh"
+
+using namespace ignition;
+using namespace ignition::transport::bench;
+
+/// \brief Number of bytes in flight for each iteration of the inter-process
+/// throughput benchmark. Small messages are sent in windows of many
+/// messages, large ones in windows of a few.
+static const int64_t kThroughputWindowBytes = 8 << 20;
+
+/// \brief Maximum number of messages in flight. This is well below the
+/// ZeroMQ high water mark, so no message is dropped.
+static const int64_t kMaxThroughputWindow = 256;
+
+//////////////////////////////////////////////////
+/// \brief Subscribe a counter to a topic, either with a typed or with a raw
+/// callback.
+/// \param[in] _node Node used to subscribe.
+/// \param[in] _topic Topic name.
+/// \param[in] _raw True to use a raw subscription.
+/// \param[in] _counter Counter incremented for every message.
+/// \return True if the subscription succeeded.
+static bool subscribeCounter(transport::Node &_node, const std::string &_topic,
+    const bool _raw, Counter &_counter)
+{
+  if (_raw)
+  {
+    std::function<void(const char *, const size_t,
+                       const transport::MessageInfo &)> cb =
+      [&_counter](const char *, const size_t, const transport::MessageInfo &)
+      {
+        _counter.Increment();
+      };
+    return _node.SubscribeRaw(_topic, cb, BenchMsgType().GetTypeName());
+  }
+
+  std::function<void(const BenchMsgType &)> cb =
+    [&_counter](const BenchMsgType &)
+    {
+      _counter.Increment();
+    };
+  return _node.Subscribe(_topic, cb);
+}
+
+//////////////////////////////////////////////////
+/// \brief Set the counters shared by all the pub/sub benchmarks.
+/// \param[in] _state Benchmark state.
+/// \param[in] _msgs Number of messages published per iteration.
+static void setCounters(benchmark::State &_state, const int64_t _msgs)
+{
+  _state.SetItemsProcessed(_state.iterations() * _msgs);
+  _state.SetBytesProcessed(_state.iterations() * _msgs * _state.range(0));
+}
+
+//////////////////////////////////////////////////
+/// \brief Time from publication to delivery to one subscriber in the same
+/// process. range(0) is the message size and range(1) is 1 for a raw
+/// subscription and 0 for a typed one.
+static void BM_IntraProcessLatency(benchmark::State &_state)
+{
+  transport::NodeOptions opts;
+  opts.SetPartition(testing::getRandomNumber());
+  transport::Node node(opts);
+
+  const std::string topic = "/bench/intra";
+  auto pub = node.Advertise<BenchMsgType>(topic);
+  Counter counter;
+  if (!pub || !subscribeCounter(node, topic, _state.range(1) != 0, counter))
+  {
+    _state.SkipWithError("Unable to advertise or subscribe");
+    return;
+  }
+
+  const auto msg = Payload(_state.range(0));
+  uint64_t expected = 0;
+  for (auto _ : _state)
+  {
+    pub.Publish(msg);
+    if (!counter.WaitFor(++expected))
+    {
+      _state.SkipWithError("Timeout waiting for the message");
+      break;
+    }
+  }
+
+  setCounters(_state, 1);
+}
+BENCHMARK(BM_IntraProcessLatency)
+  ->ArgNames({"size", "raw"})
+  ->ArgsProduct({benchmark::CreateRange(kMinMsgSize, kMaxMsgSize, 8), {0, 1}})
+  ->UseRealTime();
+
+//////////////////////////////////////////////////
+/// \brief Time to deliver one message to N subscribers in the same process,
+/// each one in its own node. range(0) is the message size and range(1) is
+/// the number of subscribers.
+static void BM_IntraProcessFanOut(benchmark::State &_state)
+{
+  transport::NodeOptions opts;
+  opts.SetPartition(testing::getRandomNumber());
+  transport::Node pubNode(opts);
+
+  const std::string topic = "/bench/fanout";
+  auto pub = pubNode.Advertise<BenchMsgType>(topic);
+
+  const int64_t numSubs = _state.range(1);
+  Counter counter;
+  std::vector<std::unique_ptr<transport::Node>> subNodes;
+  for (int64_t i = 0; i < numSubs; ++i)
+  {
+    subNodes.emplace_back(new transport::Node(opts));
+    if (!subscribeCounter(*subNodes.back(), topic, false, counter))
+    {
+      _state.SkipWithError("Unable to subscribe");
+      return;
+    }
+  }
+
+  const auto msg = Payload(_state.range(0));
+  uint64_t expected = 0;
+  for (auto _ : _state)
+  {
+    pub.Publish(msg);
+    expected += static_cast<uint64_t>(numSubs);
+    if (!counter.WaitFor(expected))
+    {
+      _state.SkipWithError("Timeout waiting for the messages");
+      break;
+    }
+  }
+
+  setCounters(_state, numSubs);
+}
+BENCHMARK(BM_IntraProcessFanOut)
+  ->ArgNames({"size", "subscribers"})
+  ->ArgsProduct({{kMinMsgSize, 64 << 10}, {1, 4, 16, 64}})
+  ->UseRealTime();
+
+//////////////////////////////////////////////////
+/// \brief Node, publisher and subscription used to exchange messages with
+/// PERFORMANCE_echo_aux.
+class EchoClient
+{
+  /// \brief Constructor.
+  /// \param[in] _raw True to receive the echoed messages with a raw
+  /// subscription.
+  public: explicit EchoClient(const bool _raw)
+    : node(Options())
+  {
+    this->pub = this->node.Advertise<BenchMsgType>(kPingTopic);
+    this->valid = this->pub &&
+        subscribeCounter(this->node, kPongTopic, _raw, this->counter);
+  }
+
+  /// \brief Ping the echo process until it answers, so that discovery is
+  /// complete before measuring.
+  /// \return True if the echo process answered.
+  public: bool WaitUntilConnected()
+  {
+    if (!this->valid)
+      return false;
+
+    const auto msg = Payload(kMinMsgSize);
+    const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+      const uint64_t before = this->counter.Count();
+      this->pub.Publish(msg);
+      if (this->counter.WaitFor(before + 1, std::chrono::milliseconds(100)))
+      {
+        // Let the answers to previous pings arrive.
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// \brief Node options for the partition of the echo process.
+  /// \return The options.
+  private: static transport::NodeOptions Options()
+  {
+    transport::NodeOptions opts;
+    opts.SetPartition(AuxProcess::Echo().partition);
+    return opts;
+  }
+
+  /// \brief Node used for publishing and subscribing.
+  public: transport::Node node;
+
+  /// \brief Publisher of kPingTopic.
+  public: transport::Node::Publisher pub;
+
+  /// \brief Counts the messages received on kPongTopic.
+  public: Counter counter;
+
+  /// \brief True if advertising and subscribing succeeded.
+  private: bool valid = false;
+};
+
+//////////////////////////////////////////////////
+/// \brief Round-trip time of a message sent to another process and echoed
+/// back. range(0) is the message size and range(1) is 1 for a raw
+/// subscription and 0 for a typed one.
+static void BM_InterProcessLatency(benchmark::State &_state)
+{
+  EchoClient client(_state.range(1) != 0);
+  if (!client.WaitUntilConnected())
+  {
+    _state.SkipWithError("Unable to reach the echo process");
+    return;
+  }
+
+  const auto msg = Payload(_state.range(0));
+  uint64_t expected = client.counter.Count();
+  for (auto _ : _state)
+  {
+    client.pub.Publish(msg);
+    if (!client.counter.WaitFor(++expected))
+    {
+      _state.SkipWithError("Timeout waiting for the echo");
+      break;
+    }
+  }
+
+  setCounters(_state, 1);
+}
+BENCHMARK(BM_InterProcessLatency)
+  ->ArgNames({"size", "raw"})
+  ->ArgsProduct({benchmark::CreateRange(kMinMsgSize, kMaxMsgSize, 8), {0, 1}})
+  ->UseRealTime();
+
+//////////////////////////////////////////////////
+/// \brief Throughput of messages sent to another process and echoed back.
+/// Each iteration publishes a window of messages before waiting for the
+/// echoes, so the transport is kept busy. range(0) is the message size and
+/// range(1) is 1 for a raw subscription and 0 for a typed one.
+static void BM_InterProcessThroughput(benchmark::State &_state)
+{
+  EchoClient client(_state.range(1) != 0);
+  if (!client.WaitUntilConnected())
+  {
+    _state.SkipWithError("Unable to reach the echo process");
+    return;
+  }
+
+  const int64_t window = std::max<int64_t>(1, std::min(kMaxThroughputWindow,
+      kThroughputWindowBytes / _state.range(0)));
+
+  const auto msg = Payload(_state.range(0));
+  uint64_t expected = client.counter.Count();
+  for (auto _ : _state)
+  {
+    for (int64_t i = 0; i < window; ++i)
+      client.pub.Publish(msg);
+
+    expected += static_cast<uint64_t>(window);
+    if (!client.counter.WaitFor(expected))
+    {
+      _state.SkipWithError("Timeout waiting for the echoes");
+      break;
+    }
+  }
+
+  _state.counters["window"] = static_cast<double>(window);
+  setCounters(_state, window);
+}
+BENCHMARK(BM_InterProcessThroughput)
+  ->ArgNames({"size", "raw"})
+  ->ArgsProduct({benchmark::CreateRange(kMinMsgSize, kMaxMsgSize, 8), {0, 1}})
+  ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+/// \file services.cc
+/// \brief Service call benchmarks. Intra-process benchmarks call a service
+/// offered by this process, inter-process benchmarks call the echo service
+/// of PERFORMANCE_echo_aux.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "ignition/transport/Node.hh"
+#include "ignition/transport/NodeOptions.hh"
+#include "ignition/transport/test_config.h"
+
+#include "BenchParams.hh"
+
+using namespace ignition;
+using namespace ignition::transport::bench;
+
+/// \brief Timeout of each service request, in milliseconds.
+static const unsigned int kRequestTimeout =
+    static_cast<unsigned int>(
+      std::chrono::milliseconds(kTimeout).count());
+
+//////////////////////////////////////////////////
+/// \brief Provide a service that returns a copy of the request.
+static bool srvEcho(const BenchMsgType &_req, BenchMsgType &_rep)
+{
+  _rep = _req;
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Call a service once per iteration and check the response.
+/// \param[in] _state Benchmark state. range(0) is the request size.
+/// \param[in] _node Node used for the requests.
+/// \param[in] _service Service name.
+static void callService(benchmark::State &_state, transport::Node &_node,
+    const std::string &_service)
+{
+  const auto req = Payload(_state.range(0));
+  BenchMsgType rep;
+  bool result;
+
+  // The first request waits for discovery, so it is not measured.
+  if (!_node.Request(_service, req, kRequestTimeout, rep, result) || !result)
+  {
+    _state.SkipWithError("Unable to call the service");
+    return;
+  }
+
+  for (auto _ : _state)
+  {
+    if (!_node.Request(_service, req, kRequestTimeout, rep, result) ||
+        !result)
+    {
+      _state.SkipWithError("Service call failed");
+      break;
+    }
+  }
+
+  _state.SetItemsProcessed(_state.iterations());
+  _state.SetBytesProcessed(_state.iterations() * _state.range(0));
+}
+
+//////////////////////////////////////////////////
+/// \brief Round-trip time of a blocking service call within this process.
+static void BM_IntraProcessService(benchmark::State &_state)
+{
+  transport::NodeOptions opts;
+  opts.SetPartition(testing::getRandomNumber());
+  transport::Node node(opts);
+
+  const std::string service = "/bench/intra_echo";
+  if (!node.Advertise(service, srvEcho))
+  {
+    _state.SkipWithError("Unable to advertise the service");
+    return;
+  }
+
+  callService(_state, node, service);
+}
+BENCHMARK(BM_IntraProcessService)
+  ->ArgName("size")
+  ->RangeMultiplier(8)->Range(kMinMsgSize, kMaxMsgSize)
+  ->UseRealTime();
+
+//////////////////////////////////////////////////
+/// \brief Round-trip time of a blocking service call to another process.
+static void BM_InterProcessService(benchmark::State &_state)
+{
+  transport::NodeOptions opts;
+  opts.SetPartition(AuxProcess::Echo().partition);
+  transport::Node node(opts);
+
+  callService(_state, node, kEchoService);
+}
+BENCHMARK(BM_InterProcessService)
+  ->ArgName("size")
+  ->RangeMultiplier(8)->Range(kMinMsgSize, kMaxMsgSize)
+  ->UseRealTime();
+
+BENCHMARK_MAIN();
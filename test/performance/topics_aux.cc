@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ignition/msgs.hh>
+
+#include "ignition/transport/Node.hh"
+#include "ignition/transport/test_config.h"
+
+#include "BenchParams.hh"
+
+using namespace ignition;
+
+//////////////////////////////////////////////////
+/// \brief Advertise the number of topics given by the kNumTopicsEnv
+/// environment variable and publish on all of them every millisecond until
+/// the process is terminated.
+int main(int argc, char **argv)
+{
+  if (argc != 2)
+  {
+    std::cerr << "Partition name has not be passed as argument" << std::endl;
+    return -1;
+  }
+
+  // Set the partition name for this process.
+  setenv("IGN_PARTITION", argv[1], 1);
+
+  const char *numTopicsStr = std::getenv(transport::bench::kNumTopicsEnv);
+  const int numTopics = numTopicsStr ? std::atoi(numTopicsStr) : 1;
+  if (numTopics <= 0)
+  {
+    std::cerr << "Invalid number of topics [" << numTopicsStr << "]"
+              << std::endl;
+    return -1;
+  }
+
+  transport::Node node;
+  std::vector<transport::Node::Publisher> pubs;
+  pubs.reserve(static_cast<std::size_t>(numTopics));
+  for (int i = 0; i < numTopics; ++i)
+  {
+    const std::string topic = transport::bench::kTopicPrefix +
+        std::to_string(i);
+    pubs.push_back(node.Advertise<transport::bench::BenchMsgType>(topic));
+    if (!pubs.back())
+    {
+      std::cerr << "Error advertising " << topic << std::endl;
+      return -1;
+    }
+  }
+
+  const auto msg = transport::bench::Payload(transport::bench::kMinMsgSize);
+  while (true)
+  {
+    for (auto &pub : pubs)
+      pub.Publish(msg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  return 0;
+}